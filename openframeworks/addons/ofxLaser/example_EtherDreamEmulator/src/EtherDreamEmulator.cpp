@@ -0,0 +1,385 @@
+//
+//  EtherDreamEmulator.cpp
+//  example_EtherDreamEmulator
+//
+
+#include "EtherDreamEmulator.h"
+
+// responses as defined in the Ether Dream protocol
+#define ETHERDREAM_RESPONSE_ACK 'a'
+#define ETHERDREAM_RESPONSE_NAK_FULL 'F'
+#define ETHERDREAM_RESPONSE_NAK_INVALID 'I'
+#define ETHERDREAM_RESPONSE_NAK_ESTOP '!'
+
+#define ETHERDREAM_PLAYBACK_FLAG_UNDERFLOW 0b010
+
+#define ETHERDREAM_BROADCAST_PORT 7654
+#define ETHERDREAM_COMMAND_PORT 7765
+#define ETHERDREAM_BYTES_PER_POINT 18
+
+EtherDreamEmulator :: ~EtherDreamEmulator() {
+    close();
+}
+
+bool EtherDreamEmulator :: setup(const EtherDreamEmulatorSettings& _settings) {
+
+    settings = _settings;
+    // made up MAC address, the last bytes make the id unique per port
+    macAddress = 0x0E7D00000000ull | (uint64_t)(settings.portOffset & 0xffff);
+
+    try {
+        serverSocket.bind(Poco::Net::SocketAddress(settings.listenAddress, getPort()), true);
+        serverSocket.listen(1);
+
+        broadcastSocket.bind(Poco::Net::SocketAddress("0.0.0.0", 0), true);
+        broadcastSocket.setBroadcast(true);
+    } catch (Poco::Exception& exc) {
+        ofLogError("EtherDreamEmulator setup failed - Network error: " + exc.displayText());
+        return false;
+    }
+
+    ofLogNotice("EtherDreamEmulator") << getId() << " listening on " << settings.listenAddress << ":" << getPort();
+    startThread();
+    return true;
+}
+
+void EtherDreamEmulator :: close() {
+    if(isThreadRunning()) {
+        waitForThread(true, 2000);
+    }
+    if(clientConnected) {
+        clientSocket.close();
+        clientConnected = false;
+    }
+    serverSocket.close();
+    broadcastSocket.close();
+}
+
+string EtherDreamEmulator :: getId() {
+    char idchar[20];
+    snprintf(idchar, sizeof(idchar), "%04X%04X%04X", (int)((macAddress>>32) & 0xffff), (int)((macAddress>>16) & 0xffff), (int)(macAddress & 0xffff));
+    return "EtherDream " + string(idchar);
+}
+
+int EtherDreamEmulator :: getPort() {
+    return ETHERDREAM_COMMAND_PORT + settings.portOffset;
+}
+
+void EtherDreamEmulator :: dropConnection() {
+    dropConnectionFlag = true;
+}
+
+void EtherDreamEmulator :: getRecentPoints(vector<glm::vec2>& positions, vector<ofColor>& colours) {
+    positions.clear();
+    colours.clear();
+    if(lock()) {
+        for(EmulatedPoint& p : recentPoints) {
+            positions.emplace_back(p.x, p.y);
+            colours.emplace_back(p.r>>8, p.g>>8, p.b>>8);
+        }
+        unlock();
+    }
+}
+
+int EtherDreamEmulator :: resetMinBufferFullness() {
+    return stats.minBufferFullness.exchange(stats.bufferFullness);
+}
+
+void EtherDreamEmulator :: threadedFunction() {
+
+    Poco::Timespan pollTime(2000); // 2ms
+
+    lastPlaybackUpdateMicros = ofGetElapsedTimeMicros();
+
+    while(isThreadRunning()) {
+
+        updatePlayback();
+
+        if(ofGetElapsedTimeMicros() - lastBroadcastMicros >= 1000000) {
+            sendBroadcast();
+        }
+
+        if(!clientConnected) {
+            try {
+                if(serverSocket.poll(pollTime, Poco::Net::Socket::SELECT_READ)) {
+                    clientSocket = serverSocket.acceptConnection();
+                    clientSocket.setNoDelay(true);
+                    clientSocket.setReceiveTimeout(Poco::Timespan(1, 0));
+                    clientConnected = true;
+                    dropConnectionFlag = false;
+                    stats.connections++;
+                    ofLogNotice("EtherDreamEmulator") << getId() << " client connected from " << clientSocket.peerAddress().toString();
+                    // a real Ether Dream sends a status as soon as you connect
+                    sendResponse(ETHERDREAM_RESPONSE_ACK, '?');
+                }
+            } catch (Poco::Exception& exc) {
+                ofLogError("EtherDreamEmulator accept failed - " + exc.displayText());
+            }
+        } else {
+            bool ok = true;
+            try {
+                if(clientSocket.poll(pollTime, Poco::Net::Socket::SELECT_READ)) {
+                    ok = handleCommand();
+                }
+            } catch (Poco::Exception& exc) {
+                ofLogNotice("EtherDreamEmulator") << getId() << " connection error - " << exc.displayText();
+                ok = false;
+            }
+            if(dropConnectionFlag) {
+                ofLogNotice("EtherDreamEmulator") << getId() << " dropping connection";
+                ok = false;
+            }
+            if(!ok) {
+                clientSocket.close();
+                clientConnected = false;
+                dropConnectionFlag = false;
+                // real hardware stops playing when the connection is lost
+                stopPlayback();
+            }
+        }
+    }
+}
+
+// returns false if the connection should be closed
+bool EtherDreamEmulator :: handleCommand() {
+
+    uint8_t command;
+    if(!receiveExactly(&command, 1)) return false;
+
+    stats.commands++;
+    updatePlayback();
+
+    uint8_t args[6];
+
+    switch(command) {
+        case '?' :
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+
+        case 'p' :
+            if(lightEngineState != LIGHT_ENGINE_READY) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_ESTOP, command);
+            }
+            if(playbackState != ETHERDREAM_PLAYBACK_IDLE) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_INVALID, command);
+            }
+            playbackState = ETHERDREAM_PLAYBACK_PREPARED;
+            playbackFlags = 0;
+            pointCount = 0;
+            pointBuffer.clear();
+            queuedPointRates.clear();
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+
+        case 'b' : {
+            // uint16 low water mark (unused), uint32 point rate
+            if(!receiveExactly(args, 6)) return false;
+            uint32_t rate = ByteStreamUtils::bytesToUInt32(&args[2]);
+            if((playbackState != ETHERDREAM_PLAYBACK_PREPARED) || (rate == 0) || ((int)rate > settings.maxPointRate)) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_INVALID, command);
+            }
+            pointRate = rate;
+            playbackState = ETHERDREAM_PLAYBACK_PLAYING;
+            lastPlaybackUpdateMicros = ofGetElapsedTimeMicros();
+            pointsToConsumeRemainder = 0;
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+        }
+
+        case 'q' : {
+            if(!receiveExactly(args, 4)) return false;
+            uint32_t rate = ByteStreamUtils::bytesToUInt32(args);
+            if((playbackState == ETHERDREAM_PLAYBACK_IDLE) || (rate == 0) || ((int)rate > settings.maxPointRate)) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_INVALID, command);
+            }
+            queuedPointRates.push_back(rate);
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+        }
+
+        case 'd' : {
+            if(!receiveExactly(args, 2)) return false;
+            int numpoints = ByteStreamUtils::bytesToUInt16(args);
+            size_t numbytes = (size_t)numpoints * ETHERDREAM_BYTES_PER_POINT;
+            if(receiveBuffer.size() < numbytes) receiveBuffer.resize(numbytes);
+            // always read the data, even if we reject it, to keep the stream in sync
+            if(!receiveExactly(receiveBuffer.data(), (int)numbytes)) return false;
+
+            stats.dataCommands++;
+            stats.bytesReceived += numbytes + 3;
+
+            if(playbackState == ETHERDREAM_PLAYBACK_IDLE) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_INVALID, command);
+            }
+            if((int)pointBuffer.size() + numpoints > settings.bufferCapacity) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_FULL, command);
+            }
+            for(int i = 0; i<numpoints; i++) {
+                unsigned char* p = &receiveBuffer[i*ETHERDREAM_BYTES_PER_POINT];
+                EmulatedPoint point;
+                point.control = ByteStreamUtils::bytesToUInt16(p);
+                point.x = (int16_t)ByteStreamUtils::bytesToUInt16(p+2);
+                point.y = (int16_t)ByteStreamUtils::bytesToUInt16(p+4);
+                point.r = ByteStreamUtils::bytesToUInt16(p+6);
+                point.g = ByteStreamUtils::bytesToUInt16(p+8);
+                point.b = ByteStreamUtils::bytesToUInt16(p+10);
+                pointBuffer.push_back(point);
+            }
+            stats.pointsReceived += numpoints;
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+        }
+
+        case 's' :
+            if(playbackState == ETHERDREAM_PLAYBACK_IDLE) {
+                return sendResponse(ETHERDREAM_RESPONSE_NAK_INVALID, command);
+            }
+            stopPlayback();
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+
+        case 0x00 :
+        case 0xff :
+            stopPlayback();
+            lightEngineState = LIGHT_ENGINE_ESTOP;
+            lightEngineFlags |= 0b00001;
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+
+        case 'c' :
+            lightEngineState = LIGHT_ENGINE_READY;
+            lightEngineFlags = 0;
+            return sendResponse(ETHERDREAM_RESPONSE_ACK, command);
+
+        default :
+            // unknown commands put a real Ether Dream into e-stop
+            ofLogNotice("EtherDreamEmulator") << getId() << " unknown command " << (int)command;
+            stopPlayback();
+            lightEngineState = LIGHT_ENGINE_ESTOP;
+            lightEngineFlags |= 0b00001;
+            return sendResponse(ETHERDREAM_RESPONSE_NAK_INVALID, command);
+    }
+}
+
+void EtherDreamEmulator :: updatePlayback() {
+
+    uint64_t now = ofGetElapsedTimeMicros();
+    uint64_t elapsedMicros = now - lastPlaybackUpdateMicros;
+    lastPlaybackUpdateMicros = now;
+
+    if(playbackState == ETHERDREAM_PLAYBACK_PLAYING) {
+
+        // the emulated crystal runs at (1 + skew) x the host clock
+        double dacMicros = (double)elapsedMicros * (1.0 + settings.clockSkewPPM * 0.000001);
+        double pointsToConsume = (dacMicros * pointRate / 1000000.0) + pointsToConsumeRemainder;
+        int numpoints = (int)pointsToConsume;
+        pointsToConsumeRemainder = pointsToConsume - numpoints;
+
+        if(numpoints > 0) {
+            lock();
+            int played = 0;
+            while((played<numpoints) && (pointBuffer.size()>0)) {
+                EmulatedPoint& point = pointBuffer.front();
+                // bit 15 tells the DAC to apply the next queued rate
+                if((point.control & 0x8000) && (queuedPointRates.size()>0)) {
+                    pointRate = queuedPointRates.front();
+                    queuedPointRates.pop_front();
+                }
+                recentPoints.push_back(point);
+                pointBuffer.pop_front();
+                played++;
+            }
+            while(recentPoints.size()>maxRecentPoints) recentPoints.pop_front();
+            unlock();
+
+            pointCount += played;
+            stats.pointsPlayed += played;
+
+            if(played<numpoints) {
+                // ran out of points, so the DAC stops and flags an underflow
+                playbackState = ETHERDREAM_PLAYBACK_IDLE;
+                playbackFlags |= ETHERDREAM_PLAYBACK_FLAG_UNDERFLOW;
+                pointsToConsumeRemainder = 0;
+                stats.underflows++;
+            }
+        }
+    }
+
+    int fullness = (int)pointBuffer.size();
+    stats.bufferFullness = fullness;
+    if(fullness < stats.minBufferFullness) stats.minBufferFullness = fullness;
+    stats.playbackState = playbackState;
+    stats.pointRate = pointRate;
+}
+
+void EtherDreamEmulator :: stopPlayback() {
+    playbackState = ETHERDREAM_PLAYBACK_IDLE;
+    pointBuffer.clear();
+    queuedPointRates.clear();
+    pointsToConsumeRemainder = 0;
+}
+
+bool EtherDreamEmulator :: sendResponse(char response, char command) {
+
+    if(response != ETHERDREAM_RESPONSE_ACK) stats.naks++;
+
+    if(settings.responseDelayMicros>0) {
+        uint64_t waituntil = ofGetElapsedTimeMicros() + settings.responseDelayMicros;
+        while(ofGetElapsedTimeMicros() < waituntil) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        updatePlayback();
+    }
+
+    responseBuffer.clear();
+    responseBuffer.appendChar(response);
+    responseBuffer.appendChar(command);
+    serialiseStatus(responseBuffer);
+
+    int sent = clientSocket.sendBytes(responseBuffer.getBuffer(), (int)responseBuffer.size());
+    return sent == (int)responseBuffer.size();
+}
+
+void EtherDreamEmulator :: serialiseStatus(ByteBuffer& buffer) {
+    uint32_t rate = pointRate;
+    uint32_t count = pointCount;
+    buffer.appendUInt8(0); // protocol
+    buffer.appendUInt8(lightEngineState);
+    buffer.appendUInt8(playbackState);
+    buffer.appendUInt8(0); // source - network stream
+    buffer.appendUInt16(lightEngineFlags);
+    buffer.appendUInt16(playbackFlags);
+    buffer.appendUInt16(0); // source flags
+    buffer.appendUInt16((uint16_t)pointBuffer.size());
+    buffer.appendUInt32(rate);
+    buffer.appendUInt32(count);
+}
+
+void EtherDreamEmulator :: sendBroadcast() {
+
+    lastBroadcastMicros = ofGetElapsedTimeMicros();
+
+    uint32_t maxrate = settings.maxPointRate;
+
+    broadcastBuffer.clear();
+    // MAC address, most significant byte first
+    for(int i = 5; i>=0; i--) {
+        broadcastBuffer.appendUInt8((macAddress >> (i*8)) & 0xff);
+    }
+    broadcastBuffer.appendUInt16(0); // hardware revision 0 is a virtual Ether Dream
+    broadcastBuffer.appendUInt16(settings.portOffset); // software revision is the port offset
+    broadcastBuffer.appendUInt16(settings.bufferCapacity);
+    broadcastBuffer.appendUInt32(maxrate);
+    serialiseStatus(broadcastBuffer);
+
+    try {
+        Poco::Net::SocketAddress address(settings.broadcastAddress, ETHERDREAM_BROADCAST_PORT);
+        broadcastSocket.sendTo(broadcastBuffer.getBuffer(), (int)broadcastBuffer.size(), address);
+    } catch (Poco::Exception& exc) {
+        ofLogError("EtherDreamEmulator broadcast failed - " + exc.displayText());
+    }
+}
+
+bool EtherDreamEmulator :: receiveExactly(uint8_t* buffer, int length) {
+    int received = 0;
+    while(received<length) {
+        int n = clientSocket.receiveBytes(buffer+received, length-received);
+        // zero bytes means the other end closed the socket
+        if(n<=0) return false;
+        received+=n;
+    }
+    return true;
+}
@@ -0,0 +1,138 @@
+//
+//  EtherDreamEmulator.h
+//  example_EtherDreamEmulator
+//
+// A software Ether Dream that runs on loopback (or any local interface).
+// It sends the discovery broadcast on UDP 7654 once a second and
+// implements the TCP command protocol that ofxLaser::DacEtherDream
+// speaks (ping, prepare, begin, point rate, data, stop, e-stop, clear).
+//
+// The point buffer drains in real time at the current point rate, so
+// the ack'd buffer fullness, underflows and NAKs behave like a real
+// unit. The emulated crystal can run fast or slow (clockSkewPPM) and
+// every response can be delayed (responseDelayMicros) to test how the
+// DAC thread copes with drift and slow networks.
+//
+// It identifies itself as a "virtual" Ether Dream (hardware revision 0)
+// so DacEtherDream connects to port 7765 + portOffset, which means you
+// can run several emulators on one machine.
+
+#pragma once
+#include "ofMain.h"
+#include "ByteBuffer.h"
+#include "ByteStreamUtils.h"
+#include "ofxLaserDacEtherDreamResponse.h"
+
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+
+struct EtherDreamEmulatorSettings {
+    // TCP port is 7765 + portOffset, the offset is sent as the
+    // software revision in the broadcast
+    int portOffset = 0;
+    // where to send the discovery packets, use 255.255.255.255
+    // to make the emulator visible on the local network
+    string broadcastAddress = "127.0.0.1";
+    string listenAddress = "127.0.0.1";
+    int bufferCapacity = 1799;
+    int maxPointRate = 100000;
+    // how much faster (+) or slower (-) the emulated DAC clock runs
+    float clockSkewPPM = 0;
+    // added before every response is sent
+    int responseDelayMicros = 0;
+};
+
+// counters are written by the emulator thread and read by the app
+struct EtherDreamEmulatorStats {
+    std::atomic<uint32_t> connections{0};
+    std::atomic<uint32_t> commands{0};
+    std::atomic<uint32_t> dataCommands{0};
+    std::atomic<uint32_t> naks{0};
+    std::atomic<uint32_t> underflows{0};
+    std::atomic<uint64_t> pointsReceived{0};
+    std::atomic<uint64_t> bytesReceived{0};
+    std::atomic<uint64_t> pointsPlayed{0};
+    std::atomic<int> bufferFullness{0};
+    std::atomic<int> minBufferFullness{0};
+    std::atomic<int> playbackState{0};
+    std::atomic<uint32_t> pointRate{0};
+};
+
+class EtherDreamEmulator : public ofThread {
+
+    public :
+
+    ~EtherDreamEmulator();
+
+    bool setup(const EtherDreamEmulatorSettings& settings);
+    void close();
+
+    string getId();
+    int getPort();
+
+    // drops the current client connection, the DAC thread has to reconnect
+    void dropConnection();
+
+    // copies the most recently played points (in DAC coordinates)
+    void getRecentPoints(vector<glm::vec2>& positions, vector<ofColor>& colours);
+    // returns the lowest buffer fullness since the last call
+    int resetMinBufferFullness();
+
+    EtherDreamEmulatorStats stats;
+
+    protected :
+
+    struct EmulatedPoint {
+        uint16_t control;
+        int16_t x, y;
+        uint16_t r, g, b;
+    };
+
+    void threadedFunction() override;
+
+    void sendBroadcast();
+    void serialiseStatus(ByteBuffer& buffer);
+
+    bool handleCommand();
+    bool sendResponse(char response, char command);
+    bool receiveExactly(uint8_t* buffer, int length);
+
+    // consumes points from the buffer at the current point rate
+    void updatePlayback();
+    void stopPlayback();
+
+    EtherDreamEmulatorSettings settings;
+    uint64_t macAddress = 0;
+
+    Poco::Net::ServerSocket serverSocket;
+    Poco::Net::StreamSocket clientSocket;
+    Poco::Net::DatagramSocket broadcastSocket;
+    bool clientConnected = false;
+    std::atomic<bool> dropConnectionFlag{false};
+
+    ByteBuffer responseBuffer;
+    ByteBuffer broadcastBuffer;
+    vector<uint8_t> receiveBuffer;
+
+    // DAC state, only touched by the emulator thread
+    uint8_t lightEngineState = LIGHT_ENGINE_READY;
+    uint8_t playbackState = ETHERDREAM_PLAYBACK_IDLE;
+    uint16_t lightEngineFlags = 0;
+    uint16_t playbackFlags = 0;
+    uint32_t pointRate = 0;
+    uint32_t pointCount = 0;
+    deque<EmulatedPoint> pointBuffer;
+    deque<uint32_t> queuedPointRates;
+
+    uint64_t lastPlaybackUpdateMicros = 0;
+    double pointsToConsumeRemainder = 0;
+    uint64_t lastBroadcastMicros = 0;
+
+    // the last points that were "played", for display
+    deque<EmulatedPoint> recentPoints;
+    const size_t maxRecentPoints = 4000;
+
+};
@@ -0,0 +1,109 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	
+	ofSetFrameRate(60);
+	ofBackground(0);
+	
+	addEmulator();
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+	
+	if(reconnectStorm && (ofGetElapsedTimef() - lastReconnectTime > reconnectInterval)) {
+		lastReconnectTime = ofGetElapsedTimef();
+		for(EtherDreamEmulator* emulator : emulators) emulator->dropConnection();
+	}
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+	
+	float previewSize = 200;
+	float x = 20;
+	float y = 20;
+	
+	for(EtherDreamEmulator* emulator : emulators) {
+		
+		EtherDreamEmulatorStats& stats = emulator->stats;
+		string playstate = stats.playbackState == ETHERDREAM_PLAYBACK_PLAYING ? "PLAYING" : stats.playbackState == ETHERDREAM_PLAYBACK_PREPARED ? "PREPARED" : "IDLE";
+		
+		string info;
+		info += emulator->getId() + " port " + ofToString(emulator->getPort()) + "\n";
+		info += "State       : " + playstate + " @ " + ofToString(stats.pointRate.load()) + " pps\n";
+		info += "Buffer      : " + ofToString(stats.bufferFullness.load()) + " (min " + ofToString(emulator->resetMinBufferFullness()) + ")\n";
+		info += "Connections : " + ofToString(stats.connections.load()) + "\n";
+		info += "Commands    : " + ofToString(stats.commands.load()) + " (data " + ofToString(stats.dataCommands.load()) + ")\n";
+		info += "NAKs        : " + ofToString(stats.naks.load()) + "\n";
+		info += "Underflows  : " + ofToString(stats.underflows.load()) + "\n";
+		info += "Points      : " + ofToString(stats.pointsReceived.load()) + " received, " + ofToString(stats.pointsPlayed.load()) + " played\n";
+		ofDrawBitmapString(info, x + previewSize + 20, y + 12);
+		
+		// draw the points that were most recently played
+		emulator->getRecentPoints(previewPositions, previewColours);
+		previewMesh.clear();
+		previewMesh.setMode(OF_PRIMITIVE_LINE_STRIP);
+		for(size_t i = 0; i<previewPositions.size(); i++) {
+			glm::vec2& p = previewPositions[i];
+			previewMesh.addVertex(glm::vec3(ofMap(p.x, -32768, 32767, x, x+previewSize), ofMap(p.y, 32767, -32768, y, y+previewSize), 0));
+			previewMesh.addColor(previewColours[i]);
+		}
+		ofNoFill();
+		ofSetColor(80);
+		ofDrawRectangle(x, y, previewSize, previewSize);
+		ofSetColor(255);
+		previewMesh.draw();
+		
+		y += previewSize + 20;
+	}
+	
+	string help = "+ : add emulator   k : drop connections   r : reconnect storm (" + string(reconnectStorm ? "ON" : "OFF") + ")\n";
+	help += "[ ] : clock skew " + ofToString(settings.clockSkewPPM) + " ppm   - = : response delay " + ofToString(settings.responseDelayMicros) + " us (applies to new emulators)";
+	ofDrawBitmapString(help, 20, ofGetHeight() - 30);
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::exit(){
+	for(EtherDreamEmulator* emulator : emulators) {
+		emulator->close();
+		delete emulator;
+	}
+	emulators.clear();
+}
+
+//--------------------------------------------------------------
+void ofApp::addEmulator(){
+	settings.portOffset = (int)emulators.size();
+	EtherDreamEmulator* emulator = new EtherDreamEmulator();
+	if(emulator->setup(settings)) {
+		emulators.push_back(emulator);
+	} else {
+		delete emulator;
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+	
+	if(key == '+') {
+		addEmulator();
+	} else if(key == 'k') {
+		for(EtherDreamEmulator* emulator : emulators) emulator->dropConnection();
+	} else if(key == 'r') {
+		reconnectStorm = !reconnectStorm;
+	} else if(key == '[') {
+		settings.clockSkewPPM -= 100;
+	} else if(key == ']') {
+		settings.clockSkewPPM += 100;
+	} else if(key == '-') {
+		settings.responseDelayMicros = MAX(0, settings.responseDelayMicros - 500);
+	} else if(key == '=') {
+		settings.responseDelayMicros += 500;
+	}
+	
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ofMain.h"
+#include "EtherDreamEmulator.h"
+
+class ofApp : public ofBaseApp{
+	
+public:
+	void setup() override;
+	void update() override;
+	void draw() override;
+	void exit() override;
+	
+	void keyPressed(int key) override;
+	
+	void addEmulator();
+	
+	vector<EtherDreamEmulator*> emulators;
+	
+	// applied to emulators as they are added
+	EtherDreamEmulatorSettings settings;
+	
+	// drops every connection on a timer to test reconnection
+	bool reconnectStorm = false;
+	float reconnectInterval = 2;
+	float lastReconnectTime = 0;
+	
+	vector<glm::vec2> previewPositions;
+	vector<ofColor> previewColours;
+	ofMesh previewMesh;
+	
+};
@@ -0,0 +1,402 @@
+//
+//  IDNReceiver.cpp
+//  example_IDNReceiver
+//
+
+#include "IDNReceiver.h"
+
+using namespace ofxLaser;
+
+#define IDN_DRIFT_WINDOW_MICROS 5000000
+
+IDNReceiver :: ~IDNReceiver() {
+    close();
+}
+
+bool IDNReceiver :: setup(const IDNReceiverSettings& _settings) {
+
+    settings = _settings;
+    // made up MAC address
+    uint8_t madeUpId[6] = {0x0E, 0x7D, 0x1D, 0x00, 0x00, 0x01};
+    memcpy(unitId, madeUpId, sizeof(unitId));
+
+    receiveBuffer.resize(DacIDNConsts::MAX_DATAGRAM_SIZE + 64);
+    sendBuffer.resize(128);
+
+    try {
+        socket.bind(Poco::Net::SocketAddress(settings.listenAddress, DacIDNConsts::PORT), true);
+        socket.setReceiveBufferSize(1<<20);
+    } catch (Poco::Exception& exc) {
+        ofLogError("IDNReceiver setup failed - Network error: " + exc.displayText());
+        return false;
+    }
+
+    ofLogNotice("IDNReceiver") << getUnitId() << " listening on " << settings.listenAddress << ":" << DacIDNConsts::PORT;
+    startThread();
+    return true;
+}
+
+void IDNReceiver :: close() {
+    if(isThreadRunning()) {
+        waitForThread(true, 2000);
+    }
+    socket.close();
+}
+
+string IDNReceiver :: getUnitId() {
+    // the same as DacManagerIDN makes from the scan response,
+    // category byte first
+    char idchar[20];
+    snprintf(idchar, sizeof(idchar), "01%02X%02X%02X%02X%02X%02X", unitId[0], unitId[1], unitId[2], unitId[3], unitId[4], unitId[5]);
+    return string(idchar);
+}
+
+void IDNReceiver :: getRecentPoints(vector<glm::vec2>& positions, vector<ofColor>& colours) {
+    positions.clear();
+    colours.clear();
+    if(lock()) {
+        for(ReceivedPoint& p : recentPoints) {
+            positions.emplace_back(p.x, p.y);
+            colours.emplace_back(p.r, p.g, p.b);
+        }
+        unlock();
+    }
+}
+
+int IDNReceiver :: resetMinLead() {
+    return stats.minLeadMicros.exchange(stats.leadMicros);
+}
+
+void IDNReceiver :: threadedFunction() {
+
+    Poco::Timespan pollTime(10000); // 10ms
+
+    while(isThreadRunning()) {
+        try {
+            if(!socket.poll(pollTime, Poco::Net::Socket::SELECT_READ)) continue;
+
+            Poco::Net::SocketAddress sender;
+            int numBytes = socket.receiveFrom(receiveBuffer.data(), (int)receiveBuffer.size(), sender);
+            if(numBytes>0) {
+                processDatagram(receiveBuffer.data(), numBytes, sender);
+            }
+        } catch (Poco::Exception& exc) {
+            ofLogError("IDNReceiver receive failed - " + exc.displayText());
+            sleep(100);
+        }
+    }
+}
+
+void IDNReceiver :: processDatagram(uint8_t* data, int length, Poco::Net::SocketAddress& sender) {
+
+    stats.datagrams++;
+    stats.bytes+=length;
+
+    if(length<DacIDNConsts::PACKET_HEADER_SIZE) {
+        stats.malformed++;
+        return;
+    }
+
+    uint8_t command = data[0];
+    uint16_t sequence = readUInt16(data+2);
+
+    switch(command) {
+
+        case DacIDNConsts::CMD_SCAN_REQUEST :
+            stats.scanRequests++;
+            sendScanResponse(sequence, sender);
+            break;
+
+        case DacIDNConsts::CMD_PING_REQUEST :
+            sendPingResponse(data, length, sender);
+            break;
+
+        case DacIDNConsts::CMD_RT_CNLMSG :
+        case DacIDNConsts::CMD_RT_CNLMSG_ACKREQ : {
+            // check the sequence number for lost or reordered datagrams
+            if(sequenceValid) {
+                uint16_t gap = sequence - (uint16_t)(lastSequence + 1);
+                if(gap!=0) {
+                    if(gap<0x8000) stats.lostDatagrams+=gap;
+                    else {
+                        // arrived after a later one, don't go backwards
+                        stats.outOfOrderDatagrams++;
+                        break;
+                    }
+                }
+            }
+            lastSequence = sequence;
+            sequenceValid = true;
+            processChannelMessage(data + DacIDNConsts::PACKET_HEADER_SIZE, length - DacIDNConsts::PACKET_HEADER_SIZE);
+            break;
+        }
+
+        case DacIDNConsts::CMD_RT_CNLMSG_CLOSE :
+            stats.closes++;
+            resetStream();
+            sequenceValid = false;
+            break;
+
+        default :
+            break;
+    }
+}
+
+void IDNReceiver :: processChannelMessage(uint8_t* data, int length) {
+
+    if(length<DacIDNConsts::CHANNEL_MSG_HEADER_SIZE) {
+        stats.malformed++;
+        return;
+    }
+    uint16_t totalSize = readUInt16(data);
+    uint16_t contentId = readUInt16(data+2);
+    uint32_t timestamp = ((uint32_t)readUInt16(data+4)<<16) | readUInt16(data+6);
+
+    if((totalSize>length) || (totalSize<DacIDNConsts::CHANNEL_MSG_HEADER_SIZE) || !(contentId & DacIDNConsts::CONTENT_ID_CHANNEL_MSG)) {
+        stats.malformed++;
+        return;
+    }
+    stats.channelMessages++;
+
+    uint8_t* end = data + totalSize;
+    data+=DacIDNConsts::CHANNEL_MSG_HEADER_SIZE;
+
+    uint8_t chunkType = contentId & DacIDNConsts::CONTENT_ID_CHUNK_TYPE_MASK;
+    bool configOrLastFragment = contentId & DacIDNConsts::CONTENT_ID_CONFIG_LSTFRG;
+
+    if(chunkType == DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME_SEQUEL) {
+        // no config or chunk header, just more points
+        if(!frameInProgress) return;
+        processSamples(data, end, true);
+        if(configOrLastFragment) {
+            frameInProgress = false;
+            processSamples(nullptr, nullptr, true);
+        }
+        return;
+    }
+
+    if(configOrLastFragment) {
+        if(!processConfig(data, end)) {
+            stats.malformed++;
+            return;
+        }
+    }
+    // can't decode anything until we know what the samples look like
+    if(!configValid) return;
+    if(chunkType==0) return; // empty message
+
+    if(end - data < DacIDNConsts::CHUNK_HEADER_SIZE) {
+        stats.malformed++;
+        return;
+    }
+    uint32_t duration = ((uint32_t)data[1]<<16) | ((uint32_t)data[2]<<8) | data[3];
+    data+=DacIDNConsts::CHUNK_HEADER_SIZE;
+
+    if(chunkType == DacIDNConsts::CHUNK_TYPE_LPGRF_WAVE) {
+        int numPoints = (int)(end - data) / sampleSize;
+        if((numPoints>0) && (duration>0)) stats.pointRate = (int)((uint64_t)numPoints * 1000000ull / duration);
+        updateTiming(timestamp, duration, false);
+        processSamples(data, end, false);
+
+    } else if((chunkType == DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME) || (chunkType == DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME_FIRST)) {
+        framePoints.clear();
+        frameInProgress = true;
+        frameDuration = duration;
+        frameTimestamp = timestamp;
+        updateTiming(timestamp, duration, true);
+        processSamples(data, end, true);
+        if(chunkType == DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME) {
+            frameInProgress = false;
+            processSamples(nullptr, nullptr, true);
+        }
+    }
+}
+
+bool IDNReceiver :: processConfig(uint8_t*& data, uint8_t* end) {
+
+    if(end - data < DacIDNConsts::CONFIG_HEADER_SIZE) return false;
+    int wordCount = data[0];
+    uint8_t flags = data[1];
+    serviceMode = data[3];
+    data+=DacIDNConsts::CONFIG_HEADER_SIZE;
+    if(end - data < wordCount*4) return false;
+
+    stats.configs++;
+    stats.serviceMode = serviceMode;
+
+    if(flags & DacIDNConsts::CONFIG_FLAG_CLOSE) {
+        resetStream();
+    }
+
+    // each descriptor is 16 bits. 0x4010 makes the previous one
+    // 16 bit, other 0x40xx are modifiers and 0x0000 is padding,
+    // everything else is one byte in the sample
+    int size = 0;
+    for(int i = 0; i<wordCount*2; i++) {
+        uint16_t descriptor = readUInt16(data + i*2);
+        if(descriptor==0x0000) continue;
+        else if(descriptor==0x4010) size++;
+        else if((descriptor & 0xFF00)==0x4000) continue;
+        else size++;
+    }
+    data+=wordCount*4;
+
+    // we decode XXYYRGB, anything smaller we can't handle
+    configValid = (size>=DacIDNConsts::BYTES_PER_POINT);
+    if(configValid) sampleSize = size;
+    return true;
+}
+
+void IDNReceiver :: processSamples(uint8_t* data, uint8_t* end, bool frame) {
+
+    // called with nullptr when a frame is complete
+    if(data==nullptr) {
+        stats.frames++;
+        if(frameDuration>0) stats.pointRate = (int)((uint64_t)framePoints.size() * 1000000ull / frameDuration);
+        if(lock()) {
+            recentPoints.assign(framePoints.begin(), framePoints.end());
+            unlock();
+        }
+        return;
+    }
+
+    int numPoints = (int)(end - data) / sampleSize;
+    stats.points+=numPoints;
+
+    ReceivedPoint p;
+    if(frame) {
+        for(int i = 0; i<numPoints; i++, data+=sampleSize) {
+            p.x = (int16_t)readUInt16(data);
+            p.y = (int16_t)readUInt16(data+2);
+            p.r = data[4];
+            p.g = data[5];
+            p.b = data[6];
+            framePoints.push_back(p);
+        }
+    } else if(lock()) {
+        for(int i = 0; i<numPoints; i++, data+=sampleSize) {
+            p.x = (int16_t)readUInt16(data);
+            p.y = (int16_t)readUInt16(data+2);
+            p.r = data[4];
+            p.g = data[5];
+            p.b = data[6];
+            recentPoints.push_back(p);
+        }
+        while(recentPoints.size()>maxRecentPoints) recentPoints.pop_front();
+        unlock();
+    }
+}
+
+void IDNReceiver :: updateTiming(uint32_t timestamp, uint32_t durationMicros, bool frame) {
+
+    int64_t now = ofGetElapsedTimeMicros();
+
+    if(timingValid) {
+        extendedTimestamp += (int32_t)(timestamp - lastTimestamp);
+    } else {
+        extendedTimestamp = timestamp;
+    }
+    lastTimestamp = timestamp;
+
+    int64_t transit = now - extendedTimestamp;
+
+    if(timingValid) {
+        int64_t d = transit - lastTransit;
+        // a big jump means the sender has restarted its timestamps
+        if(abs(d) > 1000000) {
+            timingValid = false;
+        } else {
+            jitter += ((float)abs(d) - jitter)/16.0f;
+            stats.jitterMicros = jitter;
+        }
+    }
+    if(!timingValid) {
+        // the first chunk plays as soon as it arrives
+        clockOffset = transit;
+        playEndTime = now;
+        driftWindowStart = now;
+        windowMinTransit = transit;
+        lastWindowValid = false;
+        timingValid = true;
+    }
+    lastTransit = transit;
+
+    // drift, how much the lowest transit time moves from window to window
+    windowMinTransit = MIN(windowMinTransit, transit);
+    if(now - driftWindowStart > IDN_DRIFT_WINDOW_MICROS) {
+        if(lastWindowValid) {
+            stats.driftPPM = (float)(windowMinTransit - lastWindowMinTransit) * 1000000.0f / (float)(now - driftWindowStart);
+        }
+        lastWindowMinTransit = windowMinTransit;
+        lastWindowValid = true;
+        windowMinTransit = transit;
+        driftWindowStart = now;
+    }
+
+    // frames repeat so they can't underrun
+    if(frame) return;
+
+    int64_t chunkStart = extendedTimestamp + clockOffset;
+    if(chunkStart < now) {
+        // should have started playing already, so we've run dry.
+        // Start again from now like a real receiver would.
+        stats.underruns++;
+        clockOffset += now - chunkStart;
+        chunkStart = now;
+    }
+    playEndTime = chunkStart + durationMicros;
+
+    int lead = (int)(playEndTime - now);
+    stats.leadMicros = lead;
+    if(lead < stats.minLeadMicros) stats.minLeadMicros = lead;
+    if(lead > settings.bufferMillis*1000) stats.overflows++;
+}
+
+void IDNReceiver :: resetStream() {
+    timingValid = false;
+    configValid = false;
+    frameInProgress = false;
+    framePoints.clear();
+}
+
+void IDNReceiver :: sendScanResponse(uint16_t sequence, Poco::Net::SocketAddress& sender) {
+
+    uint8_t* b = sendBuffer.data();
+    memset(b, 0, DacIDNConsts::PACKET_HEADER_SIZE + DacIDNConsts::SCAN_RESPONSE_SIZE);
+
+    b[0] = DacIDNConsts::CMD_SCAN_RESPONSE;
+    b[2] = sequence>>8;
+    b[3] = sequence&0xff;
+
+    uint8_t* response = b + DacIDNConsts::PACKET_HEADER_SIZE;
+    response[0] = DacIDNConsts::SCAN_RESPONSE_SIZE;
+    response[1] = 0x10; // protocol version 1.0
+    response[2] = 0x01; // status, realtime streaming available
+
+    // unit ID length, category (1 = MAC address), then the ID
+    uint8_t* id = response + 4;
+    id[0] = 7;
+    id[1] = 0x01;
+    memcpy(id + 2, unitId, sizeof(unitId));
+
+    char* hostName = (char*)(response + 4 + DacIDNConsts::UNIT_ID_LENGTH);
+    strncpy(hostName, settings.hostName.c_str(), DacIDNConsts::HOST_NAME_LENGTH);
+
+    try {
+        socket.sendTo(b, DacIDNConsts::PACKET_HEADER_SIZE + DacIDNConsts::SCAN_RESPONSE_SIZE, sender);
+    } catch (Poco::Exception& exc) {
+        ofLogError("IDNReceiver scan response failed - " + exc.displayText());
+    }
+}
+
+void IDNReceiver :: sendPingResponse(uint8_t* data, int length, Poco::Net::SocketAddress& sender) {
+    // echoes the payload back
+    length = MIN(length, (int)sendBuffer.size());
+    memcpy(sendBuffer.data(), data, length);
+    sendBuffer[0] = DacIDNConsts::CMD_PING_RESPONSE;
+    try {
+        socket.sendTo(sendBuffer.data(), length, sender);
+    } catch (Poco::Exception& exc) {
+        ofLogError("IDNReceiver ping response failed - " + exc.displayText());
+    }
+}
@@ -0,0 +1,143 @@
+//
+//  IDNReceiver.h
+//  example_IDNReceiver
+//
+// A software IDN device for testing ofxLaser::DacIDN without any
+// hardware. It answers IDN-Hello scan requests so it shows up in the
+// DAC list, then decodes the IDN-Stream channel messages that it
+// receives (wave and frame modes).
+//
+// It measures what matters for streaming : throughput, lost and out of
+// order datagrams (from the sequence numbers), inter-arrival jitter and
+// the drift between the sender's timestamps and our own clock. It also
+// plays the chunks out against their timestamps so you can see how far
+// ahead the sender is running (the lead) and count the underruns.
+
+#pragma once
+#include "ofMain.h"
+#include "ofxLaserDacIDNConsts.h"
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+
+struct IDNReceiverSettings {
+    // use 0.0.0.0 to make the receiver visible on the local network
+    string listenAddress = "127.0.0.1";
+    string hostName = "ofxLaser IDN test";
+    // the receiver's buffer, chunks further ahead than this are counted
+    // as overflows
+    int bufferMillis = 200;
+};
+
+// counters are written by the receiver thread and read by the app
+struct IDNReceiverStats {
+    std::atomic<uint32_t> datagrams{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint32_t> scanRequests{0};
+    std::atomic<uint32_t> channelMessages{0};
+    std::atomic<uint32_t> configs{0};
+    std::atomic<uint32_t> closes{0};
+    std::atomic<uint32_t> lostDatagrams{0};
+    std::atomic<uint32_t> outOfOrderDatagrams{0};
+    std::atomic<uint32_t> malformed{0};
+    std::atomic<uint32_t> frames{0};
+    std::atomic<uint64_t> points{0};
+    std::atomic<uint32_t> underruns{0};
+    std::atomic<uint32_t> overflows{0};
+    std::atomic<int> serviceMode{0};
+    std::atomic<int> pointRate{0};
+    // RFC 3550 style jitter of the timestamps against arrival times
+    std::atomic<float> jitterMicros{0};
+    // how far ahead of its play time the last chunk arrived
+    std::atomic<int> leadMicros{0};
+    std::atomic<int> minLeadMicros{0};
+    // sender clock vs our clock
+    std::atomic<float> driftPPM{0};
+};
+
+class IDNReceiver : public ofThread {
+
+    public :
+
+    ~IDNReceiver();
+
+    bool setup(const IDNReceiverSettings& settings);
+    void close();
+
+    string getUnitId();
+
+    // copies the most recently received points (in IDN coordinates)
+    void getRecentPoints(vector<glm::vec2>& positions, vector<ofColor>& colours);
+    // returns the lowest lead since the last call
+    int resetMinLead();
+
+    IDNReceiverStats stats;
+
+    protected :
+
+    struct ReceivedPoint {
+        int16_t x, y;
+        uint8_t r, g, b;
+    };
+
+    void threadedFunction() override;
+
+    void processDatagram(uint8_t* data, int length, Poco::Net::SocketAddress& sender);
+    void processChannelMessage(uint8_t* data, int length);
+    // reads the channel config and works out the sample size
+    bool processConfig(uint8_t*& data, uint8_t* end);
+    void processSamples(uint8_t* data, uint8_t* end, bool frame);
+    // plays a chunk out against its timestamp and updates the timing stats
+    void updateTiming(uint32_t timestamp, uint32_t durationMicros, bool frame);
+    void resetStream();
+
+    void sendScanResponse(uint16_t sequence, Poco::Net::SocketAddress& sender);
+    void sendPingResponse(uint8_t* data, int length, Poco::Net::SocketAddress& sender);
+
+    static uint16_t readUInt16(uint8_t* data) {
+        return (data[0]<<8) | data[1];
+    }
+
+    IDNReceiverSettings settings;
+    uint8_t unitId[6];
+
+    Poco::Net::DatagramSocket socket;
+    vector<uint8_t> receiveBuffer;
+    vector<uint8_t> sendBuffer;
+
+    // stream state, only touched by the receiver thread
+    bool sequenceValid = false;
+    uint16_t lastSequence = 0;
+    bool configValid = false;
+    int sampleSize = 0;
+    uint8_t serviceMode = 0;
+
+    bool timingValid = false;
+    // the 32 bit timestamps unwrapped into 64 bits
+    uint32_t lastTimestamp = 0;
+    int64_t extendedTimestamp = 0;
+    // our clock minus the sender's, set when the stream starts
+    int64_t clockOffset = 0;
+    // when the last chunk will have finished playing, in our time
+    int64_t playEndTime = 0;
+    int64_t lastTransit = 0;
+    float jitter = 0;
+
+    // drift is measured from the lowest transit time in each window
+    int64_t driftWindowStart = 0;
+    int64_t windowMinTransit = 0;
+    int64_t lastWindowMinTransit = 0;
+    bool lastWindowValid = false;
+
+    // frame mode, fragments are collected here until the last one
+    vector<ReceivedPoint> framePoints;
+    bool frameInProgress = false;
+    uint32_t frameDuration = 0;
+    uint32_t frameTimestamp = 0;
+
+    // the last points that were received, for display
+    deque<ReceivedPoint> recentPoints;
+    const size_t maxRecentPoints = 4000;
+
+};
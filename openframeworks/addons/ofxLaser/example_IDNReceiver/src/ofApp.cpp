@@ -0,0 +1,86 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	
+	ofSetFrameRate(60);
+	ofBackground(0);
+	
+	receiverRunning = receiver.setup(settings);
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+	
+	float now = ofGetElapsedTimef();
+	if(now - lastRateTime >= 1) {
+		IDNReceiverStats& stats = receiver.stats;
+		float elapsed = now - lastRateTime;
+		bytesPerSecond = (stats.bytes - lastBytes) / elapsed;
+		pointsPerSecond = (stats.points - lastPoints) / elapsed;
+		datagramsPerSecond = (stats.datagrams - lastDatagrams) / elapsed;
+		lastBytes = stats.bytes;
+		lastPoints = stats.points;
+		lastDatagrams = stats.datagrams;
+		minLeadMicros = receiver.resetMinLead();
+		lastRateTime = now;
+	}
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+	
+	float previewSize = 400;
+	float x = 20;
+	float y = 20;
+	
+	if(!receiverRunning) {
+		ofDrawBitmapString("Couldn't bind to port 7255 on " + settings.listenAddress + ", is something else using it?", x, y + 12);
+		return;
+	}
+	
+	IDNReceiverStats& stats = receiver.stats;
+	string mode = stats.serviceMode == ofxLaser::DacIDNConsts::SERVICE_MODE_GRAPHIC_CONTINUOUS ? "WAVE" : stats.serviceMode == ofxLaser::DacIDNConsts::SERVICE_MODE_GRAPHIC_DISCRETE ? "FRAME" : "-";
+	
+	string info;
+	info += "IDN " + receiver.getUnitId() + " \"" + settings.hostName + "\" on " + settings.listenAddress + "\n\n";
+	info += "Mode         : " + mode + " @ " + ofToString(stats.pointRate.load()) + " pps\n";
+	info += "Received     : " + ofToString(pointsPerSecond, 0) + " points/s  " + ofToString(datagramsPerSecond, 0) + " datagrams/s  " + ofToString(bytesPerSecond/1000.0f, 1) + " kB/s\n";
+	info += "Total        : " + ofToString(stats.points.load()) + " points  " + ofToString(stats.frames.load()) + " frames\n";
+	info += "Messages     : " + ofToString(stats.channelMessages.load()) + " (configs " + ofToString(stats.configs.load()) + ", closes " + ofToString(stats.closes.load()) + ")\n";
+	info += "Scans        : " + ofToString(stats.scanRequests.load()) + "\n";
+	info += "Lost         : " + ofToString(stats.lostDatagrams.load()) + "  out of order " + ofToString(stats.outOfOrderDatagrams.load()) + "  malformed " + ofToString(stats.malformed.load()) + "\n";
+	info += "Jitter       : " + ofToString(stats.jitterMicros.load()/1000.0f, 2) + " ms\n";
+	info += "Lead         : " + ofToString(stats.leadMicros.load()/1000.0f, 1) + " ms (min " + ofToString(minLeadMicros/1000.0f, 1) + " ms)\n";
+	info += "Underruns    : " + ofToString(stats.underruns.load()) + "  overflows " + ofToString(stats.overflows.load()) + "\n";
+	info += "Clock drift  : " + ofToString(stats.driftPPM.load(), 1) + " ppm\n";
+	ofDrawBitmapString(info, x + previewSize + 20, y + 12);
+	
+	// draw the points that were most recently received
+	receiver.getRecentPoints(previewPositions, previewColours);
+	previewMesh.clear();
+	previewMesh.setMode(OF_PRIMITIVE_LINE_STRIP);
+	for(size_t i = 0; i<previewPositions.size(); i++) {
+		glm::vec2& p = previewPositions[i];
+		previewMesh.addVertex(glm::vec3(ofMap(p.x, -32768, 32767, x, x+previewSize), ofMap(p.y, 32767, -32768, y, y+previewSize), 0));
+		previewMesh.addColor(previewColours[i]);
+	}
+	ofNoFill();
+	ofSetColor(80);
+	ofDrawRectangle(x, y, previewSize, previewSize);
+	ofSetColor(255);
+	previewMesh.draw();
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::exit(){
+	receiver.close();
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+	
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ofMain.h"
+#include "IDNReceiver.h"
+
+class ofApp : public ofBaseApp{
+	
+public:
+	void setup() override;
+	void update() override;
+	void draw() override;
+	void exit() override;
+	
+	void keyPressed(int key) override;
+	
+	IDNReceiver receiver;
+	IDNReceiverSettings settings;
+	bool receiverRunning = false;
+	
+	// throughput, updated once a second
+	float lastRateTime = 0;
+	uint64_t lastBytes = 0;
+	uint64_t lastPoints = 0;
+	uint32_t lastDatagrams = 0;
+	float bytesPerSecond = 0;
+	float pointsPerSecond = 0;
+	float datagramsPerSecond = 0;
+	int minLeadMicros = 0;
+	
+	vector<glm::vec2> previewPositions;
+	vector<ofColor> previewColours;
+	ofMesh previewMesh;
+	
+};
@@ -0,0 +1,15 @@
+#include "ofMain.h"
+#include "ofApp.h"
+#include "ofAppNoWindow.h"
+
+//========================================================================
+int main( ){
+	
+	// the node doesn't need a window, it can run on a headless
+	// computer next to the lasers
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, 1024, 768, OF_WINDOW);
+	
+	ofRunApp(new ofApp());
+
+}
@@ -0,0 +1,52 @@
+#include "ofApp.h"
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	
+	ofSetFrameRate(100);
+	
+	settings.nodeName = "node-" + ofToString(ofRandom(1000, 9999), 0);
+	nodeRunning = node.setup(settings);
+	if(!nodeRunning) {
+		ofLogError("Couldn't bind to port " + ofToString(settings.dataPort) + ", is something else using it?");
+	}
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+	
+	if(!nodeRunning) return;
+	node.update();
+	
+	float now = ofGetElapsedTimef();
+	if(now - lastLogTime < 1) return;
+	lastLogTime = now;
+	
+	string log = node.getSettings().nodeName + " DACs :";
+	for(string& label : node.getAvailableDacLabels()) log += " [" + label + "]";
+	ofLogNotice() << log;
+	
+	for(ofxLaser::RemoteNodeOutputInfo& info : node.getOutputInfo()) {
+		ofxLaser::RemoteDacStatus& status = info.status;
+		ofLogNotice() << info.dacLabel << " <- " << info.senderAddress
+			<< (info.hasDac ? "" : " (no DAC)")
+			<< (info.armed ? " ARMED " : " ") << info.pps << "pps"
+			<< "  received " << status.framesReceived
+			<< "  played " << status.framesPlayed
+			<< "  dropped " << status.framesDropped
+			<< "  lost " << status.framesIncomplete
+			<< "  buffered " << status.bufferedFrames
+			<< "  jitter " << ofToString(status.jitterMicros/1000.0f, 2) << "ms"
+			<< "  jitter buffer " << ofToString(status.jitterBufferMicros/1000.0f, 1) << "ms"
+			<< "  transit spread " << ofToString(info.transitSpreadMS, 1) << "ms";
+	}
+	
+}
+
+//--------------------------------------------------------------
+void ofApp::exit(){
+	
+	node.close();
+	
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxLaserRemoteNode.h"
+
+class ofApp : public ofBaseApp{
+	
+public:
+	void setup() override;
+	void update() override;
+	void exit() override;
+	
+	ofxLaser::RemoteNode node;
+	ofxLaser::RemoteNodeSettings settings;
+	bool nodeRunning = false;
+	
+	// the status is logged once a second
+	float lastLogTime = 0;
+	
+};
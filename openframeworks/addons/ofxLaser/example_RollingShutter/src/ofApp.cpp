@@ -1,11 +1,6 @@
 #include "ofApp.h"
 
 
-// PLEASE NOTE - NOT CURRENTLY WORKING
-// The DAC code has been refactored considerably and is now very powerful
-// but the raw points functionality needs to be reworked. Sorry for the
-// inconvenience.
-
 // This example demonstrates how you can use the rolling shutter in
 // cameras to create cool effects. See my collaboration with Tom Scott
 // for more information https://www.youtube.com/watch?v=8YONOexk0Ek&t=319s
@@ -36,17 +31,27 @@ void ofApp::setup(){
 void ofApp::update(){
     
 	float deltaTime = ofGetLastFrameTime();
-    pointsToSend+= deltaTime*laserManager.getLaserPointRate(0);
 	elapsedTime+=(deltaTime*timeSpeed);
 	
     // prepares laser manager to receive new points
     laserManager.update();
 	
-	while(pointsToSend>points.size()) {
-		
-		laserManager.sendRawPoints(points);
+	if(points.empty()) return;
+	
+	// the raw points are streamed to the laser, so keep its buffer
+	// topped up. If the DAC can't tell us how much room it has then
+	// send them at the point rate.
+	int space = laserManager.getLaserRawPointSpace(0);
+	if(space<0) {
+		pointsToSend+= deltaTime*laserManager.getLaserPointRate(0);
+		space = pointsToSend;
+	}
+	while(space>=(int)points.size()) {
+		if(!laserManager.sendRawPoints(points)) break;
+		space-=points.size();
 		pointsToSend-=points.size();
 	}
+	pointsToSend = MAX(0, pointsToSend);
 }
 
 
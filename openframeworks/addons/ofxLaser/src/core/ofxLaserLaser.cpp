@@ -7,6 +7,7 @@
 //
 
 #include "ofxLaserLaser.h"
+#include "ofxLaserDacBaseThreaded.h"
 
 using namespace ofxLaser;
 
@@ -49,6 +50,13 @@ void Laser::setDac(DacBase* newdac){
         newdac->setPointsPerSecond(pps);
         newdac->setColourShift(colourChangeShift); 
         newdac->maxLatencyMS = maxLatencyMS;
+        newdac->setAutoLatency(autoLatency, autoLatencyUnderrunProbability);
+        // so we know which DAC the exported telemetry is from
+        DacBaseThreaded* threadeddac = dynamic_cast<DacBaseThreaded*>(newdac);
+        if(threadeddac!=nullptr) {
+            threadeddac->stateRecorder.setLabel(threadeddac->getId());
+            threadeddac->frameRecorder.setLabel(threadeddac->getId());
+        }
         dacLabel = dac->getId();
         // dacAlias = dac->getAlias();
         armed = false; // automatically calls setArmed because of listener on parameter
@@ -131,6 +139,7 @@ void Laser :: init() {
     advanced.add(targetFramerate.set("Target framerate", 25, 23, 120));
     advanced.add(syncToTargetFramerate.set("Sync to Target framerate", false));
     advanced.add(syncShift.set("Sync shift", 0, -50, 50));
+    advanced.add(outputLatencyMS.set("Output latency (ms)", 0, 0, 200));
     
     laserparams.add(advanced);
     
@@ -558,89 +567,83 @@ void Laser::update() {
 }
 
 
-void Laser::sendRawPoints(const vector<ofxLaser::Point>& points, ZoneId* zoneId, float masterIntensity ){
-    // TODO FIX THIS
-    clearPoints();
-    //    
-    //    OutputZone* laserZone = getLaserZoneForZoneIndex(targetZoneIndex);
-    //    if(laserZone==nullptr) {
-    //        ofLogError("Laser::sendRawPoints(...), zone "+ ofToString(targetZoneIndex+1) + " not added to laser ");
-    //        return;
-    //        
-    //    }
-    //    ofRectangle maskRectangle = laserZone->getSourceRect();
-    //
-    //    bool offScreen = true;
-    //    
-    //    vector<Point>segmentpoints;
-    //    
-    //    //iterate through the points
-    //    for(size_t k = 0; k<points.size(); k++) {
-    //        
-    //        Point p = points[k];
-    //        
-    //        // are we outside the mask? NB can't use inside because I want points on the edge
-    //        //
-    //        
-    //        if(p.x<maskRectangle.getLeft() ||
-    //           p.x>maskRectangle.getRight() ||
-    //           p.y<maskRectangle.getTop() ||
-    //           p.y>maskRectangle.getBottom())  {
-    //            
-    //            if(!offScreen) {
-    //                offScreen = true;
-    //                // if we already have points then add an inbetween point
-    //                if(k>0) {
-    //                    Point lastpoint = p;
-    //                    
-    //                    // TODO better point on edge rather than just clamp
-    //                    lastpoint.x = ofClamp(lastpoint.x, maskRectangle.getLeft(), maskRectangle.getRight());
-    //                    lastpoint.y = ofClamp(lastpoint.y, maskRectangle.getTop(), maskRectangle.getBottom());
-    //                    segmentpoints.push_back(lastpoint);
-    //                    
-    //                    
-    //                }
-    //            }
-    //            
-    //        } else {
-    //            // we're on screen!
-    //            if(offScreen) {
-    //
-    //                offScreen = false;
-    //                if(k>0) {
-    //                    Point lastpoint = points[k-1];
-    //                    
-    //                    // TODO better point on edge rather than just clamp
-    //                    lastpoint.x = ofClamp(lastpoint.x, maskRectangle.getLeft(), maskRectangle.getRight());
-    //                    lastpoint.y = ofClamp(lastpoint.y, maskRectangle.getTop(), maskRectangle.getBottom());
-    //                    
-    //                    segmentpoints.push_back(lastpoint);
-    //                }
-    //            }
-    //            segmentpoints.push_back(p);
-    //        }
-    //        
-    //        // create a point object for it
-    //        
-    //    } // end shapepoints
-    //    // add the segment points to the points for the zone
-    //
-    //
-    //    
-    //    // go through all the points and warp them into output space
-    //
-    //    for(size_t k= 0; k<segmentpoints.size(); k++) {
-    //        addPoint(laserZone->getWarpedPoint(segmentpoints[k]));
-    //    }
-    //    
-    //    
-    //    
-    //    processPoints(masterIntensity, false);
-    //    dac->sendPoints(laserPoints);
-    //    
+bool Laser::sendRawPoints(const vector<ofxLaser::Point>& points, ZoneId zoneId, const ofRectangle& sourceRect, float masterIntensity ){
+    
+    OutputZone* laserZone = nullptr;
+    if(useAlternate && hasAltZone(zoneId)) {
+        laserZone = getLaserAltZoneForZoneId(zoneId);
+    } else {
+        laserZone = getLaserZoneForZoneId(zoneId);
+    }
+    if(laserZone==nullptr) {
+        ofLogError("Laser::sendRawPoints(...), zone "+ zoneId.getLabel() + " not added to laser ");
+        return false;
+    }
+    laserZone->setSourceRect(sourceRect);
+    
+    // keep blank points for muted zones so the stream doesn't stop
+    bool blank = (!isLaserZoneActive(laserZone)) || (useAlternate && muteOnAlternate);
+    
+    // the preview shows all the points sent in an app frame
+    if(rawPointsFrameNum!=ofGetFrameNum()) {
+        clearPoints();
+        rawPointsFrameNum = ofGetFrameNum();
+    } else {
+        laserPoints.clear();
+    }
+    
+    for(size_t k = 0; k<points.size(); k++) {
+        
+        Point p = points[k];
+        
+        // unlike shapes we can't leave points out, it'd change the
+        // timing of the stream, so points outside the zone are moved to
+        // the edge and blanked. NB can't use inside because I want points
+        // on the edge
+        if(blank ||
+           p.x<sourceRect.getLeft() ||
+           p.x>sourceRect.getRight() ||
+           p.y<sourceRect.getTop() ||
+           p.y>sourceRect.getBottom())  {
+            p.x = ofClamp(p.x, sourceRect.getLeft(), sourceRect.getRight());
+            p.y = ofClamp(p.y, sourceRect.getTop(), sourceRect.getBottom());
+            p.setColour(0,0,0);
+        }
+        
+        // warp into output space
+        p = laserZone->getWarpedPoint(p);
+        
+        // check if it's in any of the masks!
+        for(QuadMask* mask : maskManager.quads){
+            if(mask->hitTest(p.x, p.y)) {
+                p.multiplyColour(ofMap(mask->maskLevel,100,0,0,1));
+            }
+        }
+        
+        addPoint(p);
+    }
+    
+    // the colour shift carries over from one call to the next so
+    // it works on a stream
+    processPoints(masterIntensity, !dac->colourShiftImplemented);
+    
+    int effectivePps = getEffectivePps();
+    if(effectivePps != lastAppliedPps){
+        dac->setPointsPerSecond(effectivePps);
+        lastAppliedPps = effectivePps;
+    }
+    
+    bool accepted = dac->sendPoints(laserPoints);
+    if(!accepted) rawPointsRejected+=laserPoints.size();
+    numPoints = (int)laserPoints.size();
+    return accepted;
     
 }
 
+int Laser :: getRawPointSpace() {
+    return dac->getPointStreamSpace(maxLatencyMS);
+}
+
 
 void Laser :: clearPoints() {
     laserPoints.clear();
@@ -649,18 +652,13 @@ void Laser :: clearPoints() {
 }
 
 
-void Laser::send(const vector<ZoneContent>& zonesContent, float masterIntensity, ofPixels* pixelmask) {
+void Laser::send(const vector<ZoneContent>& zonesContent, float masterIntensity, ofPixels* pixelmask, uint64_t presentationTimeMicros, int syncToleranceMicros, bool sendToDac) {
     
     if(!guiInitialised) {
         ofLog(OF_LOG_ERROR, "Error, ofxLaser::laser not initialised yet. (Probably missing a ofxLaser::Manager.initGui() call...");
         return;
     }
     
-    if(!dac->isReadyForFrame(maxLatencyMS)) {
-        // register skipped frame
-        return;
-    }
-    
     //update the source rectangles
     for(OutputZone* laserZone : outputZones) {
         // if the zoneContent exists for this zone then update the source rectangle
@@ -1002,7 +1000,14 @@ void Laser::send(const vector<ZoneContent>& zonesContent, float masterIntensity,
         dac->setPointsPerSecond(effectivePps);
         lastAppliedPps = effectivePps;
     }
-    dac->sendFrame(laserPoints);
+    // otherwise it's only for the previews
+    if(sendToDac) {
+        if(presentationTimeMicros>0) {
+            dac->sendSyncedFrame(laserPoints, presentationTimeMicros, syncToleranceMicros);
+        } else {
+            dac->sendFrame(laserPoints);
+        }
+    }
     numPoints = (int)laserPoints.size();
     
     if(sortedshapes.size()>0) {
@@ -57,14 +57,27 @@ class Laser {
     bool deserialize(ofJson& json);
     
     void update();
-    void send(const vector<ZoneContent>& zonesContent, float masterIntensity = 1, ofPixels* pixelmask = NULL);
+    // if presentationTimeMicros is set the DAC aims to start outputting
+    // the frame at that time (see ManagerBase::syncLasers)
+    // if sendToDac is false the points are worked out (for the previews)
+    // but not sent. ManagerBase only calls it once it knows the DAC is
+    // ready, see dacReady.
+    void send(const vector<ZoneContent>& zonesContent, float masterIntensity = 1, ofPixels* pixelmask = NULL, uint64_t presentationTimeMicros = 0, int syncToleranceMicros = 0, bool sendToDac = true);
     
     bool toggleArmed(); 
    
     // adds all the shape points to the vector passed in
     void getAllShapePoints(const vector<ZoneContent>& zonesContent, vector<PointsForShape>* allzoneshapepoints, ofPixels*pixels, float speedmultiplier);
 
-    void sendRawPoints(const vector<Point>& points, ZoneId* zoneId = nullptr, float masterIntensity =1);
+    // Streams points straight to the DAC instead of sending frames, see
+    // ManagerBase::sendRawPoints. Points outside sourceRect are moved to
+    // the edge and blanked so that the timing of the stream is kept.
+    // Returns false if the DAC's buffer is full.
+    bool sendRawPoints(const vector<Point>& points, ZoneId zoneId, const ofRectangle& sourceRect, float masterIntensity =1);
+    // how many points sendRawPoints can take without going over the
+    // latency, -1 if the DAC can't tell
+    int getRawPointSpace();
+    uint64_t getRawPointsRejected() { return rawPointsRejected; };
     int getPointRate();
     float getFrameRate();
     
@@ -167,6 +180,13 @@ class Laser {
  
     ofParameter<float> colourChangeShift;
     int maxLatencyMS; 
+    // whether the DAC was ready for this frame, and when it stopped
+    // being ready (0 if it is), set by ManagerBase::send
+    bool dacReady = true;
+    uint64_t dacNotReadySinceMicros = 0;
+    // lets the DAC find its own latency, see DacLatencyTuner
+    bool autoLatency = false;
+    float autoLatencyUnderrunProbability = 0.01;
     
     int testPattern;
     bool testPatternActive;
@@ -193,6 +213,11 @@ class Laser {
     ofParameter<float> targetFramerate;
     ofParameter<bool> syncToTargetFramerate;
     ofParameter<int> syncShift;
+    // time from the DAC outputting a point to it being seen (eg network
+    // or scanner lag) that isn't in the DAC's queue. ManagerBase::send
+    // sends this laser's frames this much earlier so that they line up
+    // with the other lasers.
+    ofParameter<float> outputLatencyMS;
     ofParameter<bool> sortShapes;
     ofParameter<bool> newShapeSortMethod;
     ofParameter<bool> alwaysClockwise;
@@ -232,6 +257,8 @@ class Laser {
     vector<Point> sparePoints;
     vector<Point> sparePoints2;
     unsigned long frameCounter = 0;
+    uint64_t rawPointsRejected = 0;
+    uint64_t rawPointsFrameNum = 0;
     
     int numPoints;
     ofEventListener paramsChangedListener;
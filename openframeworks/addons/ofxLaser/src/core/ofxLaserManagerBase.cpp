@@ -57,7 +57,11 @@ ManagerBase :: ManagerBase() : dacAssigner(*DacAssigner::instance()) {
     params.add(numLasers.set("numLasers", 0));
     params.add(useAltZones.set("Use alternative zones", false));
     params.add(dontCalculateDisconnected.set("Don't calculate disconnected", false));
+    params.add(syncLasers.set("Sync lasers", false));
+    params.add(syncToleranceMS.set("Sync tolerance (ms)", 1, 0, 20));
+    params.add(useSharedFrames.set("Shared memory input", false));
     useAltZones.addListener(this, &ofxLaser::ManagerBase::useAltZonesChanged);
+    useSharedFrames.addListener(this, &ofxLaser::ManagerBase::useSharedFramesChanged);
     
     testPatternGlobal = 1;
     testPatternGlobalActive = false; 
@@ -69,9 +73,67 @@ ManagerBase :: ManagerBase() : dacAssigner(*DacAssigner::instance()) {
 
 ManagerBase :: ~ManagerBase() {
     //ofLog(OF_LOG_NOTICE, "ofxLaser::Manager destructor");
+    if(initialised) ofRemoveListener(params.parameterChangedE(), this, &ManagerBase::paramChanged);
     saveSettings();
+    DacTelemetryWriter::instance()->stop();
     
 }
+void ManagerBase :: initAndLoadSettings() {
+    
+    if(initialised) {
+        ofLogError("ofxLaser::ManagerBase::initAndLoadSettings() called twice");
+        return ;
+    }
+    
+    customParams.setName("CUSTOM PARAMETERS");
+    
+    params.add(globalLatency.set("Latency (ms)", 150,0,400));
+    params.add(autoLatency.set("Auto latency", false));
+    params.add(autoLatencyUnderrunProbability.set("Underrun probability", 0.01,0.001,0.2));
+    
+    loadSettings();
+    
+    // if no lasers are loaded make one
+    if(lasers.size()==0) {
+        createAndAddLaser();
+    }
+    
+    // param changed updates zone settings and global latency on all
+    paramChanged(params);
+    ofAddListener(params.parameterChangedE(), this, &ManagerBase::paramChanged);
+    
+    params.add(customParams);
+    initialised = true;
+    
+}
+
+void ManagerBase :: paramChanged(ofAbstractParameter& e) {
+    for(Laser* laser : lasers) {
+        laser->maxLatencyMS = globalLatency;
+        laser->autoLatency = autoLatency;
+        laser->autoLatencyUnderrunProbability = autoLatencyUnderrunProbability;
+        laser->getDac()->setAutoLatency(autoLatency, autoLatencyUnderrunProbability);
+    }
+    scheduleSaveSettings();
+}
+
+void ManagerBase::addCustomParameter(ofAbstractParameter& param, bool loadFromSettings){
+    customParams.add(param);
+    if(loadFromSettings){
+        if(!loadedJson.empty()) {
+            if(loadedJson.contains("Laser")) {
+                if(loadedJson["Laser"].contains("CUSTOM_PARAMETERS")) {
+                    try {
+                        ofDeserialize(loadedJson["Laser"]["CUSTOM_PARAMETERS"], param);
+                    } catch(...) {
+                        
+                    }
+                }
+            }
+        }
+    }
+}
+
 //void ManagerBase::canvasSizeChanged(int &size){
 //    laserMask.init(canvasTarget.getWidth(), canvasHeight);
 //}
@@ -323,7 +385,7 @@ void ManagerBase::drawPoly(const ofPolyline & poly, std::vector<ofColor>& colour
     
 }
 
-void ManagerBase::drawPolyFromPoints(const vector<glm::vec3>& points, const vector<ofColor>& colours, string profileName, float brightness){
+void ManagerBase::drawPolyFromPoints(const vector<glm::vec3>& points, const vector<ofColor>& colours, string profileName, float brightness, bool reversable){
     
     if(points.size()==0) return;
     tmpPoints = points;
@@ -332,6 +394,7 @@ void ManagerBase::drawPolyFromPoints(const vector<glm::vec3>& points, const vect
     }
 
     ofxLaser::Polyline* p =new ofxLaser::Polyline(tmpPoints, colours, profileName, brightness);
+    p->reversable = reversable;
     
     if(p->polylinePointer->getPerimeter()>0.1) {
         //p->setTargetZone(targetZone); // only relevant for OFXLASER_ZONE_MANUAL
@@ -361,6 +424,57 @@ void ManagerBase::drawCircle(const glm::vec3 & centre, const float& radius, cons
 }
 
 
+void ManagerBase::drawDottedPoly(const ofPolyline& poly, float dotSpacing, const ofColor& col, float phaseOffset, float dotDwell, string profileName) {
+    drawDottedPoly(poly.getVertices(), poly.isClosed(), dotSpacing, [&](const glm::vec3&, int) { return col; }, phaseOffset, dotDwell, profileName);
+}
+
+void ManagerBase::drawDottedPoly(const vector<glm::vec3>& points, bool closed, float dotSpacing, const DottedPolyline::ColourFunction& colourFunction, float phaseOffset, float dotDwell, string profileName, bool reversable) {
+
+    if(points.size()<2) return;
+    tmpPoints = points;
+    for(glm::vec3& v : tmpPoints) {
+        v = convert3DTo2D(v);
+    }
+    DottedPolyline* d = new DottedPolyline(tmpPoints, closed, dotSpacing, phaseOffset, colourFunction, dotDwell, profileName);
+    d->reversable = reversable;
+    if(d->getNumDots()>0) {
+        currentShapeTarget->addShape(d);
+    } else {
+        delete d;
+    }
+}
+
+void ManagerBase::drawPolyInstances(const ofPolyline& poly, const ofColor& col, const vector<ShapeInstance>& instances, string profileName) {
+
+    if((poly.size()==0)||(poly.getPerimeter()<0.01)||(instances.size()==0)) return;
+
+    ofPolyline& polyline = tmpPoly;
+    polyline = poly;
+    for(glm::vec3& v : polyline.getVertices()) {
+        v = convert3DTo2D(v);
+    }
+    drawShapeInstances(new ofxLaser::Polyline(polyline, col, profileName), instances);
+}
+
+void ManagerBase::drawCircleInstances(const glm::vec3& centre, const float& radius, const ofColor& col, const vector<ShapeInstance>& instances, string profileName) {
+
+    if(instances.size()==0) return;
+
+    ofxLaser::Circle* c = new ofxLaser::Circle(centre, radius, col, profileName);
+    for(glm::vec3& v : c->polyline.getVertices()) {
+        v = convert3DTo2D(v);
+    }
+    drawShapeInstances(c, instances);
+}
+
+void ManagerBase::drawShapeInstances(Shape* shape, const vector<ShapeInstance>& instances) {
+    // deletes the shape when the last instance is deleted
+    std::shared_ptr<InstanceSource> source = std::make_shared<InstanceSource>(shape);
+    for(const ShapeInstance& instance : instances) {
+        currentShapeTarget->addShape(new InstancedShape(source, instance));
+    }
+}
+
 void ManagerBase::drawLaserGraphic(Graphic& graphic, float brightness, string renderProfile) {
     
     auto & polylines = graphic.polylines;
@@ -390,6 +504,10 @@ void ManagerBase:: update(){
     canvasTarget.deleteShapes();
     beamZoneContainer.deleteShapes(); 
     
+    // now that the last frame's shapes have gone, the shared memory
+    // buffers they pointed into can be swapped for new ones
+    sharedFrameReader.update(canvasTarget, beamZoneContainer);
+    
     // updates all the zones. If zone->update returns true, then
     // it means that the zone has changed.
     bool updateZoneRects = false;
@@ -524,18 +642,108 @@ void ManagerBase::send(){
     // So - the shapes need to be sorted in output space but their points need to be
     // calculated at zone space. Otherwise the perspective distortion won't look right in
     // terms of brightness distribution.
+    // 3 :
+    // If the lasers are synced, every frame from this send gets the same
+    // presentation time and each DAC pads or trims its buffer so that the
+    // frame starts at that moment. The presentation time has to allow
+    // for the laser with the most latency.
+    // A laser's output latency (eg a network hop or scanner lag after the
+    // DAC) is taken off its own presentation time so that the light
+    // comes out at the same moment on every laser. So if any laser has
+    // one, the frames are timed even if the lasers aren't synced.
+    // Each DAC is only asked once whether it's ready, as asking also
+    // updates its latency.
+    bool compensateOutputLatency = false;
+    for(Laser* laser : lasers) {
+        if(laser->hasDac() && (laser->outputLatencyMS>0)) compensateOutputLatency = true;
+    }
+    bool timeFrames = syncLasers || compensateOutputLatency;
+    
+    uint64_t nowMicros = ofGetElapsedTimeMicros();
+    // a DAC that hasn't taken a frame for a while has stalled or gone,
+    // so it doesn't get to hold up the others
+    auto hasStalled = [&](Laser* laser) {
+        return (!laser->dacReady) && (nowMicros - laser->dacNotReadySinceMicros > (uint64_t)syncStallTimeoutMS*1000);
+    };
+    
+    // The horizon is worked out before the DACs are asked if they're
+    // ready, because the timed ones have to keep that much queued.
+    // Otherwise a DAC with less latency than the others would have every
+    // frame padded out with blank points and then not be ready again
+    // until they'd played out.
+    int groupLatencyMicros = 0;
+    uint64_t presentationTimeMicros = 0;
+    if(timeFrames) {
+        for(Laser* laser : lasers) {
+            if(!laser->hasDac() || hasStalled(laser)) continue;
+            DacBase* dac = laser->getDac();
+            groupLatencyMicros = MAX(groupLatencyMicros, (dac->getLatencyMS() + dac->calculationTimeMS)*1000 + (int)(laser->outputLatencyMS*1000));
+        }
+        presentationTimeMicros = nowMicros + (uint64_t)groupLatencyMicros;
+    }
+    
+    // all of them send the frame or none of them do, otherwise
+    // content that spans projectors will tear
+    bool groupReady = true;
+    for(Laser* laser : lasers) {
+        DacBase* dac = laser->getDac();
+        if(timeFrames && laser->hasDac()) {
+            // less its output latency, as its frames are sent that much
+            // earlier
+            int horizonMS = (groupLatencyMicros - (int)(laser->outputLatencyMS*1000)) / 1000;
+            laser->dacReady = dac->isReadyForTimedFrame(laser->maxLatencyMS, horizonMS);
+        } else {
+            laser->dacReady = dac->isReadyForFrame(laser->maxLatencyMS);
+        }
+        if(laser->dacReady) laser->dacNotReadySinceMicros = 0;
+        else if(laser->dacNotReadySinceMicros==0) laser->dacNotReadySinceMicros = nowMicros;
+        
+        if(syncLasers && laser->hasDac() && !laser->dacReady && !hasStalled(laser)) groupReady = false;
+    }
+    
     for(size_t i= 0; i<lasers.size(); i++) {
         
         Laser& laser = *lasers[i];
+        // unsynced lasers that aren't ready are skipped as usual. If the
+        // sync group isn't ready the points are still worked out (for the
+        // previews) but not sent.
+        if(!syncLasers && !laser.dacReady) continue;
+        bool sendToDac = laser.dacReady && groupReady;
         
-        laser.send(zonesContent, globalBrightness, NULL);// useBitmapMask?laserMask.getPixels():NULL);
+        // the DAC has to start the frame early by the laser's output latency
+        uint64_t laserPresentationTimeMicros = 0;
+        if(timeFrames) laserPresentationTimeMicros = presentationTimeMicros - (uint64_t)(laser.outputLatencyMS*1000);
+        
+        laser.send(zonesContent, globalBrightness, NULL, laserPresentationTimeMicros, syncToleranceMS*1000, sendToDac);// useBitmapMask?laserMask.getPixels():NULL);
         
         std::this_thread::yield();
         
     }
+    
+    if(sharedFrameReader.isOpen()) {
+        int maxLatencyMS = 0;
+        for(Laser* laser : lasers) {
+            if(laser->hasDac()) maxLatencyMS = MAX(maxLatencyMS, laser->getDac()->getLatencyMS());
+        }
+        sharedFrameReader.frameSent(maxLatencyMS);
+    }
 }
 
 
+int ManagerBase :: getPresentationDelayMicros() {
+    int delayMicros = 0;
+    for(Laser* laser : lasers) {
+        if(!laser->hasDac()) continue;
+        DacBase* dac = laser->getDac();
+        // DACs that don't know how much they've queued are assumed to
+        // be full up to their latency
+        int queuedMicros = dac->getQueuedMicros();
+        if(queuedMicros<0) queuedMicros = dac->getLatencyMS()*1000;
+        delayMicros = MAX(delayMicros, queuedMicros + (int)(laser->outputLatencyMS*1000));
+    }
+    return delayMicros;
+}
+
 int ManagerBase :: getLaserPointRate(unsigned int lasernum ){
     if(lasernum>=lasers.size()) return -1;
     else return lasers.at(lasernum)->getPointRate();
@@ -546,21 +754,44 @@ float ManagerBase :: getLaserFrameRate(unsigned int lasernum ){
         return lasers.at(lasernum)->getFrameRate();
     } else return 0;
 }
-void ManagerBase::sendRawPoints(const std::vector<ofxLaser::Point>& points, int lasernum, ZoneId* zoneId ){
-     ofLog(OF_LOG_NOTICE, "ofxLaser::Manager::sendRawPoints(...) point count : "+ofToString(points.size()));
-    if(lasernum>=lasers.size()) {
+bool ManagerBase::sendRawPoints(const std::vector<ofxLaser::Point>& points, int lasernum, ZoneId* zoneId ){
+    if((lasernum<0) || (lasernum>=lasers.size())) {
         ofLogError("Invalid laser number sent to ofxLaser::ManagerBase::sendRawPoints");
-        return;
+        return false;
     }
     Laser* laser = lasers.at(lasernum);
-//    if(zonenum>=canvasTarget.zones.size()) {
-//        ofLogError("Invalid zone number sent to ofxLaser::ManagerBase::sendRawPoints");
-//        return;
-//    }
-    laser->sendRawPoints(points, zoneId, globalBrightness);
+    
+    ZoneId targetZoneId;
+    if(zoneId!=nullptr) {
+        targetZoneId = *zoneId;
+    } else {
+        vector<OutputZone*> outputZones = laser->getSortedOutputZones();
+        if(outputZones.empty()) {
+            ofLogError("ofxLaser::ManagerBase::sendRawPoints - laser "+ofToString(lasernum+1)+" doesn't have any zones");
+            return false;
+        }
+        targetZoneId = outputZones.front()->getZoneId();
+    }
+    
+    // the same source rectangles as in send()
+    ofRectangle sourceRect(0,0,800,800);
+    if(targetZoneId.type==ZoneId::CANVAS) {
+        InputZone* inputZone = canvasTarget.getInputZoneForZoneId(targetZoneId);
+        if(inputZone==nullptr) {
+            ofLogError("Invalid zone sent to ofxLaser::ManagerBase::sendRawPoints");
+            return false;
+        }
+        sourceRect = inputZone->getRect();
+    }
+    return laser->sendRawPoints(points, targetZoneId, sourceRect, globalBrightness);
     
 }
 
+int ManagerBase :: getLaserRawPointSpace(unsigned int lasernum){
+    if(lasernum>=lasers.size()) return 0;
+    else return lasers.at(lasernum)->getRawPointSpace();
+}
+
 
 //
 //void ManagerBase::armAllLasersListener() {
@@ -596,6 +827,14 @@ void ManagerBase::useAltZonesChanged(bool& state) {
     
 }
 
+void ManagerBase::useSharedFramesChanged(bool& state) {
+    if(state) {
+        if(!sharedFrameReader.open()) useSharedFrames.set(false);
+    } else {
+        sharedFrameReader.close();
+    }
+}
+
 bool ManagerBase::loadSettings() {
     
     ofJson& json = loadedJson;
@@ -616,6 +855,10 @@ bool ManagerBase::loadSettings() {
     }
     canvasTarget.deserialize(json["canvastarget"]);
     
+    if(json.contains("threadPolicy")) {
+        ThreadPolicy::instance()->deserialize(json["threadPolicy"]);
+    }
+    
     // reset the global brightness setting, despite what was in the settings.
     globalBrightness = 0.2;
 
@@ -706,6 +949,7 @@ bool ManagerBase::saveSettings() {
 
     beamZoneContainer.serialize(json["beamzones"]);
     canvasTarget.serialize(json["canvastarget"]);
+    ThreadPolicy::instance()->serialize(json["threadPolicy"]);
     
     bool savesuccess = ofSavePrettyJson("ofxLaser/laserSettings.json", json);
     
@@ -12,13 +12,17 @@
 #include "ofxLaserTransformationManager.h"
 #include "ofxLaserConstants.h"
 #include "ofxLaserDacAssigner.h"
+#include "ofxLaserThreadPolicy.h"
+#include "ofxLaserDacTelemetryWriter.h"
+#include "ofxLaserSharedFrameReader.h"
 #include "ofxLaserInputZone.h"
 #include "ofxLaserShape.h"
 #include "ofxLaserLine.h"
 #include "ofxLaserPolyline.h"
 #include "ofxLaserCircle.h"
+#include "ofxLaserDottedPolyline.h"
+#include "ofxLaserInstancedShape.h"
 #include "ofxLaserDacBase.h"
-#include "ofxLaserBitmapMaskManager.h"
 #include "ofxLaserGraphic.h"
 #include "ofxLaserLaser.h"
 #include "ofxLaserZoneContent.h"
@@ -39,9 +43,16 @@ class ManagerBase : public TransformationManager {
     static ManagerBase * laserManager;
     
     ManagerBase();
-    ~ManagerBase();
+    virtual ~ManagerBase();
     
+    // loads the settings and sets up the lasers. Manager does this when
+    // it's created, apps that use ManagerBase on its own (without the UI
+    // or a window) call it once after creating it.
+    virtual void initAndLoadSettings();
     virtual void update();
+    // the pipeline part of update(), which is all of it here. Manager's
+    // update() is updateFrame() then the UI.
+    void updateFrame() { ManagerBase::update(); }
    
     virtual bool deleteLaser(Laser* laser);
     
@@ -67,9 +78,36 @@ class ManagerBase : public TransformationManager {
     
     virtual void serialize(ofJson& json);
     virtual bool deserialize(ofJson& json);
+    virtual void paramChanged(ofAbstractParameter& e);
+    
+    // app settings that are saved and loaded with the laser settings
+    void addCustomParameter(ofAbstractParameter& param, bool loadFromSettings = true);
     
     void send();
-    void sendRawPoints(const std::vector<ofxLaser::Point>& points, int lasernum = 0, ZoneId* zoneId = nullptr);
+    
+    // Apps that draw and send from their own thread (not the one that draws
+    // the UI) hold this from update() until send() returns. Manager holds it
+    // while the UI reads or changes the lasers and zones.
+    std::mutex& getFrameMutex() { return frameMutex; }
+    
+    // how long until a frame sent now starts being seen, on the laser
+    // that's furthest behind (including its output latency). The other
+    // lasers' frames are timed to be seen at the same moment (see send()).
+    // Apps can use it to work out animation for when the frame will be
+    // seen rather than when it's calculated.
+    int getPresentationDelayMicros();
+    
+    // Streams points to a laser without any rendering, for when the
+    // points are generated at the point rate (eg vector synthesis). The
+    // points are in the zone's coordinates (the first zone on the laser
+    // if zoneId is nullptr) and are clipped and warped like shapes.
+    // Returns false if the DAC's buffer is full, keep to
+    // getLaserRawPointSpace to avoid that.
+    bool sendRawPoints(const std::vector<ofxLaser::Point>& points, int lasernum = 0, ZoneId* zoneId = nullptr);
+    // how many points the laser can take right now without going over
+    // its latency, or -1 if its DAC can't tell (then pace them with
+    // getLaserPointRate)
+    int getLaserRawPointSpace(unsigned int lasernum = 0);
     
     int getLaserPointRate(unsigned int lasernum = 0);
     float getLaserFrameRate(unsigned int lasernum);
@@ -83,7 +121,9 @@ class ManagerBase : public TransformationManager {
 
     void drawPoly(const ofPolyline &poly, const ofColor& col,  string profileName = OFXLASER_PROFILE_DEFAULT, float brightness = 1);
     void drawPoly(const ofPolyline & poly, vector<ofColor>& colours, string profileName = OFXLASER_PROFILE_DEFAULT, float brightness =1);
-    void drawPolyFromPoints(const vector<glm::vec3>& points, const vector<ofColor>& colours, string profileName = OFXLASER_PROFILE_DEFAULT, float brightness =1);
+    // reversable false stops the shape being drawn backwards, for when the
+    // order the points are drawn in matters
+    void drawPolyFromPoints(const vector<glm::vec3>& points, const vector<ofColor>& colours, string profileName = OFXLASER_PROFILE_DEFAULT, float brightness =1, bool reversable = true);
    
     void drawLine(const glm::vec3& start, const glm::vec3& end, const ofColor& col, string profileName = OFXLASER_PROFILE_DEFAULT);
     void drawLine(const glm::vec2& start, const glm::vec2& end, const ofColor& col, string profileName = OFXLASER_PROFILE_DEFAULT);
@@ -97,6 +137,18 @@ class ManagerBase : public TransformationManager {
     void drawCircle(const glm::vec3& centre, const float& radius,const ofColor& col, string profileName= OFXLASER_PROFILE_DEFAULT);
     void drawCircle(const glm::vec2& centre, const float& radius,const ofColor& col, string profileName= OFXLASER_PROFILE_DEFAULT);
    
+    // dots every dotSpacing along the path, sent as one shape (see DottedPolyline)
+    void drawDottedPoly(const ofPolyline& poly, float dotSpacing, const ofColor& col, float phaseOffset = 0, float dotDwell = 1, string profileName = OFXLASER_PROFILE_DEFAULT);
+    void drawDottedPoly(const vector<glm::vec3>& points, bool closed, float dotSpacing, const DottedPolyline::ColourFunction& colourFunction, float phaseOffset = 0, float dotDwell = 1, string profileName = OFXLASER_PROFILE_DEFAULT, bool reversable = true);
+
+    // draws a copy of the shape for each instance. The shape's points are only
+    // worked out once and then transformed and tinted for each instance (see
+    // InstancedShape). The instance transforms are in canvas space.
+    void drawPolyInstances(const ofPolyline& poly, const ofColor& col, const vector<ShapeInstance>& instances, string profileName = OFXLASER_PROFILE_DEFAULT);
+    void drawCircleInstances(const glm::vec3& centre, const float& radius, const ofColor& col, const vector<ShapeInstance>& instances, string profileName = OFXLASER_PROFILE_DEFAULT);
+    // takes ownership of the shape, which should already be in canvas space
+    void drawShapeInstances(Shape* shape, const vector<ShapeInstance>& instances);
+
     void drawLaserGraphic(Graphic& graphic, float brightness = 1, string renderProfile = OFXLASER_PROFILE_DEFAULT);
     
     vector<Laser*>& getLasers();
@@ -118,18 +170,6 @@ class ManagerBase : public TransformationManager {
     bool isLaserArmed(unsigned int i);
 	bool areAllLasersArmed();
     
-    void beginDraw() {
-        // to do : check target
-        ofViewport((ofGetWidth()-canvasTarget.getWidth())/-2, (ofGetHeight()-canvasTarget.getHeight())/-2, ofGetWidth(), ofGetHeight()) ;
-        ofPushMatrix();
-        ofTranslate((ofGetWidth()-canvasTarget.getWidth())/2, (ofGetHeight()-canvasTarget.getHeight())/2);
-        
-    }
-    void endDraw() {
-        ofPopMatrix();
-        ofViewport(0,0,ofGetWidth(), ofGetHeight());
-    }
-    
     
   
     //--------------------------------------------------------
@@ -148,15 +188,27 @@ class ManagerBase : public TransformationManager {
     ofParameter<int> numLasers; // << not used except for load / save
     
     ofParameter<bool> dontCalculateDisconnected;
+    // sync group, all the lasers start each frame at the same time
+    ofParameter<bool> syncLasers;
+    ofParameter<float> syncToleranceMS;
+    // a laser whose DAC hasn't been ready for this long is left out of
+    // the sync group until it is again
+    int syncStallTimeoutMS = 1000;
+    // frames from other processes, see ofxLaserSharedFrames.h
+    ofParameter<bool> useSharedFrames;
+    SharedFrameReader sharedFrameReader;
     
     ofParameter<float>globalBrightness;
+    
+    ofParameter<int> globalLatency;
+    ofParameter<bool> autoLatency;
+    ofParameter<float> autoLatencyUnderrunProbability;
 
-    BitmapMaskManager laserMask;
-                
   //  bool zonesChanged;
     //std::vector<InputZone*> zones;
     
     ofParameterGroup params;
+    ofParameterGroup customParams;
  
     ofJson loadedJson;
     
@@ -184,8 +236,11 @@ class ManagerBase : public TransformationManager {
     // to avoid generating polyline objects
     ofPolyline tmpPoly;
     vector<glm::vec3> tmpPoints;
+    
+    std::mutex frameMutex;
+    
+    bool initialised = false;
   
-    ofSoundPlayer beepSound;
     bool settingsNeedSave = false;
     float lastSaveTime = 0; 
    
@@ -41,6 +41,7 @@ void DacEtherDream :: setup(string _id, string _ip, EtherDreamData& ed) {
 	
 	pps = 0;
 	pps = newPPS = 30000; // this is always sent on begin
+    bufferEstimator.setPointRate(pps);
 	queuedPPSChangeMessages = 0;
 	connected = false;
 	ipAddress = _ip;
@@ -66,7 +67,7 @@ void DacEtherDream :: setup(string _id, string _ip, EtherDreamData& ed) {
         versionString = "(virtual)";
     }
     
-    int port = 7765;
+    port = 7765;
     if(ed.hardwareRevision == 0) {
         //logNotice("VIRTUAL ETHERDREAM FOUND! ") << ed.hardwareRevision << " " << ed.softwareRevision;
         port += ed.softwareRevision;
@@ -74,67 +75,117 @@ void DacEtherDream :: setup(string _id, string _ip, EtherDreamData& ed) {
     // TODO update max point rate from dacdata
     pointBufferCapacity = ed.bufferCapacity;
  
-	Poco::Timespan timeout( 1 * 1000000); // 1 second timeout
+	connected = connectSocket(Poco::Timespan( 1 * 1000000)); // 1 second timeout
+	beginSent = false;
+	
+	// if it didn't connect, the thread keeps trying
+	startThread(); // blocking is true by default I think?
+}
+
+bool DacEtherDream :: connectSocket(Poco::Timespan timeout) {
 	
 	try {
 		// EtherDreams always talk on port 7765
 		Poco::Net::SocketAddress sa(ipAddress, port);
 		//logNotice"TIMEOUT" + ofToString(timeout.totalSeconds()));
-        
+		
+		// connect from the network interface that the EtherDream was
+		// found on, otherwise the OS picks one
+		if(etherDreamData.interfaceAddress!="") {
+			socket.impl()->bind(Poco::Net::SocketAddress(etherDreamData.interfaceAddress, 0), true);
+		}
 		socket.connect(sa, timeout);
-		socket.setSendTimeout(timeout);
-		socket.setReceiveTimeout(timeout);
+		// the timeouts for sending and receiving are always 1 second
+		socket.setSendTimeout(Poco::Timespan(1 * 1000000));
+		socket.setReceiveTimeout(Poco::Timespan(1 * 1000000));
 		
-		connected = true;
-	} catch (Poco::Exception& exc) {
-		//Handle your network errors.
-		ofLog(OF_LOG_ERROR,  "DacEtherDream setup failed - Network error: " +ipAddress+" "+ exc.displayText());
-		connected = false;
-
-	}catch (Poco::Net::HostNotFoundException& exc) {
+		return true;
+	} catch (Poco::Net::HostNotFoundException& exc) {
 		//Handle your network errors.
-		ofLog(OF_LOG_ERROR,  "DacEtherDream setup failed - host not found: " + exc.displayText());
-		connected = false;
+		ofLog(OF_LOG_ERROR,  "DacEtherDream connect failed - host not found: " + exc.displayText());
 		
 	}catch (Poco::TimeoutException& exc) {
+		// don't log this when we're reconnecting as it'll happen a lot
+		if(!reconnector.isReconnecting()) ofLog(OF_LOG_ERROR,  "DacEtherDream connect failed - Timeout error: " + exc.displayText());
+		
+	} catch (Poco::Exception& exc) {
 		//Handle your network errors.
-		ofLog(OF_LOG_ERROR,  "DacEtherDream setup failed - Timeout error: " + exc.displayText());
-		connected = false;
+		if(!reconnector.isReconnecting()) ofLog(OF_LOG_ERROR,  "DacEtherDream connect failed - Network error: " +ipAddress+" "+ exc.displayText());
 		
 	}
 	catch(...){
-		ofLog(OF_LOG_ERROR, "DacEtherDream setup failed - unknown error");
+		ofLog(OF_LOG_ERROR, "DacEtherDream connect failed - unknown error");
 		//std::rethrow_exception(current_exception);
-		connected = false;
 	}
-		
+	return false;
+}
 
-	if(connected) {
-		//prepareSent = false;
-		beginSent = false;
-		startThread(); // blocking is true by default I think?
-		
+void DacEtherDream :: setAddress(const string& ip, const string& interfaceAddress) {
+	while(!lock());
+	newIpAddress = ip;
+	newInterfaceAddress = interfaceAddress;
+	addressChanged = true;
+	unlock();
+}
+
+bool DacEtherDream :: updateAddress() {
+	// checked every time round the loop so don't lock unless we need to
+	if(!addressChanged) return false;
+	bool changed = false;
+	while(!lock());
+	if(addressChanged) {
+		changed = (newIpAddress!=ipAddress) || (newInterfaceAddress!=etherDreamData.interfaceAddress);
+		ipAddress = newIpAddress;
+		etherDreamData.ipAddress = newIpAddress;
+		etherDreamData.interfaceAddress = newInterfaceAddress;
+		addressChanged = false;
+	}
+	unlock();
+	if(changed) ofLogNotice("DacEtherDream " + id + " has moved to " + ipAddress);
+	return changed;
+}
 
+bool DacEtherDream :: reconnect() {
+	
+	if(reconnector.connectionLost()) {
+		ofLogNotice("DacEtherDream " + id + " connection lost, reconnecting to " + ipAddress);
 	}
+	
+	while(isThreadRunning()) {
+		if(!reconnector.isTimeToRetry()) {
+			sleep(1);
+			continue;
+		}
+		// it might have moved again while we were trying
+		updateAddress();
+		// the old socket can't be reused once it's failed
+		socket.close();
+		socket = Poco::Net::StreamSocket();
+		
+		if(connectSocket(Poco::Timespan(reconnector.connectTimeoutMicros))) {
+			// the dac sends a ping response as soon as you connect
+			if(waitForAck('?')) {
+				connected = true;
+				beginSent = false;
+				prepareSendCount = 0;
+				// pps stays as it was and is sent with the begin
+				// command, and we start again from the newest frame
+				discardStaleFrames();
+				reconnector.reconnected();
+				return true;
+			}
+		}
+	}
+	return false;
 }
 
 void DacEtherDream :: threadedFunction(){
     
-    auto & thread = getNativeThread();
-   
-#ifndef _MSC_VER
-    // only linux and osx
-    //http://www.yonch.com/tech/82-linux-thread-priority
-    struct sched_param param;
-    param.sched_priority = 90; // (highest) sched_get_priority_max(SCHED_FIFO);//89; // - higher is faster
-    pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param );
-#else
-    // windows implementation
-    SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_HIGHEST);
-#endif
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "EtherDream");
 
     // the dac sends a ping response as soon as you connect
-    waitForAck('?');
+    if(connected) connected = waitForAck('?');
     
     bool needToSendPrepare = true;
     
@@ -145,6 +196,16 @@ void DacEtherDream :: threadedFunction(){
     
     while(isThreadRunning()) {
         
+        // if it's moved then the connection we've got is to nothing
+        if(updateAddress()) connected = false;
+        
+        // if we've lost the DAC then get it back as quickly as we can
+        if(!connected) {
+            if(!reconnect()) break;
+            needToSendPrepare = true;
+            if(response.status.playback_state == ETHERDREAM_PLAYBACK_PREPARED) resetFlag = true;
+        }
+        
         if(resetFlag) {
             
             resetFlag = false;
@@ -206,6 +267,7 @@ void DacEtherDream :: threadedFunction(){
             
             if(sendPointRate(newPPS)){
                 pps = newPPS;
+                bufferEstimator.setPointRate(pps);
                 waitForAck('q');
                 // after you send a rate change message you need to
                 // include a flag on one of the points that tells
@@ -271,24 +333,17 @@ void DacEtherDream :: threadedFunction(){
 
         // if state is prepared and we have sent enough points and we haven't already, send begin
         if(connected && (response.status.playback_state==ETHERDREAM_PLAYBACK_PREPARED) && (lastReportedBufferFullness >= maxPointsToFillBuffer)) {
-            logNotice( "Send begin, buffer_fullness : " +ofToString(lastReportedBufferFullness) + " pointBufferMin : " + ofToString(maxPointsToFillBuffer));
+            logNotice("Send begin, buffer_fullness : %d pointBufferMin : %d", lastReportedBufferFullness, maxPointsToFillBuffer);
             sendBegin();
             beginSent = waitForAck('b');
             if(beginSent)  {
                 logNotice("waitForAck('b') success");
+                reconnector.lightRestored(getId());
             }
             
         }
          
         
-        if(!connected) {
-            if(socket.available()) {
-                connected = true;
-                resetFlag = true;
-            }
-            
-        }
-        
         yield();
     }
 }
@@ -435,7 +490,7 @@ inline bool DacEtherDream :: sendPointsToDac(){
 		if(queuedPPSChangeMessages>0) {
 			// bit 15 is a flag to tell the DAC about a new point rate
             dacPoint.control = 0b1000000000000000;
-            logNotice("PPS Change queue "+ofToString(queuedPPSChangeMessages));
+            logNotice("PPS Change queue %d", queuedPPSChangeMessages);
 			queuedPPSChangeMessages--;
         } else {
             dacPoint.control = 0;
@@ -446,13 +501,13 @@ inline bool DacEtherDream :: sendPointsToDac(){
 	}
 	
 	if(dacCommand.size()>=100000) {
-		ofLog(OF_LOG_ERROR, "ofxLaser::DacEtherDream - too many bytes to send! - " + ofToString(dacCommand.size()));
+		AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "ofxLaser::DacEtherDream - too many bytes to send! - %d", (int)dacCommand.size());
 	}
 	
   
     // check we sent enough points
     if(dacCommand.numPointsExpected!=dacCommand.numPoints) {
-        ofLogError("DacEtherDream, incorrect point count sent, expected "+ofToString(dacCommand.numPointsExpected)+", got "+ofToString(dacCommand.numPoints));
+        AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "DacEtherDream, incorrect point count sent, expected %d, got %d", dacCommand.numPointsExpected, dacCommand.numPoints);
     }
     
 	
@@ -460,6 +515,7 @@ inline bool DacEtherDream :: sendPointsToDac(){
     if(success) {
         lastDataSentTime = ofGetElapsedTimeMicros();
         lastDataSentBufferSize = minDacBufferSize + dacCommand.numPoints;
+        bufferEstimator.addPoints(dacCommand.numPoints, lastDataSentTime);
     }  else {
         logNotice("sendCommand failed!");
         
@@ -486,7 +542,7 @@ inline bool DacEtherDream::waitForAck(char command) {
     
 	bool waiting = true;
 	bool failed = false;
-    if(verbose) logNotice("waitForAck - " + ofToString(command));
+    if(verbose) logNotice("waitForAck - %c", command);
 	
     //uint64_t previousLastCommandSendTime = lastCommandSendTime;
     
@@ -507,12 +563,12 @@ inline bool DacEtherDream::waitForAck(char command) {
 			
 		} catch (Poco::Exception& exc) {
 			//Handle your network errors.
-			ofLog(OF_LOG_ERROR,  "Network error: " + exc.displayText());
+			AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "Network error: %s", exc.displayText().c_str());
 			//	isOpen = false;
 			failed = true;
 		} catch (Poco::TimeoutException& exc) {
 			//Handle your network errors.
-			ofLog(OF_LOG_ERROR,  "Timeout error: " + exc.displayText());
+			AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "Timeout error: %s", exc.displayText().c_str());
 			//	isOpen = false;
 			failed = true;
 			
@@ -553,10 +609,14 @@ inline bool DacEtherDream::waitForAck(char command) {
 		connected = true;
         response.deserialize(inBuffer);
         lastReportedBufferFullness = response.status._buffer_fullness;
+        bufferEstimator.addMeasurement(lastReportedBufferFullness, lastAckTime, roundTripTimeMicros);
+        bufferEstimator.setPlaying(response.status.playback_state==ETHERDREAM_PLAYBACK_PLAYING, lastAckTime);
         if(command == 'd') {
             int numbytes = dacCommand.size()+22;
            
             stateRecorder.recordStateThreadSafe(lastDataSentTime, response.status.playback_state, lastReportedBufferFullness, roundTripTimeMicros, dacCommand.numPoints, response.status.point_rate, numbytes);
+            // the lowest the buffer got was just before these points arrived
+            if(beginSent) latencyTuner.addSample(lastAckTime, lastReportedBufferFullness - dacCommand.numPoints, roundTripTimeMicros, pps, response.status.playback_flags & 0b010);
           
         }
 
@@ -587,14 +647,14 @@ inline bool DacEtherDream::waitForAck(char command) {
                 logNotice("BUFFER OVERFLOW -------------------");
             }
             
-            logNotice("response : "+ ofToString(response.response) +  " command : " + ofToString(response.command) );
+            logNotice("response : %c command : %c", (char)response.response, (char)response.command);
             if(command == 'd') {
-                logNotice("num points sent : " + ofToString(dacCommand.numPoints));
-                logNotice("previousStateBufferFullness : " + ofToString(previousStateBufferFullness));
+                logNotice("num points sent : %d", dacCommand.numPoints);
+                logNotice("previousStateBufferFullness : %d", previousStateBufferFullness);
                 //logNotice("time between ack and send : " + ofToString(lastDataSentTime  - previousLastAckTime));
-                logNotice("lastReportedBufferSize : "+ofToString(lastReportedBufferFullness));
-                logNotice("calculateBufferSizeByTimeSent() : "+ofToString(calculateBufferFullnessByTimeSent()));
-                logNotice("calculateBufferSizeByTimeAcked() : "+ofToString(calculateBufferFullnessByTimeAcked()));
+                logNotice("lastReportedBufferSize : %d", lastReportedBufferFullness);
+                logNotice("calculateBufferSizeByTimeSent() : %d", calculateBufferFullnessByTimeSent());
+                logNotice("calculateBufferSizeByTimeAcked() : %d", calculateBufferFullnessByTimeAcked());
 
                // dacCommand.logData();
             }
@@ -616,7 +676,7 @@ inline bool DacEtherDream::waitForAck(char command) {
             
             if(response.response=='I') {
 
-                logNotice("INVALID COMMAND : " + ofToString(command));
+                logNotice("INVALID COMMAND : %c", command);
                 //logData();
                 
                 failed = true;
@@ -684,7 +744,7 @@ inline bool DacEtherDream::waitForAck(char command) {
 		
 	}
 	else {
-		logNotice("Network failure or data received from EtherDream not 22 bytes :" + ofToString(n));
+		logNotice("Network failure or data received from EtherDream not 22 bytes : %d", n);
 		// what do we do now?
 		
 	}
@@ -814,9 +874,8 @@ bool DacEtherDream :: sendCommand(DacEtherDreamCommand& command) { // sendBytes(
 	
 	if(failed) {
 		if(networkerror) {
-            connected = false; 
-			closeWhileRunning();
-			setup(id, ipAddress, etherDreamData);
+            // the thread reconnects
+            connected = false;
 		}
 		beginSent = false;
         
@@ -862,6 +921,7 @@ bool DacEtherDream::setPointsPerSecond(uint32_t newpps){
         newPPS = newpps;
         if (!beginSent) {
             pps = newPPS; // pps rate will get sent with begin anyway
+            bufferEstimator.setPointRate(pps);
             unlock();
             return true;
         } else {
@@ -46,12 +46,17 @@ public:
     const vector<ofAbstractParameter*>& getDisplayData() override;
    
     void setup(string id, string ip, EtherDreamData& ed);
+    // if the EtherDream has moved (a new IP address or network), the
+    // thread reconnects to it there. Safe to call from any thread.
+    void setAddress(const string& ip, const string& interfaceAddress);
     
     void closeWhileRunning();
     void close() override;
     void reset() override;
    
     int getMaxPointBufferSize() override;
+    // the acks have the buffer fullness in them
+    bool canAutoLatency() override { return true; };
     // estimate the current dac buffer fullness based on the last time points were sent
     virtual int calculateBufferFullnessByTimeSent() override;
     // estimate the current dac buffer fullness based on the last time points were acknowledged
@@ -68,6 +73,12 @@ protected:
     // ofThread functions
     void threadedFunction() override;
   
+    // connects the socket to the DAC's address
+    bool connectSocket(Poco::Timespan timeout);
+    // keeps trying to connect to the same DAC until it works or
+    // the thread stops
+    bool reconnect();
+    
     inline bool sendBegin();
     inline bool sendPrepare();
     inline bool sendPointsToDac();
@@ -117,8 +128,16 @@ protected:
     int numBlankPointsToSendAfterReset = 10; 
     
     string ipAddress;
+    int port;
     string id;
     
+    // from setAddress, protected by the mutex
+    string newIpAddress;
+    string newInterfaceAddress;
+    std::atomic<bool> addressChanged{false};
+    // called on the DAC thread, returns true if the address changed
+    bool updateAddress();
+    
     //vector<EtherDreamDacPoint*> sparePoints;
 
     
@@ -17,5 +17,7 @@ struct EtherDreamData {
     string macAddress;
     string ipAddress;
     float lastUpdateTime;
+    // the address of our network interface that it was found on
+    string interfaceAddress;
 };
 }
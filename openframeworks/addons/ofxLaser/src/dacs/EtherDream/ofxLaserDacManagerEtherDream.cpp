@@ -30,23 +30,17 @@ void DacManagerEtherDream :: threadedFunction() {
     const int packetSize = 50;
     char udpMessage[packetSize];
     
-    auto & thread = getNativeThread();
-    //unsigned int n = std::thread::hardware_concurrency();
-    //    std::cout << n << " concurrent threads are supported.\n";
-   
-#ifndef _MSC_VER
-    // only linux and osx
-    //http://www.yonch.com/tech/82-linux-thread-priority
-    struct sched_param param;
-    param.sched_priority = 1; // (highest) sched_get_priority_max(SCHED_FIFO);//89; // - higher is faster
-    pthread_setschedparam(thread.native_handle(), SCHED_RR, &param );
-#else
-    // windows implementation
-    SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_LOWEST);
-#endif
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DISCOVERY, "ED discovery");
     
     while(isThreadRunning()) {
         
+        // network interfaces come and go (eg when a cable is plugged in)
+        if((lastInterfaceCheckTime==0) || (ofGetElapsedTimef()-lastInterfaceCheckTime > 5)) {
+            networkInterfaces = NetworkInterfaces::getIPv4Interfaces();
+            lastInterfaceCheckTime = ofGetElapsedTimef();
+        }
+        
         // LET'S ASSUME FOR NOW...
         // that every packet is a complete message from a single dac.
         
@@ -110,10 +104,17 @@ void DacManagerEtherDream :: threadedFunction() {
                 //sprintf(idchar, "%llX", macAddress);
                 string id(idchar);
                 
+                // the broadcast could have come in on any network, find the
+                // one with the EtherDream's subnet. Virtual EtherDreams on this
+                // computer won't have one.
+                string interfaceAddress;
+                const NetworkInterfaceData* networkInterface = NetworkInterfaces::findInterfaceForAddress(networkInterfaces, address);
+                if(networkInterface!=nullptr) interfaceAddress = networkInterface->address;
+                
                 // if we haven't already got this etherdream, then add it
                 if(etherdreamDataByMacAddress.find(id) == etherdreamDataByMacAddress.end()) {
-                    EtherDreamData ed = {hardwareRevision, softwareRevision, bufferCapacity, (int) maxPointRate, id, address, ofGetElapsedTimef()};
-                    ofLogNotice("Adding etherdream "+ id)<< " " << hardwareRevision << " " << softwareRevision << " " << id;
+                    EtherDreamData ed = {hardwareRevision, softwareRevision, bufferCapacity, (int) maxPointRate, id, address, ofGetElapsedTimef(), interfaceAddress};
+                    ofLogNotice("Adding etherdream "+ id)<< " " << hardwareRevision << " " << softwareRevision << " " << id << " " << address << " on " << (networkInterface!=nullptr ? networkInterface->name : "unknown interface");
                     //ofLogNotice(status.toString());
                     if(lock()) {
                         etherdreamDataByMacAddress[id] = ed;
@@ -123,7 +124,14 @@ void DacManagerEtherDream :: threadedFunction() {
                 } else {
                     
                     if(lock()) {
-                        etherdreamDataByMacAddress[id].lastUpdateTime = ofGetElapsedTimef();
+                        EtherDreamData& ed = etherdreamDataByMacAddress[id];
+                        ed.lastUpdateTime = ofGetElapsedTimef();
+                        // it's moved
+                        if((ed.ipAddress!=address) || (ed.interfaceAddress!=interfaceAddress)) {
+                            ed.ipAddress = address;
+                            ed.interfaceAddress = interfaceAddress;
+                            dacsChanged = true;
+                        }
                         unlock();
                     }
                 }
@@ -167,6 +175,10 @@ vector<DacData> DacManagerEtherDream :: updateDacList(){
         
         string id = ed.macAddress;
         daclist.emplace_back(getType(), id, ed.ipAddress);
+        
+        // if we're using it, make sure it knows where it is now
+        DacEtherDream* dac = (DacEtherDream*)getDacById(id);
+        if(dac!=nullptr) dac->setAddress(ed.ipAddress, ed.interfaceAddress);
 
     }
     return daclist;
@@ -12,6 +12,8 @@
 #include "ofxLaserDacEtherDreamData.h"
 #include "ofxNetwork.h"
 #include "ofThread.h"
+#include "ofxLaserThreadPolicy.h"
+#include "ofxLaserNetworkInterfaces.h"
 
 
 namespace ofxLaser {
@@ -37,7 +39,11 @@ class DacManagerEtherDream : public DacManagerBase, ofThread{
     protected :
     
     bool connected = false;
+    // listens on every network interface
     ofxUDPManager udpConnection;
+    // to work out which one each EtherDream is on
+    vector<NetworkInterfaceData> networkInterfaces;
+    float lastInterfaceCheckTime = 0;
 
     map<string, EtherDreamData> etherdreamDataByMacAddress;
     float lastCheckTime = 0; 
@@ -71,56 +71,97 @@ void DacHelios::close() {
 bool DacHelios::setup(libusb_device* usbdevice) {
 
     usbDevice = usbdevice; 
+    HeliosDacDevice* dac = openDevice(usbdevice);
+    if(dac==nullptr) return false;
+    
+    if(dac->nameStr.empty()) {
+        ofLogError("new dac name is wrong!");
+    }
+
+    dacDevice = dac;
+    dacName = dacDevice->GetName();
+    usbLocation.set(usbdevice);
+
+    connected = true;
+    
+    startThread();
+    return true;
+
+}
+
+bool DacHelios :: isUsbDevice(libusb_device* usbdevice) {
+    while(!lock());
+    bool same = (usbDevice == usbdevice);
+    unlock();
+    return same;
+}
+
+HeliosDacDevice* DacHelios :: openDevice(libusb_device* usbdevice) {
+    
     libusb_device_handle* devHandle;
     int result = libusb_open(usbdevice, &devHandle);
-    cout << "...libusb_open result : " << result << endl;
     
     if (result < 0) {
-        return false;
+        return nullptr;
     }
     
     result = libusb_claim_interface(devHandle, 0);
-    cout << "...libusb_claim_interface : " << result << endl;
     // seems to return LIBUSB_ERROR_ACCESS if it's busy
     if (result < 0) {
         libusb_close(devHandle);
-        return false;
+        return nullptr;
     }
     
     result = libusb_set_interface_alt_setting(devHandle, 0, 1);
-    cout << "...libusb_set_interface_alt_setting : " << result << endl;
     if (result < 0) {
         libusb_close(devHandle);
-        return false;
+        return nullptr;
     }
     
-    HeliosDacDevice* dac = new HeliosDacDevice(devHandle);
-    cout << "...new dac device " << dac->nameStr << endl;
-    if(dac->nameStr.empty()) {
-        ofLogError("new dac name is wrong!");
-    }
-
-    dacDevice = dac;
-    dacName = dacDevice->GetName();
-
-	// Not sure if we need this right now - it changes the thread priority. 
-	// Could be necessary on Raspberry Pi. 
-    //#ifndef _MSC_VER
-    //        // only linux and osx
-    //        //http://www.yonch.com/tech/82-linux-thread-priority
-    //        struct sched_param param;
-    //        param.sched_priority = 60;
-    //        pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param );
-    //#else
-    //        // windows implementation
-    //        SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_LOWEST);
-    //#endif
+    return new HeliosDacDevice(devHandle);
+}
 
-    connected = true;
+bool DacHelios :: reconnect() {
     
-    startThread();
-    return true;
-
+    if(reconnector.connectionLost()) {
+        ofLogNotice("DacHelios " + dacName + " connection lost, reconnecting");
+    }
+    if(dacDevice!=nullptr) {
+        dacDevice->SetClosed();
+        delete dacDevice;
+        dacDevice = nullptr;
+    }
+    
+    while(isThreadRunning()) {
+        if(!reconnector.isTimeToRetry()) {
+            sleep(1);
+            continue;
+        }
+        bool found = usbLocation.find([this](libusb_device* usbdevice) {
+            HeliosDacDevice* device = openDevice(usbdevice);
+            if(device==nullptr) return false;
+            if(device->GetName() == dacName) {
+                dacDevice = device;
+                // the manager reads this from its thread
+                while(!lock());
+                usbDevice = usbdevice;
+                unlock();
+                return true;
+            }
+            delete device;
+            return false;
+        });
+        
+        if(found) {
+            // make sure the shutter state gets sent again, the pps
+            // goes with every frame
+            armed = !newArmed;
+            setConnected(true);
+            reconnector.reconnected();
+            return true;
+        }
+    }
+    return false;
 }
 
 
@@ -211,12 +252,23 @@ void DacHelios :: reset() {
 
 void DacHelios :: threadedFunction(){
 	
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "Helios");
+    
 	DacHeliosFrame* currentFrame = nullptr;
 	DacHeliosFrame* nextFrame = nullptr;
 	DacHeliosFrame* newFrame = nullptr;
 	
 	while(isThreadRunning()) {
 	
+        // if the Helios has been unplugged (or has re-enumerated)
+        // get it back as quickly as we can
+        if(!connected) {
+            if(!reconnect()) break;
+            // and start again with the newest frame
+            if(currentFrame!=nullptr) currentFrame = deleteFrame(currentFrame);
+        }
+        
         // pps = points per second
 		if(connected && (newPPS!=pps)) {
             // we don't have to do anything particularly
@@ -286,12 +338,13 @@ void DacHelios :: threadedFunction(){
                 } else {
                     // if we have an actual error...
 					if(status<0) {
-                        ofLog(OF_LOG_NOTICE, "heliosDac.getStatus error: "+ ofToString(status));// +" " + ofToString(ofGetElapsedTimef()-time));
+                        AsyncLog::log(OF_LOG_NOTICE, LOG_CATEGORY_DAC, "heliosDac.getStatus error: %d", status);// +" " + ofToString(ofGetElapsedTimef()-time));
                         
                         // if the error is -5001 or -1002
                         // then i think it's game over and we have to
-                        // concede defeat.
+                        // reconnect
                         setConnected(false);
+                        break;
                     } else {
                         setConnected(true);
                     }
@@ -301,6 +354,9 @@ void DacHelios :: threadedFunction(){
 				//yield();
 			}
             
+            // if the dac has gone, reconnect next time round
+            if(!connected) continue;
+            
             // We know now that the dac is ready for a new
             // frame.
             
@@ -344,7 +400,7 @@ void DacHelios :: threadedFunction(){
                     result = dacDevice->SendFrame(pps, frameMode ? HELIOS_FLAGS_DEFAULT : HELIOS_FLAGS_SINGLE_MODE, armed ? currentFrame->samples : blankFrame.samples, currentFrame->numSamples);
                     
                     if(result!=HELIOS_SUCCESS) {
-                        ofLogNotice("LaserDacHelios thread SendFrame attempt " + ofToString(attempts) + " failed - error " + ofToString(result));
+                        AsyncLog::log(OF_LOG_NOTICE, LOG_CATEGORY_DAC, "LaserDacHelios thread SendFrame attempt %d failed - error %d", attempts, result);
                     }
                     attempts++;
                     yield();
@@ -354,6 +410,7 @@ void DacHelios :: threadedFunction(){
 				if(result == HELIOS_SUCCESS){ 
 					currentFrame=deleteFrame(currentFrame);
                     setConnected(true);
+                    reconnector.lightRestored(getId());
                 } else {
                     setConnected(false);
                 }
@@ -11,6 +11,9 @@
 #include "ofMain.h"
 #include "ofxLaserDacBase.h"
 #include "HeliosDac.h"
+#include "ofxLaserThreadPolicy.h"
+#include "ofxLaserDacReconnector.h"
+#include "ofxLaserUsbDeviceLocation.h"
 //#include "ofxLaserDacHeliosManager.h"
 
 #define HELIOS_MIN 0
@@ -96,12 +99,24 @@ class DacHelios : public DacBase, ofThread{
     
     string dacName;
     HeliosDacDevice* dacDevice;
-    libusb_device* usbDevice;
+    // whether this is the USB device the DAC is using, safe to call
+    // from any thread (the DAC thread changes it when it reconnects)
+    bool isUsbDevice(libusb_device* usbdevice);
     
 	private:
 	void threadedFunction() override;
 
+    libusb_device* usbDevice = nullptr;
+
 	void setConnected(bool state);
+    // opens and claims the USB device, nullptr if it fails
+    HeliosDacDevice* openDevice(libusb_device* usbdevice);
+    // finds the same Helios again after it's been unplugged or
+    // re-enumerated, keeps trying until it does or the thread stops
+    bool reconnect();
+    
+    DacReconnector reconnector;
+    UsbDeviceLocation usbLocation;
 	
 	/// TEMP
 	ofxLaser::Point lastPoint;
@@ -18,16 +18,109 @@ DacManagerHelios :: DacManagerHelios()  {
         //return false;
     }
     
+    if(UsbHotplugMonitor::isSupported()) {
+        hotplugWatchId = UsbHotplugMonitor::instance()->addWatch(HELIOS_VID, HELIOS_PID, [this](libusb_device* usbdevice, bool arrived) {
+            deviceChanged(usbdevice, arrived);
+        });
+    }
+    if(hotplugWatchId<0) {
+        ofLogNotice("DacManagerHelios - USB hotplug not available, scanning for Helios DACs instead");
+    }
+    
 }
 DacManagerHelios :: ~DacManagerHelios()  {
 
     // TODO wait for all DACs threads to stop
+    if(hotplugWatchId>=0) UsbHotplugMonitor::instance()->removeWatch(hotplugWatchId);
+    for(auto& devicepair : namesByDevice) {
+        libusb_unref_device(devicepair.first);
+    }
+    for(auto& change : pendingDeviceChanges) {
+        libusb_unref_device(change.first);
+    }
     
     libusb_exit(NULL);
 }
 
+void DacManagerHelios :: deviceChanged(libusb_device* usbdevice, bool arrived) {
+    
+    // we don't open the device here because one of our DACs might be
+    // claiming it back on its own thread, processDeviceChanges does it
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    pendingDeviceChanges.push_back(std::make_pair(libusb_ref_device(usbdevice), arrived));
+    // DacAssigner::update picks this up on the next frame
+    dacsChanged = true;
+}
+
+void DacManagerHelios :: processDeviceChanges() {
+    
+    vector<pair<libusb_device*, bool>> changes;
+    {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        std::swap(changes, pendingDeviceChanges);
+    }
+    
+    for(auto& change : changes) {
+        libusb_device* usbdevice = change.first;
+        if(change.second) {
+            string portpath = UsbDeviceLocation::getPortPath(usbdevice);
+            string name;
+            auto portit = namesByPortPath.find(portpath);
+            if((portit!=namesByPortPath.end()) && (dacsById.count(portit->second)>0)) {
+                // one of our DACs reconnecting, it checks the name itself
+                // when it claims the device so we leave it alone
+                name = portit->second;
+            } else {
+                // this is the only time we open the device to get the name
+                name = getHeliosSerialNumber(usbdevice);
+            }
+            if(name!="") {
+                namesByPortPath[portpath] = name;
+                std::lock_guard<std::mutex> lock(deviceMutex);
+                if(namesByDevice.count(usbdevice)==0) libusb_ref_device(usbdevice);
+                namesByDevice[usbdevice] = name;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            auto it = namesByDevice.find(usbdevice);
+            if(it!=namesByDevice.end()) {
+                ofLogNotice("DacManagerHelios - Helios unplugged : "+it->second);
+                libusb_unref_device(it->first);
+                namesByDevice.erase(it);
+            }
+        }
+        libusb_unref_device(usbdevice);
+    }
+}
+
 vector<DacData> DacManagerHelios :: updateDacList(){
     
+    if(hotplugWatchId<0) return scanDacList();
+    
+    processDeviceChanges();
+    
+    vector<DacData> daclist;
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    for(auto& devicepair : namesByDevice) {
+        daclist.push_back(DacData(getType(), devicepair.second));
+    }
+    // a DAC that we're using stays in the list while it reconnects
+    for(auto& dacpair : dacsById) {
+        bool found = false;
+        for(DacData& data : daclist) {
+            if(data.id == dacpair.first) {
+                found = true;
+                break;
+            }
+        }
+        if(!found) daclist.push_back(DacData(getType(), dacpair.first));
+    }
+    return daclist;
+    
+}
+
+vector<DacData> DacManagerHelios :: scanDacList(){
+    
     vector<DacData> daclist;
     
   
@@ -60,7 +153,7 @@ vector<DacData> DacManagerHelios :: updateDacList(){
         for(auto dacpair : dacsById) {
             DacHelios* dac = (DacHelios*)dacpair.second; 
             //dac->dacDevice;
-            if(dac->usbDevice == usbdevice) {
+            if(dac->isUsbDevice(usbdevice)) {
                 cout << "found dac already in use " << dac->dacName << endl;
                 DacData data(getType(), dac->dacName);
                 daclist.push_back(data);
@@ -102,6 +195,30 @@ DacBase* DacManagerHelios :: getAndConnectToDac(const string& id){
         return dac;
     }
     
+    if(hotplugWatchId>=0) {
+        libusb_device* usbdevice = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            for(auto& devicepair : namesByDevice) {
+                if(devicepair.second == id) {
+                    usbdevice = libusb_ref_device(devicepair.first);
+                    break;
+                }
+            }
+        }
+        if(usbdevice==nullptr) return nullptr;
+        
+        dac = new DacHelios();
+        if(!dac->setup(usbdevice)){
+            delete dac;
+            dac = nullptr;
+        } else {
+            dacsById[id] = dac;
+        }
+        libusb_unref_device(usbdevice);
+        return dac;
+    }
+    
     libusb_device **libusb_device_list;
     ssize_t cnt = libusb_get_device_list(NULL, &libusb_device_list);
     ssize_t i = 0;
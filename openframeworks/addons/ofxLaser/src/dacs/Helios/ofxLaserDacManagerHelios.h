@@ -8,6 +8,8 @@
 #pragma once
 #include "ofxLaserDacManagerBase.h"
 #include "ofxLaserDacHelios.h"
+#include "ofxLaserUsbHotplugMonitor.h"
+#include "ofxLaserUsbDeviceLocation.h"
 #include <libusb.h>
 
 #define HELIOS_VID    0x1209
@@ -35,6 +37,26 @@ class DacManagerHelios : public DacManagerBase{
     
     string getHeliosSerialNumber(libusb_device* usbdevice);
 
+    // called by the UsbHotplugMonitor on its thread, queues the change
+    void deviceChanged(libusb_device* usbdevice, bool arrived);
+    // deals with the queued changes, on the manager's thread
+    void processDeviceChanges();
+    // goes through all the USB devices, for when there's no hotplug
+    vector<DacData> scanDacList();
+
+    int hotplugWatchId = -1;
+    // the Helioses that are plugged in and their names, which are only
+    // read when they arrive. Only used with hotplug.
+    std::mutex deviceMutex;
+    map<libusb_device*, string> namesByDevice;
+    // from the hotplug thread, the devices are referenced until they're
+    // processed. Protected by deviceMutex.
+    vector<pair<libusb_device*, bool>> pendingDeviceChanges;
+    // The last name seen on each USB port. If a DAC we're using drops
+    // out, it claims the device back as soon as it re-enumerates so we
+    // don't open it to ask for its name. Only touched on the manager's
+    // thread.
+    map<string, string> namesByPortPath;
     
     
     
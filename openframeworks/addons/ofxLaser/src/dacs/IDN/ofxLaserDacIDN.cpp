@@ -10,270 +10,452 @@
 
 using namespace ofxLaser;
 
-void DacIDN :: setup(string ip) {
-	
-	
-	pps = 30000;
-	newFrameIsBuffered = false;
-	lastFrameTime = 0;
-	lastFrameDuration = 0;
+DacIDN :: DacIDN() {
+    colourShiftImplemented = true;
+    // IDN devices are fast, they can go as quick as we can send
+    maxPointRate = 100000;
+}
+
+DacIDN :: ~DacIDN() {
+    // sends close, stops the thread, closes the socket
+    close();
+
+    cleanUpFramesAndPoints();
+}
+
+void DacIDN :: setup(string _id, string _ip, DacIDNData& data) {
+
+	pps = newPPS = 30000;
+    bufferEstimator.setPointRate(pps);
 	connected = false;
-	counter = 0;
-	
+    ipAddress = _ip;
+    id = _id;
+    idnData = data;
+    sequence = 0;
+    streamPointCount = 0;
+    lastConfigSentTime = 0;
+
 	try {
-		
-		bool success = true;
-		success &= udpConnection.Create();
-		success &= udpConnection.Connect(ip.c_str(),7255);
-		success &= udpConnection.SetNonBlocking(false);
-		if(success) connected = true;
-		else {
-			ofLog(OF_LOG_ERROR, "DacIDN setup failed");
-		}
-	} catch(...) {
-		ofLog(OF_LOG_ERROR, "DacIDN setup failed");
+        Poco::Net::SocketAddress sa(ipAddress, DacIDNConsts::PORT);
+        socket.connect(sa);
+        socket.setBlocking(false);
+        connected = true;
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "DacIDN setup failed - Network error: " +ipAddress+" "+ exc.displayText());
+        connected = false;
+    } catch(...) {
+        ofLog(OF_LOG_ERROR, "DacIDN setup failed - unknown error");
+        connected = false;
 	}
-	
-	
+
 	if(connected) {
-		
 		startThread();
-        auto & thread = getNativeThread();
-        
-#ifndef _MSC_VER
-        // only linux and osx
-        struct sched_param param;
-        param.sched_priority = 89;
-        pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param );
-#else
-        // windows implementation
-        SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_HIGHEST);
-#endif 
 	}
 }
 
-bool DacIDN :: sendFrame(const vector<Point>& points) {
-	
-	pointsToSend.resize(points.size());
-	
-	for(size_t i = 0; i<points.size(); i++) {
-		IDN_point& p1 = pointsToSend[i];
-		Point p2 = points[i];
-		p1.x = ofMap(p2.x,0,800,IDN_MIN, IDN_MAX, true);
-		p1.y = ofMap(p2.y,800,0,IDN_MIN, IDN_MAX, true); // Y is UP in ilda specs
-		p1.r = p2.r;
-		p1.g = p2.g;
-		p1.b = p2.b;
-	}
-	
-	if(lock()) {
-		newFrameIsBuffered = true;
-		unlock();
-	}
+void DacIDN :: setAddress(const string& ip) {
+    while(!lock());
+    newIpAddress = ip;
+    addressChanged = true;
+    unlock();
+}
+
+bool DacIDN :: updateAddress() {
+    // checked every time round the loop so don't lock unless we need to
+    if(!addressChanged) return false;
+    string ip;
+    while(!lock());
+    ip = newIpAddress;
+    addressChanged = false;
+    unlock();
+    if(ip==ipAddress) return false;
     
+    // close the session at the old address, then point the socket at
+    // the new one
+    if(connected) sendClose();
+    ipAddress = ip;
+    idnData.ipAddress = ip;
+    ofLogNotice("DacIDN " + id + " has moved to " + ipAddress);
+    try {
+        socket.close();
+        socket = Poco::Net::DatagramSocket();
+        socket.connect(Poco::Net::SocketAddress(ipAddress, DacIDNConsts::PORT));
+        socket.setBlocking(false);
+        connected = true;
+    } catch (Poco::Exception& exc) {
+        AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "DacIDN :: updateAddress - Network error: %s", exc.displayText().c_str());
+        connected = false;
+    }
     return true;
-};
+}
 
-bool DacIDN :: sendPoints(const vector<Point>& points) {
-	return false;
-};
+void DacIDN :: setMode(DacIDNMode newmode) {
+    if(isThreadRunning()) {
+        ofLogError("DacIDN :: setMode - can't change mode while running");
+        return;
+    }
+    mode = newmode;
+}
 
-bool DacIDN :: setPointsPerSecond(uint32_t newpps) {
-	pps = newpps;
-    return true;
-};
+void DacIDN :: setMaxDatagramSize(int size) {
+    if(lock()) {
+        datagram.setMaxDatagramSize(size);
+        unlock();
+    }
+}
 
 void DacIDN :: threadedFunction(){
-	
+
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "IDN");
+
+    restartStream(ofGetElapsedTimeMicros());
+
 	while(isThreadRunning()) {
-		
-		// wait for the last frame to finish...
-		unsigned long long usWait = lastFrameDuration - (ofGetElapsedTimeMicros() - lastFrameTime);
-		if((int)usWait > 0) sleep(usWait/1000);
-		
-		// and also wait until we have a new frame!
-		while(!newFrameIsBuffered) {
-			//send void to keep alive?
-			// sendVoid();
-			sleep(1);
-		}
-		
-		bufferedPoints.resize(pointsToSend.size());
-		// now we have new frames so send them!
-		while(!lock()); // wait until we have lock
-		lastFrameTime = ofGetElapsedTimeMicros();
-		lastFrameDuration = (((uint64_t)(pointsToSend.size() - 1)) * 1000000ull) / (uint64_t)pps;
-		// copy the points into the buffer
-		for(size_t i = 0; i<pointsToSend.size(); i++) {
-			bufferedPoints[i] = pointsToSend[i];
-		}
-		newFrameIsBuffered = false;
-		unlock();
-		// now it's safe to send the buffered points
-		sendFrameToDac();
+
+        // if it's moved then start a new session at the new address,
+        // the config goes out again with the next message
+        if(updateAddress()) restartStream(ofGetElapsedTimeMicros());
+
+        if(resetFlag) {
+            resetFlag = false;
+            blankPointsToSend = numBlankPointsToSendAfterReset;
+            restartStream(ofGetElapsedTimeMicros());
+        }
+
+        if(newPPS!=pps) {
+            // carry on from where the points we've already sent finish
+            uint64_t streamEndTime = streamStartTime + (streamPointCount * 1000000ull / pps);
+            pps = newPPS;
+            bufferEstimator.setPointRate(pps);
+            restartStream(streamEndTime);
+        }
+
+        bool dataSent = false;
+
+        if((mode == IDN_MODE_FRAME) && frameMode) {
+            dataSent = sendFrameToDac();
+        } else {
+            // IDN doesn't tell us how full the buffer is, so fill up to the
+            // latency and the timestamps will do the rest.
+            int maxPointsToFillBuffer = MIN(pointBufferCapacity-minPacketDataSize, maxLatencyMS * pps /1000);
+            waitUntilReadyToSend(maxPointsToFillBuffer);
+            dataSent = sendPointsToDac();
+        }
+
+        if(!dataSent) {
+            if(frameMode) {
+                // nothing to send, so wait for the next frame rather than spin
+                DacFrame* frame;
+                if(frameThreadChannel.tryReceive(frame, 10)) {
+                    bufferedFrames.push_back(frame);
+                }
+            } else {
+                sleep(1);
+            }
+        }
+
 		yield();
 	}
 }
 
-void DacIDN :: sendFrameToDac() {
-	
-	int pointIndex = 0;
-	int numPointsToSend = bufferedPoints.size();
-	int packetsSent = 0;
-	
-	// 7 bytes in a point, max bytes is 9000
-	// 9000 / 7 is max points, let's say 1200
-	int maxPointsPerFragment = 1200;
-	
-	int fragmentsToSend = ceil((float)numPointsToSend/(float)maxPointsPerFragment);
-	
-	if(verbose) ofLog(OF_LOG_NOTICE, "FRAGMENTS TO SEND : " + ofToString(fragmentsToSend));
-	
-	uint64_t time = ofGetElapsedTimeMicros();
-	
-	for(int i = 0; i<fragmentsToSend; i++){
-		
-		string output;
-		
-		
-		output.push_back(0x40);
-		output.push_back(0x00);
-		output.push_back( (uint8_t)(counter>>8 ) );
-		output.push_back( (uint8_t) counter);
-		
-		//PACKET SIZE minus first four bytes - populate it later!
-		output.push_back(0x00);
-		output.push_back(0x00);
-		
-		bool sendConfig = (i==0);
-		
-		// CNL with configuration bit set (0x80 | 0x40) = 0xC0;
-		// also set with last fragment. Weird.
-		if(sendConfig || (i==fragmentsToSend-1))
-			output.push_back(0xc0);
-		else
-			output.push_back(0x80);
-		
-		// CHUNK TYPE
-		// 0x02 - Frame samples entire frame
-		// 0x03 - Frame samples first fragment
-		// 0xC0 - Frame samples sequel fragment
-		if(fragmentsToSend==1)
-			output.push_back(0x02);
-		else if(i==0)
-			output.push_back(0x03);
-		else
-			output.push_back(0xc0);
-		
-		// TIME STAMP
-		//ofGetSystemTime();
-		output.push_back((uint8_t) ((time+i) >> 24)) ;
-		output.push_back((uint8_t) ((time+i) >> 16)) ;
-		output.push_back((uint8_t) ((time+i) >> 8)) ;
-		output.push_back((uint8_t) (time+i)) ;
-		
-		
-		if(sendConfig) {
-			// CHANNEL CONFIG
-			// NUMBER OF CONFIG WORDS
-			output.push_back(0x04);
-			// SET ROUTING FLAG
-			output.push_back(0x01);
-			// ID (always 0);
-			output.push_back(0x00);
-			// DISCRETE GRAPHICS MODE
-			output.push_back(0x02);
-			
-			// CONF 1 X
-			output.push_back(0x42);
-			output.push_back(0x00);
-			
-			// 16 BIT PRECISION
-			output.push_back(0x40);
-			output.push_back(0x10);
-			
-			// CONF 2 Y
-			output.push_back(0x42);
-			output.push_back(0x10);
-			
-			// 16 BIT PRECISION
-			output.push_back(0x40);
-			output.push_back(0x10);
-			
-			// CONF 3 RED 638nm
-			output.push_back(0x52);
-			output.push_back(0x7e);
-			
-			// CONF 4 GREEN 532nm
-			output.push_back(0x52);
-			output.push_back(0x14);
-			
-			// CONF 5 BLUE
-			output.push_back(0x51);
-			output.push_back(0xcc);
-			
-			// Conf 6... blank zeros???
-			output.push_back(0x00);
-			output.push_back(0x00);
-		
-			
-			
-			// Data header
-			// Flags - if bit 1 is set then frame is played once, otherwise it repeats
-			output.push_back(0x01);
-			
-			// THIS IS WHAT SETS THE POINT SPEED ------------------------
-			// Then it's the frame duration in microseconds, should be number of points/point rate
-			int framemicros = (((uint64_t)(numPointsToSend - 1)) * 1000000ull) / (uint64_t)pps;
-			output.push_back((uint8_t) (framemicros >> 16));
-			output.push_back((uint8_t) (framemicros >> 8));
-			output.push_back((uint8_t) (framemicros));
-		}
-		
-		//DATA START!
-		// now it's points! 7 bytes per point :
-		// XXYYRGB
-		int lastPoint = std::min(maxPointsPerFragment*(i+1), numPointsToSend);
-		for(; pointIndex<lastPoint ; pointIndex++) {
-			IDN_point &point = bufferedPoints[pointIndex];
-			point.getSerialised();
-			output.append(point.serialized, 7);
-			
-		}
-		
-		
-		int messagesize = output.size()-4;
-		output[4] = (uint8_t)(messagesize>>8);
-		output[5] = (uint8_t)messagesize;
-		if(verbose) {
-			ofLog(OF_LOG_NOTICE, ofToString(messagesize));
-		
-			
-			//cout << hex << ((int)(counter>>8 ))  << " " << ((int)(uint8)(counter &0xff ))  << endl;
-			
-			
-			
-			//for (int i = 0; i<output.size() ; i++) {
-			for (int j = 0; j<12 ; j++) {
-
-				cout << std::hex << std::setfill('0') << std::setw(2) << (int)(uint8_t)(output[j]) << " ";
-				if((j<36) && (j%4==3)) cout <<endl;
-				else if((j>=36) && ((j-36)%7==6)) cout <<endl;
-			}
-		//		//cout << hex <<  ntohs(hello) << endl;
-		}
-		counter ++;
-		
-		udpConnection.Send(output.c_str(),output.length());
-		
-		if(verbose) ofLog(OF_LOG_NOTICE, ofToString(output.length()));
-		if(verbose) cout <<endl;
-		
-		
-	}
-	
+void DacIDN :: restartStream(uint64_t timeMicros) {
+    streamStartTime = timeMicros;
+    streamPointCount = 0;
+    // make sure the config goes with the next message
+    lastConfigSentTime = 0;
+}
+
+bool DacIDN :: sendPointsToDac() {
+
+    uint64_t now = ofGetElapsedTimeMicros();
+
+    int bufferFullness = calculateBufferFullnessByTimeSent();
+
+    // if the receiver has run out of points then the timestamps
+    // are in the past, so start them again from now
+    if((bufferFullness==0) && (streamPointCount>0)) {
+        restartStream(now);
+    }
+
+    int minBufferToFill = MIN(maxLatencyMS * pps / 1000, pointBufferCapacity);
+    int spaceInBuffer = MAX(0, pointBufferCapacity - bufferFullness);
+
+    if(!lock()) return false;
+
+    if(frameMode) {
+        int minPointsToQueue = MAX(0, minBufferToFill - bufferFullness - (int)bufferedPoints.size());
+        updateFrameQueue(minPointsToQueue);
+    }
+
+    int totalNumPointsToSend = MIN((int)bufferedPoints.size(), spaceInBuffer);
+    if(totalNumPointsToSend==0) {
+        unlock();
+        return false;
+    }
+
+    // the colour shift delay in point count
+    int colourShiftInPoints =  (float)pps/10000.0f*colourShift ;
+
+    bool success = true;
+    int numPointsLeftToSend = totalNumPointsToSend;
+    IDN_point dacPoint;
+
+    while(numPointsLeftToSend>0) {
+
+        bool sendConfig = (lastConfigSentTime==0) || (now - lastConfigSentTime > configIntervalMicros);
+        int pointsInMessage = MIN(numPointsLeftToSend, datagram.getMaxPointsPerMessage(sendConfig, true));
+
+        uint64_t chunkStartMicros = streamPointCount * 1000000ull / pps;
+        uint64_t chunkEndMicros = (streamPointCount + pointsInMessage) * 1000000ull / pps;
+
+        // the timestamp is 32 bits and wraps every 71 minutes which is fine
+        datagram.startChannelMessage(sequence++, DacIDNConsts::CHUNK_TYPE_LPGRF_WAVE, (uint32_t)(streamStartTime + chunkStartMicros));
+        if(sendConfig) {
+            datagram.addChannelConfig(DacIDNConsts::SERVICE_MODE_GRAPHIC_CONTINUOUS);
+            lastConfigSentTime = now;
+        }
+        datagram.addSampleChunkHeader((uint32_t)(chunkEndMicros - chunkStartMicros), false);
+
+        for(int i = 0; i<pointsInMessage; i++) {
+            if(bufferedPoints.size()>0) {
+                int pointindex = colourShiftInPoints;
+                if(pointindex >= bufferedPoints.size()) pointindex = bufferedPoints.size()-1;
+
+                convertPoint(dacPoint, *bufferedPoints[pointindex], *bufferedPoints[0]);
+
+                PointFactory :: releasePoint(bufferedPoints[0]); // recycling system
+                bufferedPoints.pop_front();
+                lastPointSent = dacPoint;
+            } else {
+                dacPoint = lastPointSent;
+                dacPoint.r = dacPoint.g = dacPoint.b = 0;
+            }
+            datagram.addPoint(dacPoint);
+        }
+        datagram.endChannelMessage();
+
+        if(!sendDatagram()) success = false;
+
+        streamPointCount+=pointsInMessage;
+        numPointsLeftToSend-=pointsInMessage;
+    }
+    unlock();
+
+    if(success) {
+        lastDataSentTime = ofGetElapsedTimeMicros();
+        lastDataSentBufferSize = bufferFullness + totalNumPointsToSend;
+        stateRecorder.recordStateThreadSafe(lastDataSentTime, 1, bufferFullness, 0, totalNumPointsToSend, pps, totalNumPointsToSend * DacIDNConsts::BYTES_PER_POINT);
+    } else {
+        logNotice("DacIDN :: sendPointsToDac failed!");
+    }
+
+    return success;
+}
+
+bool DacIDN :: sendFrameToDac() {
+
+    // wait for the last frame to finish...
+    int64_t microsToWait = (int64_t)frameEndTime - (int64_t)ofGetElapsedTimeMicros();
+    if(microsToWait>0) usleep(microsToWait);
+
+    // ...then send the most recent frame, any others are skipped
+    DacFrame* frame = nullptr;
+    DacFrame* newFrame;
+    if(bufferedFrames.size()>0) {
+        frame = bufferedFrames.back();
+        bufferedFrames.pop_back();
+    }
+    while(frameThreadChannel.tryReceive(newFrame)) {
+        if(frame!=nullptr) {
+            frameRecorder.recordFrameInfoThreadSafe(frame->frameTime, 0, pps, frame->framePoints.size(), 0, true);
+            delete frame;
+        }
+        frame = newFrame;
+    }
+    while(bufferedFrames.size()>0) {
+        frameRecorder.recordFrameInfoThreadSafe(bufferedFrames[0]->frameTime, 0, pps, bufferedFrames[0]->framePoints.size(), 0, true);
+        delete bufferedFrames[0];
+        bufferedFrames.pop_front();
+    }
+
+    if((frame==nullptr) || (frame->framePoints.size()==0)) {
+        if(frame!=nullptr) delete frame;
+        return false;
+    }
+
+    vector<ofxLaser::Point*>& points = frame->framePoints;
+    int numPointsToSend = points.size();
+    uint64_t now = ofGetElapsedTimeMicros();
+    uint32_t frameMicros = (uint32_t)(((uint64_t)numPointsToSend * 1000000ull) / (uint64_t)pps);
+
+    bool sendConfig = (lastConfigSentTime==0) || (now - lastConfigSentTime > configIntervalMicros);
+    int colourShiftInPoints =  (float)pps/10000.0f*colourShift ;
+
+    bool success = true;
+    IDN_point dacPoint;
+    int pointIndex = 0;
+    bool firstFragment = true;
+
+    if(!lock()) {
+        delete frame;
+        return false;
+    }
+    while(pointIndex<numPointsToSend) {
+
+        int maxPoints = datagram.getMaxPointsPerMessage(firstFragment && sendConfig, firstFragment);
+        int pointsInMessage = MIN(numPointsToSend - pointIndex, maxPoints);
+        bool lastFragment = (pointIndex + pointsInMessage >= numPointsToSend);
+
+        uint8_t chunkType;
+        if(firstFragment) {
+            chunkType = lastFragment ? DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME : DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME_FIRST;
+        } else {
+            chunkType = DacIDNConsts::CHUNK_TYPE_LPGRF_FRAME_SEQUEL;
+        }
+        // every fragment of a frame has the same timestamp
+        datagram.startChannelMessage(sequence++, chunkType, (uint32_t)now);
+
+        if(firstFragment) {
+            if(sendConfig) {
+                datagram.addChannelConfig(DacIDNConsts::SERVICE_MODE_GRAPHIC_DISCRETE);
+                lastConfigSentTime = now;
+            }
+            // the receiver keeps playing the frame until the next one
+            datagram.addSampleChunkHeader(frameMicros, false);
+        } else if(lastFragment) {
+            datagram.setLastFragment();
+        }
+
+        for(int i = 0; i<pointsInMessage; i++, pointIndex++) {
+            // the colour shift wraps around as the frame repeats
+            convertPoint(dacPoint, *points[(pointIndex + colourShiftInPoints) % numPointsToSend], *points[pointIndex]);
+            datagram.addPoint(dacPoint);
+        }
+        datagram.endChannelMessage();
+
+        if(!sendDatagram()) success = false;
+        firstFragment = false;
+    }
+    if(numPointsToSend>0) lastPointSent = dacPoint;
+    unlock();
+
+    frameRecorder.recordFrameInfoThreadSafe(frame->frameTime, now, pps, numPointsToSend, 1, false);
+    delete frame;
+
+    frameEndTime = now + frameMicros;
+    lastDataSentTime = now;
+    lastDataSentBufferSize = numPointsToSend;
+
+    return success;
+}
+
+inline void DacIDN :: convertPoint(IDN_point& dacPoint, ofxLaser::Point& laserPoint, ofxLaser::Point& colourPoint) {
+
+    dacPoint.x = ofMap(armed ? laserPoint.x : 400, 0, 800, IDN_MIN, IDN_MAX, true);
+    dacPoint.y = ofMap(armed ? laserPoint.y : 400, 800, 0, IDN_MIN, IDN_MAX, true); // Y is UP in ilda specs
+
+    if(!armed || blankPointsToSend>0) {
+        dacPoint.r = dacPoint.g = dacPoint.b = 0;
+        if(blankPointsToSend>0) blankPointsToSend--;
+    } else {
+        dacPoint.r = colourPoint.r;
+        dacPoint.g = colourPoint.g;
+        dacPoint.b = colourPoint.b;
+    }
+}
+
+bool DacIDN :: sendDatagram() {
+
+    int length = datagram.size();
+    int numBytesSent = 0;
+    bool failed = false;
+
+    try {
+        numBytesSent = socket.sendBytes(datagram.getBuffer(), length);
+    } catch (Poco::Exception& exc) {
+        if(verbose) AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "DacIDN :: sendDatagram - Network error: %s", exc.displayText().c_str());
+        failed = true;
+    } catch (...) {
+        if(verbose) AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "DacIDN :: sendDatagram - unspecified error");
+        failed = true;
+    }
+    if(numBytesSent!=length) {
+        failed = true;
+    }
+    // UDP so nothing to reconnect, the status will show red
+    // until the sends start working again
+    connected = !failed;
+    return !failed;
+}
+
+bool DacIDN :: sendClose() {
+    // closes the channel and the session
+    datagram.setCommand(DacIDNConsts::CMD_RT_CNLMSG_CLOSE, sequence++);
+    return sendDatagram();
+}
+
+string DacIDN :: getId() {
+	return "IDN "+id;
+}
+
+int DacIDN :: getStatus() {
+    if(!connected) return OFXLASER_DACSTATUS_ERROR;
+    // if we haven't sent anything for a second then there's no data coming in
+    if(ofGetElapsedTimeMicros() - lastDataSentTime > 1000000) return OFXLASER_DACSTATUS_WARNING;
+    return OFXLASER_DACSTATUS_GOOD;
+}
+
+bool DacIDN :: setPointsPerSecond(uint32_t newpps) {
+    if(newpps>maxPointRate) newpps = maxPointRate;
+    if(!isThreadRunning()){
+        pps = newPPS = newpps;
+        bufferEstimator.setPointRate(pps);
+        return true;
+    } else {
+        if(lock()) {
+            newPPS = newpps;
+            unlock();
+            return true;
+        }
+        return false;
+    }
+}
+
+int DacIDN :: getMaxPointBufferSize() {
+    return pointBufferCapacity;
+}
+
+void DacIDN :: reset() {
+    if(lock()) {
+        resetFlag = true;
+        unlock();
+    }
+}
+
+void DacIDN :: closeWhileRunning() {
+    if(!connected) return;
+    waitForThread();
+    if(lock()) {
+        sendClose();
+        socket.close();
+        unlock();
+    }
 }
 
 void DacIDN :: close() {
-	udpConnection.Close();
+
+    if(isThreadRunning()) {
+        // also stops the thread :
+        waitForThread(true, 1000); // 1 second time out
+    }
+    if(connected) {
+        sendClose();
+        connected = false;
+    }
+    socket.close();
+}
+
+const vector<ofAbstractParameter*>& DacIDN :: getDisplayData() {
+    return displayData;
 }
@@ -7,82 +7,119 @@
 //
 
 #pragma once
-#include "ofMain.h"
-#include "ofxLaserDacBase.h"
-#include "ofxNetwork.h"
+#include "ofxLaserDacBaseThreaded.h"
+#include "ofxLaserDacIDNConsts.h"
+#include "ofxLaserDacIDNDatagram.h"
+#include "ofxLaserDacIDNData.h"
+
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/NetException.h"
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#endif
 
 #define IDN_MIN -32768
 #define IDN_MAX 32767
 
 namespace ofxLaser {
-	
-class IDN_point {
-	public :
-	
-	char* getSerialised() {
-		
-		serialized[0] = (uint8_t) (x >> 8);
-		serialized[1] = (uint8_t) (x);
-		serialized[2] = (uint8_t) (y >> 8);
-		serialized[3] = (uint8_t) (y);
-		serialized[4] = r;
-		serialized[5] = g;
-		serialized[6] = b;
-		
-		return (char*) &serialized;
-	}
-	
-	char serialized[7];
-	
-	uint16_t x;
-	uint16_t y;
-	uint8_t r;
-	uint8_t g;
-	uint8_t b;
+
+enum DacIDNMode {
+    // points are streamed continuously as timestamped wave chunks
+    // like every other DAC. This is the default.
+    IDN_MODE_WAVE,
+    // every frame is sent whole and the receiver repeats it until
+    // the next one arrives
+    IDN_MODE_FRAME,
 };
 
-	
-class DacIDN : public DacBase, ofThread {
-	
+class DacIDN : public DacBaseThreaded {
+
 	public:
-	void setup(string ip);
-	
-	bool sendFrame(const vector<Point>& points) override;
-	bool sendPoints(const vector<Point>& points) override;
+    DacIDN();
+    ~DacIDN();
+
+	void setup(string id, string ip, DacIDNData& data);
+    // if the device has moved to a new IP address, the thread starts
+    // sending there instead. Safe to call from any thread.
+    void setAddress(const string& ip);
+
 	bool setPointsPerSecond(uint32_t pps) override;
-	
-	string getId() override {
-		return "IDN";
-	}
-	
-	// TODO return relevant colour 
-//	ofColor getStatusColour() override {
-//		return connected ? ofColor::green :  ofColor::red;
-//	}
-	
-	void close() override ;
-	
-	protected:
 
-	private:
+	string getId() override;
+    int getStatus() override;
+    const vector<ofAbstractParameter*>& getDisplayData() override;
+
+    void closeWhileRunning();
+	void close() override;
+    void reset() override;
+
+    int getMaxPointBufferSize() override;
+
+    // call before setup
+    void setMode(DacIDNMode mode);
+    // keep under the network MTU (default 1454)
+    void setMaxDatagramSize(int size);
+
+    DacIDNData idnData;
+
+	protected:
 
 	void threadedFunction() override;
-	
-	void sendFrameToDac();
-
-	ofxUDPManager udpConnection;
-
-	uint32_t pps;
-	bool connected;
-	bool newFrameIsBuffered;
-	uint64_t lastFrameTime;
-	uint64_t lastFrameDuration;
-	
-	vector<IDN_point> pointsToSend;
-	deque<IDN_point> bufferedPoints;
-	uint16_t counter ;
-
-	const bool verbose = false; 
+
+    // wave mode, sends as many points as are needed to keep
+    // the receiver's buffer at the latency level
+	bool sendPointsToDac();
+    // frame mode, sends the most recent frame in fragments
+    bool sendFrameToDac();
+    bool sendDatagram();
+    bool sendClose();
+
+    // copies a laser point into a dac point, applying the armed state
+    // and the colour shift
+    inline void convertPoint(IDN_point& dacPoint, ofxLaser::Point& laserPoint, ofxLaser::Point& colourPoint);
+
+    DacIDNDatagram datagram;
+	Poco::Net::DatagramSocket socket;
+
+    DacIDNMode mode = IDN_MODE_WAVE;
+
+    // starts the timestamps again from now, for when the receiver
+    // has run dry or the point rate changes
+    void restartStream(uint64_t timeMicros);
+
+    uint16_t sequence = 0;
+    // chunk timestamps are streamStartTime plus the time it takes to
+    // play all the points sent since then, so the receiver can play
+    // them out at the right rate. Counting points rather than adding
+    // up durations means rounding errors never accumulate.
+    uint64_t streamStartTime = 0;
+    uint64_t streamPointCount = 0;
+    // when the last frame sent in frame mode will have finished
+    uint64_t frameEndTime = 0;
+    // the channel config is sent with the first message and then
+    // periodically so a receiver can join at any time
+    uint64_t lastConfigSentTime = 0;
+    uint64_t configIntervalMicros = 200000;
+
+    // wave mode has no buffer feedback so this is how far ahead
+    // of the receiver we let ourselves get
+    int pointBufferCapacity = 4096;
+
+    IDN_point lastPointSent;
+    int blankPointsToSend = 0;
+    int numBlankPointsToSendAfterReset = 10;
+
+    string ipAddress;
+    string id;
+    bool connected = false;
+    
+    // from setAddress, protected by the mutex
+    string newIpAddress;
+    std::atomic<bool> addressChanged{false};
+    // called on the DAC thread, returns true if the address changed
+    bool updateAddress();
 
 };
 
@@ -0,0 +1,79 @@
+//
+//  ofxLaserDacIDNConsts.h
+//  ofxLaser
+//
+#pragma once
+#include <cstdint>
+
+namespace ofxLaser {
+class DacIDNConsts {
+    public :
+
+    // From the ILDA Digital Network specs (IDN-Hello and IDN-Stream)
+    // https://www.ilda.com/technical.htm
+    //
+    // Everything goes over UDP to port 7255. Every packet starts with
+    // a 4 byte header : command, flags, and a 16 bit sequence number
+    // (all multi-byte values are big endian)
+    static const int PORT = 7255;
+
+    static const uint8_t CMD_VOID = 0x00;
+    static const uint8_t CMD_PING_REQUEST = 0x08;
+    static const uint8_t CMD_PING_RESPONSE = 0x09;
+    // broadcast a scan request and every IDN device replies with its
+    // unit ID and host name
+    static const uint8_t CMD_SCAN_REQUEST = 0x10;
+    static const uint8_t CMD_SCAN_RESPONSE = 0x11;
+    static const uint8_t CMD_SERVICEMAP_REQUEST = 0x12;
+    static const uint8_t CMD_SERVICEMAP_RESPONSE = 0x13;
+    // realtime channel messages, this is where the points go
+    static const uint8_t CMD_RT_CNLMSG = 0x40;
+    static const uint8_t CMD_RT_CNLMSG_ACKREQ = 0x41;
+    static const uint8_t CMD_RT_CNLMSG_CLOSE = 0x44;
+
+    // scan response : structSize, protocolVersion, status, reserved,
+    // unitID[16], hostName[20]
+    static const int SCAN_RESPONSE_SIZE = 40;
+    static const int UNIT_ID_LENGTH = 16;
+    static const int HOST_NAME_LENGTH = 20;
+
+    // channel message content ID
+    static const uint16_t CONTENT_ID_CHANNEL_MSG = 0x8000;
+    // config is included (or for sequel fragments, this is the last one)
+    static const uint16_t CONTENT_ID_CONFIG_LSTFRG = 0x4000;
+    static const uint16_t CONTENT_ID_CHANNEL_MASK = 0x3F00;
+    static const uint16_t CONTENT_ID_CHUNK_TYPE_MASK = 0x00FF;
+
+    // chunk types
+    static const uint8_t CHUNK_TYPE_LPGRF_WAVE = 0x01;
+    static const uint8_t CHUNK_TYPE_LPGRF_FRAME = 0x02;
+    static const uint8_t CHUNK_TYPE_LPGRF_FRAME_FIRST = 0x03;
+    static const uint8_t CHUNK_TYPE_LPGRF_FRAME_SEQUEL = 0xC0;
+
+    // channel configuration flags
+    static const uint8_t CONFIG_FLAG_ROUTING = 0x01;
+    static const uint8_t CONFIG_FLAG_CLOSE = 0x02;
+
+    // service modes
+    static const uint8_t SERVICE_MODE_GRAPHIC_CONTINUOUS = 0x01;
+    static const uint8_t SERVICE_MODE_GRAPHIC_DISCRETE = 0x02;
+
+    // sample chunk flags, if set the frame is played once
+    static const uint8_t CHUNK_FLAG_ONCE = 0x01;
+
+    // sizes of the bits of a channel message
+    static const int PACKET_HEADER_SIZE = 4;
+    static const int CHANNEL_MSG_HEADER_SIZE = 8;
+    static const int CONFIG_HEADER_SIZE = 4;
+    static const int CHUNK_HEADER_SIZE = 4;
+    // XXYYRGB
+    static const int BYTES_PER_POINT = 7;
+
+    // 1500 byte ethernet MTU minus IP and UDP headers with some room
+    // to spare for VPNs and tunnels
+    static const int DEFAULT_MAX_DATAGRAM_SIZE = 1454;
+    // the biggest datagram we'll ever make (jumbo frames)
+    static const int MAX_DATAGRAM_SIZE = 8960;
+
+};
+}
@@ -0,0 +1,19 @@
+//
+//  ofxLaserDacIDNData.h
+//  ofxLaser
+//
+#pragma once
+
+
+namespace ofxLaser {
+
+// from the IDN-Hello scan response
+struct DacIDNData {
+    string unitId;      // hex string of the unit ID
+    string hostName;
+    string ipAddress;
+    int protocolVersion;
+    int status;
+    float lastUpdateTime;
+};
+}
@@ -0,0 +1,96 @@
+//
+//  ofxLaserDacIDNDatagram.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacIDNDatagram.h"
+
+using namespace ofxLaser;
+
+DacIDNDatagram :: DacIDNDatagram() {
+    clear();
+}
+
+void DacIDNDatagram :: clear() {
+    index = 0;
+    numPoints = 0;
+    channelMessageStart = 0;
+    contentId = 0;
+}
+
+void DacIDNDatagram :: setCommand(uint8_t command, uint16_t sequence) {
+    clear();
+    appendUInt8(command);
+    appendUInt8(0x00); // flags
+    appendUInt16(sequence);
+}
+
+void DacIDNDatagram :: startChannelMessage(uint16_t sequence, uint8_t chunkType, uint32_t timestampMicros, uint8_t channelId) {
+
+    setCommand(DacIDNConsts::CMD_RT_CNLMSG, sequence);
+
+    channelMessageStart = index;
+    contentId = DacIDNConsts::CONTENT_ID_CHANNEL_MSG | ((channelId<<8) & DacIDNConsts::CONTENT_ID_CHANNEL_MASK) | chunkType;
+
+    appendUInt16(0); // total size, filled in by endChannelMessage
+    appendUInt16(contentId);
+    appendUInt32(timestampMicros);
+}
+
+void DacIDNDatagram :: addChannelConfig(uint8_t serviceMode, bool closeChannel) {
+
+    contentId |= DacIDNConsts::CONTENT_ID_CONFIG_LSTFRG;
+    setUInt16At(channelMessageStart + 2, contentId);
+
+    // X, Y, R, G, B plus the precision tag for X and Y, padded to
+    // a whole number of 32 bit words
+    appendUInt8(4); // number of 32 bit words of descriptors
+    appendUInt8(DacIDNConsts::CONFIG_FLAG_ROUTING | (closeChannel ? DacIDNConsts::CONFIG_FLAG_CLOSE : 0));
+    appendUInt8(0x00); // service ID, 0 is the default service
+    appendUInt8(serviceMode);
+
+    appendUInt16(0x4200); // X
+    appendUInt16(0x4010); // 16 bit precision
+    appendUInt16(0x4210); // Y
+    appendUInt16(0x4010); // 16 bit precision
+    appendUInt16(0x527E); // red 638nm
+    appendUInt16(0x5214); // green 532nm
+    appendUInt16(0x51CC); // blue 460nm
+    appendUInt16(0x0000); // void, for padding
+}
+
+void DacIDNDatagram :: addSampleChunkHeader(uint32_t durationMicros, bool once) {
+    appendUInt8(once ? DacIDNConsts::CHUNK_FLAG_ONCE : 0x00);
+    // 24 bits so max duration is about 16 seconds
+    appendUInt24(MIN(durationMicros, 0xFFFFFFu));
+}
+
+void DacIDNDatagram :: setLastFragment() {
+    contentId |= DacIDNConsts::CONTENT_ID_CONFIG_LSTFRG;
+    setUInt16At(channelMessageStart + 2, contentId);
+}
+
+void DacIDNDatagram :: endChannelMessage() {
+    // the size is everything after the packet header
+    setUInt16At(channelMessageStart, (uint16_t)(index - channelMessageStart));
+}
+
+int DacIDNDatagram :: getSpaceForPoints() {
+    return MAX(0, (maxDatagramSize - (int)index) / DacIDNConsts::BYTES_PER_POINT);
+}
+
+int DacIDNDatagram :: getMaxPointsPerMessage(bool withConfig, bool withChunkHeader) {
+    int headerSize = DacIDNConsts::PACKET_HEADER_SIZE + DacIDNConsts::CHANNEL_MSG_HEADER_SIZE;
+    if(withConfig) headerSize += DacIDNConsts::CONFIG_HEADER_SIZE + 16;
+    if(withChunkHeader) headerSize += DacIDNConsts::CHUNK_HEADER_SIZE;
+    return (maxDatagramSize - headerSize) / DacIDNConsts::BYTES_PER_POINT;
+}
+
+void DacIDNDatagram :: setMaxDatagramSize(int size) {
+    maxDatagramSize = MAX(256, MIN(size, DacIDNConsts::MAX_DATAGRAM_SIZE));
+}
+
+void DacIDNDatagram :: setUInt16At(size_t position, uint16_t n) {
+    buffer[position] = n>>8;
+    buffer[position+1] = n&0xff;
+}
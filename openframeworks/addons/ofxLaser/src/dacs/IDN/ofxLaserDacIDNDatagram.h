@@ -0,0 +1,103 @@
+//
+//  ofxLaserDacIDNDatagram.h
+//  ofxLaser
+//
+// Builds IDN packets into a fixed buffer so nothing is allocated
+// while streaming. A channel message is made like this :
+//
+//  startChannelMessage(...)
+//  addChannelConfig(...)      (optional)
+//  addSampleChunkHeader(...)  (not for sequel fragments)
+//  addPoint(...) x n
+//  endChannelMessage()
+//
+
+#pragma once
+#include "ofxLaserDacIDNConsts.h"
+#include "ofMain.h"
+
+namespace ofxLaser {
+
+class IDN_point {
+    public :
+    int16_t x;
+    int16_t y;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+class DacIDNDatagram {
+
+    public :
+
+    DacIDNDatagram();
+
+    void clear();
+    // just the packet header, for scan requests, close etc
+    void setCommand(uint8_t command, uint16_t sequence);
+
+    void startChannelMessage(uint16_t sequence, uint8_t chunkType, uint32_t timestampMicros, uint8_t channelId = 0);
+    // serviceMode is SERVICE_MODE_GRAPHIC_CONTINUOUS or SERVICE_MODE_GRAPHIC_DISCRETE
+    void addChannelConfig(uint8_t serviceMode, bool closeChannel = false);
+    void addSampleChunkHeader(uint32_t durationMicros, bool once);
+    // for sequel fragments, marks this as the last fragment of the frame
+    void setLastFragment();
+    inline void addPoint(const IDN_point& p) {
+        appendUInt16(p.x);
+        appendUInt16(p.y);
+        buffer[index++] = p.r;
+        buffer[index++] = p.g;
+        buffer[index++] = p.b;
+        numPoints++;
+    }
+    // fills in the message size
+    void endChannelMessage();
+
+    // how many more points fit in this datagram
+    int getSpaceForPoints();
+    // how many points fit in a message with the given headers
+    int getMaxPointsPerMessage(bool withConfig, bool withChunkHeader);
+
+    // clamped between 256 and MAX_DATAGRAM_SIZE
+    void setMaxDatagramSize(int size);
+    int getMaxDatagramSize() { return maxDatagramSize; };
+
+    uint8_t* getBuffer() { return &buffer[0]; };
+    size_t size() { return index; };
+    int getNumPoints() { return numPoints; };
+
+    protected :
+
+    inline void appendUInt8(uint8_t n) {
+        buffer[index++] = n;
+    }
+    inline void appendUInt16(uint16_t n) {
+        buffer[index++] = n>>8;
+        buffer[index++] = n&0xff;
+    }
+    inline void appendUInt24(uint32_t n) {
+        buffer[index++] = (n>>16) & 0xff;
+        buffer[index++] = (n>>8) & 0xff;
+        buffer[index++] = n & 0xff;
+    }
+    inline void appendUInt32(uint32_t n) {
+        buffer[index++] = (n>>24) & 0xff;
+        buffer[index++] = (n>>16) & 0xff;
+        buffer[index++] = (n>>8) & 0xff;
+        buffer[index++] = n & 0xff;
+    }
+    void setUInt16At(size_t position, uint16_t n);
+
+    uint8_t buffer[DacIDNConsts::MAX_DATAGRAM_SIZE];
+    size_t index = 0;
+    int maxDatagramSize = DacIDNConsts::DEFAULT_MAX_DATAGRAM_SIZE;
+    int numPoints = 0;
+
+    // where the channel message starts and where its content id is
+    size_t channelMessageStart = 0;
+    uint16_t contentId = 0;
+
+};
+
+}
@@ -0,0 +1,226 @@
+//
+//  ofxLaserDacManagerIDN.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacManagerIDN.h"
+
+using namespace ofxLaser;
+
+DacManagerIDN :: DacManagerIDN()  {
+
+    try {
+        // any port will do, the replies come back to wherever
+        // the request came from
+        scanSocket.bind(Poco::Net::SocketAddress("0.0.0.0", 0), true);
+        scanSocket.setBroadcast(true);
+        scanSocket.setBlocking(false);
+        connected = true;
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "DacManagerIDN setup failed - Network error: " + exc.displayText());
+        connected = false;
+    } catch(...){
+        ofLog(OF_LOG_ERROR, "DacManagerIDN setup failed - unknown error");
+        connected = false;
+    }
+
+    if(connected) startThread();
+}
+
+DacManagerIDN :: ~DacManagerIDN()  {
+    exit();
+}
+
+void DacManagerIDN :: threadedFunction() {
+
+    const int packetSize = 128; // scan responses are 44 bytes
+    uint8_t udpMessage[packetSize];
+    Poco::Timespan pollTime(100000); // 100ms
+
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DISCOVERY, "IDN discovery");
+
+    while(isThreadRunning()) {
+
+        sendScanRequest();
+
+        // collect the responses for a second
+        float sendTime = ofGetElapsedTimef();
+        while(isThreadRunning() && (ofGetElapsedTimef()-sendTime<1)) {
+
+            try {
+                if(!scanSocket.poll(pollTime, Poco::Net::Socket::SELECT_READ)) continue;
+
+                Poco::Net::SocketAddress sender;
+                int numBytesReceived = scanSocket.receiveFrom(udpMessage, packetSize, sender);
+                if(numBytesReceived>0) {
+                    processScanResponse(udpMessage, numBytesReceived, sender.host().toString());
+                }
+            } catch (Poco::Exception& exc) {
+                ofLog(OF_LOG_ERROR,  "DacManagerIDN receive failed - " + exc.displayText());
+                sleep(100);
+            }
+        }
+
+        // delete devices we haven't seen for a while
+        if(lock()) {
+            for (auto it = idnDataById.cbegin(); it != idnDataById.cend(); )  {
+                if ((ofGetElapsedTimef() - it->second.lastUpdateTime)>expiryTime){
+                    ofLogNotice("DacManagerIDN - removing IDN device "+ it->first);
+                    idnDataById.erase(it++);
+                    dacsChanged = true;
+                } else {
+                    ++it;
+                }
+            }
+            unlock();
+        }
+    }
+}
+
+void DacManagerIDN :: sendScanRequest() {
+
+    scanDatagram.setCommand(DacIDNConsts::CMD_SCAN_REQUEST, scanSequence++);
+
+    // network interfaces come and go (eg when a cable is plugged in)
+    if((lastInterfaceCheckTime==0) || (ofGetElapsedTimef()-lastInterfaceCheckTime > 5)) {
+        networkInterfaces = NetworkInterfaces::getIPv4Interfaces();
+        lastInterfaceCheckTime = ofGetElapsedTimef();
+    }
+
+    try {
+        scanSocket.sendTo(scanDatagram.getBuffer(), scanDatagram.size(), Poco::Net::SocketAddress("255.255.255.255", DacIDNConsts::PORT));
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_VERBOSE,  "DacManagerIDN scan broadcast failed - " + exc.displayText());
+    }
+    for(NetworkInterfaceData& networkInterface : networkInterfaces) {
+        try {
+            scanSocket.sendTo(scanDatagram.getBuffer(), scanDatagram.size(), Poco::Net::SocketAddress(networkInterface.broadcastAddress, DacIDNConsts::PORT));
+        } catch (Poco::Exception& exc) {
+            ofLog(OF_LOG_VERBOSE,  "DacManagerIDN scan broadcast failed on " + networkInterface.name + " - " + exc.displayText());
+        }
+    }
+    if(scanLocalhost) {
+        try {
+            scanSocket.sendTo(scanDatagram.getBuffer(), scanDatagram.size(), Poco::Net::SocketAddress("127.0.0.1", DacIDNConsts::PORT));
+        } catch (Poco::Exception& exc) {
+            ofLog(OF_LOG_VERBOSE,  "DacManagerIDN localhost scan failed - " + exc.displayText());
+        }
+    }
+}
+
+bool DacManagerIDN :: processScanResponse(uint8_t* data, int length, const string& ipAddress) {
+
+    if(length < DacIDNConsts::PACKET_HEADER_SIZE + DacIDNConsts::SCAN_RESPONSE_SIZE) return false;
+    if(data[0] != DacIDNConsts::CMD_SCAN_RESPONSE) return false;
+
+    uint8_t* response = data + DacIDNConsts::PACKET_HEADER_SIZE;
+    // the struct size lets the protocol grow, we only need the first 40 bytes
+    int structSize = response[0];
+    if(structSize < DacIDNConsts::SCAN_RESPONSE_SIZE) return false;
+
+    DacIDNData idnData;
+    idnData.protocolVersion = response[1];
+    idnData.status = response[2];
+    idnData.ipAddress = ipAddress;
+    idnData.lastUpdateTime = ofGetElapsedTimef();
+
+    // the first byte of the unit ID is its length, the rest are
+    // the category and the ID itself (usually a MAC address)
+    uint8_t* unitId = response + 4;
+    int unitIdLength = MIN((int)unitId[0], DacIDNConsts::UNIT_ID_LENGTH-1);
+    char hex[3];
+    for(int i = 1; i<=unitIdLength; i++) {
+        snprintf(hex, sizeof(hex), "%02X", unitId[i]);
+        idnData.unitId += hex;
+    }
+    if(idnData.unitId.empty()) idnData.unitId = ipAddress;
+
+    char* hostName = (char*)(response + 4 + DacIDNConsts::UNIT_ID_LENGTH);
+    idnData.hostName = string(hostName, strnlen(hostName, DacIDNConsts::HOST_NAME_LENGTH));
+
+    const string& id = idnData.unitId;
+    if(lock()) {
+        if(idnDataById.find(id) == idnDataById.end()) {
+            ofLogNotice("DacManagerIDN - adding IDN device "+ id) << " " << idnData.hostName << " " << ipAddress;
+            dacsChanged = true;
+        } else if(idnDataById[id].ipAddress != ipAddress) {
+            dacsChanged = true;
+        }
+        idnDataById[id] = idnData;
+        unlock();
+    }
+    return true;
+}
+
+vector<DacData> DacManagerIDN :: updateDacList(){
+
+    vector<DacData> daclist;
+
+    if(lock()) {
+        for(auto& idnpair : idnDataById) {
+            DacIDNData& idnData = idnpair.second;
+            daclist.emplace_back(getType(), idnData.unitId, idnData.ipAddress);
+            
+            // if we're using it, make sure it knows where it is now
+            DacIDN* dac = (DacIDN*)getDacById(idnData.unitId);
+            if(dac!=nullptr) dac->setAddress(idnData.ipAddress);
+        }
+        unlock();
+    }
+    return daclist;
+}
+
+DacBase* DacManagerIDN :: getAndConnectToDac(const string& id){
+
+    // returns a dac - if failed returns nullptr.
+
+    DacIDN* dac = (DacIDN*) getDacById(id);
+    if(dac!=nullptr) {
+        ofLogNotice("DacManagerIDN :: getAndConnectToDac(...) - Already a dac made with id "+ofToString(id));
+        return dac;
+    }
+
+    DacIDNData idnData;
+    bool found = false;
+    if(lock()) {
+        if(idnDataById.find(id)!=idnDataById.end()) {
+            idnData = idnDataById.at(id);
+            found = true;
+        }
+        unlock();
+    }
+    if(!found) return nullptr;
+
+    dac = new DacIDN();
+    dac->setup(id, idnData.ipAddress, idnData);
+    dacsById[id] = dac;
+    return dac;
+}
+
+bool DacManagerIDN :: disconnectAndDeleteDac(const string& id){
+
+    DacIDN* dac = (DacIDN*)getDacById(id);
+    if(dac==nullptr) {
+        ofLogError("DacManagerIDN::disconnectAndDeleteDac("+id+") - dac not found");
+        return false;
+    }
+
+    dac->close();
+    auto it=dacsById.find(id);
+    dacsById.erase(it);
+    delete dac;
+    return true;
+}
+
+void DacManagerIDN :: exit() {
+    // stop scanning and let go of the socket
+    if(isThreadRunning()) {
+        stopThread();
+        waitForThread();
+    }
+    if(connected) {
+        scanSocket.close();
+        connected = false;
+    }
+}
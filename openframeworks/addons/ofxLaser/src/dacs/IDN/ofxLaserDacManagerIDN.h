@@ -0,0 +1,64 @@
+//
+//  ofxLaserDacManagerIDN.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofxLaserDacManagerBase.h"
+#include "ofxLaserDacBase.h"
+#include "ofxLaserDacIDN.h"
+#include "ofThread.h"
+#include "ofxLaserThreadPolicy.h"
+#include "ofxLaserNetworkInterfaces.h"
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+
+
+namespace ofxLaser {
+
+// Finds IDN devices using IDN-Hello. A scan request is broadcast once
+// a second on every network interface and every device replies with
+// its unit ID and host name.
+class DacManagerIDN : public DacManagerBase, ofThread {
+
+    public :
+    DacManagerIDN();
+    ~DacManagerIDN();
+
+    virtual vector<DacData> updateDacList() override;
+    virtual DacBase* getAndConnectToDac(const string& id) override;
+    virtual bool disconnectAndDeleteDac(const string& id) override;
+    virtual string getType() override {
+        return "IDN";
+    }
+    virtual void exit() override;
+
+    void threadedFunction() override;
+
+    protected :
+
+    void sendScanRequest();
+    bool processScanResponse(uint8_t* data, int length, const string& ipAddress);
+
+    bool connected = false;
+    Poco::Net::DatagramSocket scanSocket;
+    DacIDNDatagram scanDatagram;
+    uint16_t scanSequence = 0;
+
+    map<string, DacIDNData> idnDataById;
+
+    // 255.255.255.255 only goes out of one interface so we also send to
+    // the broadcast address of each one
+    vector<NetworkInterfaceData> networkInterfaces;
+    float lastInterfaceCheckTime = 0;
+
+    // also scan localhost, broadcasts don't always make it to
+    // receivers bound to the loopback interface
+    bool scanLocalhost = true;
+    // how long before a DAC that stops replying is removed
+    float expiryTime = 3;
+
+};
+}
@@ -56,6 +56,21 @@ bool DacLaserDock::setup(libusb_device* usbdevice){
     // WE ARE GOOD TO GO!!!!
     
     connected = true;
+    usbLocation.set(usbdevice);
+    
+    initDevice();
+    
+    serialNumber.setName("Serial");
+    serialNumber.set(dacDevice->serial_number());
+    ofLogNotice("DacLaserdock : connecting to : " + ofToString(serialNumber));
+    
+    // TODO if failed, then delete device and don't start the thread
+    
+    startThread();
+    return true;
+}
+
+void DacLaserDock :: initDevice() {
     
     dacDevice->max_dac_rate(&maxPPS);// returns false if unsuccessful, should probably check that
     
@@ -105,15 +120,45 @@ bool DacLaserDock::setup(libusb_device* usbdevice){
     LaserdockSample * samples = (LaserdockSample*) calloc(sizeof(LaserdockSample), 7);
     memset(samples, 0xFF, sizeof(LaserdockSample) * 7);
     dacDevice->runner_mode_load(samples, 0, 7);
+    free(samples);
+}
 
-    serialNumber.setName("Serial");
-    serialNumber.set(dacDevice->serial_number());
-    ofLogNotice("DacLaserdock : connecting to : " + ofToString(serialNumber));
+bool DacLaserDock :: reconnect() {
     
-    // TODO if failed, then delete device and don't start the thread
+    if(reconnector.connectionLost()) {
+        ofLogNotice("DacLaserdock " + serialNumber.get() + " connection lost, reconnecting");
+    }
+    if(dacDevice!=nullptr) {
+        delete dacDevice;
+        dacDevice = nullptr;
+    }
     
-    startThread();
-    return true;
+    while(isThreadRunning()) {
+        if(!reconnector.isTimeToRetry()) {
+            sleep(1);
+            continue;
+        }
+        bool found = usbLocation.find([this](libusb_device* usbdevice) {
+            LaserdockDevice* device = new LaserdockDevice(usbdevice);
+            if((device->status() == LaserdockDevice::Status::INITIALIZED) && (device->serial_number() == serialNumber.get())) {
+                dacDevice = device;
+                return true;
+            }
+            delete device;
+            return false;
+        });
+        
+        if(found) {
+            // the pps gets sent again because initDevice resets it, and
+            // we start again from the newest frame
+            initDevice();
+            discardStaleFrames();
+            setConnected(true);
+            reconnector.reconnected();
+            return true;
+        }
+    }
+    return false;
 }
 
 bool DacLaserDock::setPointsPerSecond(uint32_t newpps) {
@@ -135,10 +180,18 @@ void DacLaserDock :: reset() {
 
 void DacLaserDock :: threadedFunction(){
     
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "LaserDock");
+    
     int _index = 0;
     
     while(isThreadRunning()) {
         
+        // if the laserdock has been unplugged (or has re-enumerated)
+        // get it back as quickly as we can
+        if(!connected) {
+            if(!reconnect()) break;
+        }
         
         int pointBufferMin = MIN(getMaxPointBufferSize(), maxLatencyMS * pps /1000);
         
@@ -163,14 +216,10 @@ void DacLaserDock :: threadedFunction(){
         }
         
         waitUntilReadyToSend(pointBufferMin);
-        // returns false if it doesn't work
-        if(!sendPointsToDac()) {
-            if(!connected) {
-                
-              // try to reconnect?
-            }
-           // connected = false;
-            //ofLogError("laserdock sendpoints error");
+        // returns false if it doesn't work, and if it's because
+        // we've lost the laserdock we reconnect next time round
+        if(sendPointsToDac()) {
+            reconnector.lightRestored(getId());
         }
         
     }
@@ -199,7 +248,7 @@ inline bool DacLaserDock::sendPointsToDac() {
         numpointstosend = MIN(bufferedPoints.size(), maxPointsToSend);
         
         if(numpointstosend==0) {
-            if(verbose) ofLogNotice("sendData : no points to send");
+            if(verbose) logNotice("sendData : no points to send");
             return false;
         }
         //cout << dacBufferFullness << " " << currentDacBufferFullnessMin << " " << numpointstosend << endl;
@@ -258,9 +307,16 @@ inline bool DacLaserDock::sendPointsToDac() {
         lastAckTime = ofGetElapsedTimeMicros();
         lastReportedBufferFullness = dacCommand.numPoints;
         stateRecorder.recordStateThreadSafe(lastDataSentTime, 1, lastReportedBufferFullness, lastAckTime-lastDataSentTime, dacCommand.numPoints, pps, dacCommand.size());
+        sendFailures = 0;
     } else {
-        connected = false; 
-        ofLogError("Laserdock send failed"); 
+        // one failed transfer doesn't mean it's gone, but if they keep
+        // failing then it's been unplugged or has re-enumerated
+        sendFailures++;
+        AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "Laserdock send failed");
+        if(sendFailures>=maxSendFailures) {
+            connected = false;
+            sendFailures = 0;
+        }
     }
 
     return success;
@@ -15,6 +15,7 @@
 //#include "ofxLaserDacLaserDockByteStream.h"
 #include "LaserdockDevice.h"
 #include "libusb.h"
+#include "ofxLaserUsbDeviceLocation.h"
 
 
 #define LASERDOCK_MIN 0
@@ -71,8 +72,14 @@ class DacLaserDock : public DacBaseThreaded{
 	void threadedFunction() override;
 
 	void setConnected(bool state);
+    // sets up the output on a newly opened device
+    void initDevice();
+    // finds the same laserdock again after it's been unplugged or
+    // re-enumerated, keeps trying until it does or the thread stops
+    bool reconnect();
 	
 	LaserdockDevice * dacDevice = nullptr;
+    UsbDeviceLocation usbLocation;
 	
     DacLaserdockByteStream dacCommand; 
     LaserdockSample lastPointSent;
@@ -81,6 +88,10 @@ class DacLaserDock : public DacBaseThreaded{
 	uint32_t maxPPS; 
 	
 	bool connected = false;
+    // consecutive sends that have failed, after maxSendFailures we
+    // reconnect
+    int sendFailures = 0;
+    const int maxSendFailures = 5;
     
 
 };
@@ -18,16 +18,98 @@ DacManagerLaserDock :: DacManagerLaserDock()  {
         //return false;
     }
     
+    if(UsbHotplugMonitor::isSupported()) {
+        hotplugWatchId = UsbHotplugMonitor::instance()->addWatch(LASERDOCK_VIN, LASERDOCK_PIN, [this](libusb_device* usbdevice, bool arrived) {
+            deviceChanged(usbdevice, arrived);
+        });
+    }
+    if(hotplugWatchId<0) {
+        ofLogNotice("DacManagerLaserdock - USB hotplug not available, scanning for laserdocks instead");
+    }
+    
 }
 DacManagerLaserDock :: ~DacManagerLaserDock()  {
 
     // TODO wait for all DACs threads to stop
+    if(hotplugWatchId>=0) UsbHotplugMonitor::instance()->removeWatch(hotplugWatchId);
+    for(auto& devicepair : serialsByDevice) {
+        libusb_unref_device(devicepair.first);
+    }
+    for(auto& change : pendingDeviceChanges) {
+        libusb_unref_device(change.first);
+    }
     
     libusb_exit(NULL);
 }
 
+void DacManagerLaserDock :: deviceChanged(libusb_device* usbdevice, bool arrived) {
+    
+    // we don't open the device here because one of our DACs might be
+    // claiming it back on its own thread, processDeviceChanges does it
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    pendingDeviceChanges.push_back(std::make_pair(libusb_ref_device(usbdevice), arrived));
+    // DacAssigner::update picks this up on the next frame
+    dacsChanged = true;
+}
+
+void DacManagerLaserDock :: processDeviceChanges() {
+    
+    vector<pair<libusb_device*, bool>> changes;
+    {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        std::swap(changes, pendingDeviceChanges);
+    }
+    
+    for(auto& change : changes) {
+        libusb_device* usbdevice = change.first;
+        if(change.second) {
+            string portpath = UsbDeviceLocation::getPortPath(usbdevice);
+            string serialnumber;
+            auto portit = serialsByPortPath.find(portpath);
+            if((portit!=serialsByPortPath.end()) && (dacsById.count(portit->second)>0)) {
+                // one of our DACs reconnecting, it checks the serial itself
+                // when it claims the device so we leave it alone
+                serialnumber = portit->second;
+            } else {
+                // this is the only time we open the device to get the serial
+                serialnumber = getLaserdockSerialNumber(usbdevice);
+            }
+            if(serialnumber!="") {
+                serialsByPortPath[portpath] = serialnumber;
+                std::lock_guard<std::mutex> lock(deviceMutex);
+                if(serialsByDevice.count(usbdevice)==0) libusb_ref_device(usbdevice);
+                serialsByDevice[usbdevice] = serialnumber;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            auto it = serialsByDevice.find(usbdevice);
+            if(it!=serialsByDevice.end()) {
+                ofLogNotice("DacManagerLaserdock - laserdock unplugged : "+it->second);
+                libusb_unref_device(it->first);
+                serialsByDevice.erase(it);
+            }
+        }
+        libusb_unref_device(usbdevice);
+    }
+}
+
 vector<DacData> DacManagerLaserDock :: updateDacList(){
     
+    if(hotplugWatchId<0) return scanDacList();
+    
+    processDeviceChanges();
+    
+    vector<DacData> daclist;
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    for(auto& devicepair : serialsByDevice) {
+        daclist.push_back(DacData(getType(), devicepair.second));
+    }
+    return daclist;
+    
+}
+
+vector<DacData> DacManagerLaserDock :: scanDacList(){
+    
     vector<DacData> daclist;
   
     libusb_device **libusb_device_list;
@@ -77,6 +159,30 @@ DacBase* DacManagerLaserDock :: getAndConnectToDac(const string& id){
         return dac;
     }
     
+    if(hotplugWatchId>=0) {
+        libusb_device* usbdevice = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            for(auto& devicepair : serialsByDevice) {
+                if(devicepair.second == id) {
+                    usbdevice = libusb_ref_device(devicepair.first);
+                    break;
+                }
+            }
+        }
+        if(usbdevice==nullptr) return nullptr;
+        
+        dac = new DacLaserDock();
+        if(!dac->setup(usbdevice)){
+            delete dac;
+            dac = nullptr;
+        } else {
+            dacsById[id] = dac;
+        }
+        libusb_unref_device(usbdevice);
+        return dac;
+    }
+    
     libusb_device **libusb_device_list;
     ssize_t cnt = libusb_get_device_list(NULL, &libusb_device_list);
     ssize_t i = 0;
@@ -8,6 +8,7 @@
 #pragma once
 #include "ofxLaserDacManagerBase.h"
 #include "ofxLaserDacLaserDock.h"
+#include "ofxLaserUsbHotplugMonitor.h"
 
 #include <libusb.h>
 
@@ -36,6 +37,25 @@ class DacManagerLaserDock : public DacManagerBase{
     
     string getLaserdockSerialNumber(libusb_device* usbdevice);
 
+    // called by the UsbHotplugMonitor on its thread, queues the change
+    void deviceChanged(libusb_device* usbdevice, bool arrived);
+    // deals with the queued changes, on the manager's thread
+    void processDeviceChanges();
+    // goes through all the USB devices, for when there's no hotplug
+    vector<DacData> scanDacList();
+
+    int hotplugWatchId = -1;
+    // the laserdocks that are plugged in and their serial numbers, which
+    // are only read when they arrive. Only used with hotplug.
+    std::mutex deviceMutex;
+    map<libusb_device*, string> serialsByDevice;
+    // from the hotplug thread, the devices are referenced until they're
+    // processed. Protected by deviceMutex.
+    vector<pair<libusb_device*, bool>> pendingDeviceChanges;
+    // the last serial number seen on each USB port, so that we don't
+    // open a device one of our DACs is claiming back. Only touched on
+    // the manager's thread.
+    map<string, string> serialsByPortPath;
     
     
     
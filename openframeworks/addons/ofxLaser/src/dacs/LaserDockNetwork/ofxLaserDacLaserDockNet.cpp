@@ -43,6 +43,9 @@ void DacLaserDockNet :: setup(string _id, string _ip, DacLaserDockNetStatus stat
 	pps = status.point_rate;
 	newPPS = 30000; // this is always sent on begin if different
     maxPointRate = status.point_rate_max;
+    // the LaserDock streams continuously so the buffer is always draining
+    bufferEstimator.setPointRate(pps);
+    bufferEstimator.setPlaying(true, ofGetElapsedTimeMicros());
 	
 	connected = false;
 	ipAddress = _ip;
@@ -61,6 +64,11 @@ void DacLaserDockNet :: setup(string _id, string _ip, DacLaserDockNetStatus stat
 	try {
 
 		Poco::Net::SocketAddress sa(ipAddress, DacLaserDockNetConsts::DATA_PORT);
+        // send from the network interface that the LaserCube was found on,
+        // otherwise the OS picks one
+        if(status.interface_address!="") {
+            dataUdpSocket.bind(Poco::Net::SocketAddress(status.interface_address, 0), true);
+        }
         dataUdpSocket.connect(sa);
 		
 		connected = true;
@@ -89,6 +97,9 @@ void DacLaserDockNet :: setup(string _id, string _ip, DacLaserDockNetStatus stat
     try {
 
         Poco::Net::SocketAddress sa(ipAddress, DacLaserDockNetConsts::CMD_PORT);
+        if(status.interface_address!="") {
+            commandUdpSocket.bind(Poco::Net::SocketAddress(status.interface_address, 0), true);
+        }
         commandUdpSocket.connect(sa);
         
         connected &= true;
@@ -124,18 +135,8 @@ void DacLaserDockNet :: setup(string _id, string _ip, DacLaserDockNetStatus stat
 
 void DacLaserDockNet :: threadedFunction(){
     
-    auto & thread = getNativeThread();
-   
-#ifndef _MSC_VER
-    // only linux and osx
-    //http://www.yonch.com/tech/82-linux-thread-priority
-    struct sched_param param;
-    param.sched_priority = 90; // (highest) sched_get_priority_max(SCHED_FIFO);//89; // - higher is faster
-    pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param );
-#else
-    // windows implementation
-    SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_HIGHEST);
-#endif
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "LaserCubeNet");
 
 
     while(isThreadRunning() ) {
@@ -146,6 +147,7 @@ void DacLaserDockNet :: threadedFunction(){
         if(connected && (newPPS!=pps)) {
             sendPointRate(newPPS); // assume it was sent i guess? Or periodically send it?
             pps = newPPS;
+            bufferEstimator.setPointRate(pps);
         }
         
         // maxPointsToFillBuffer is the minimum number of points we want
@@ -206,6 +208,7 @@ void DacLaserDockNet :: closeWhileRunning() {
 	while(!lock())
         ;
     dataUdpSocket.close();
+    commandUdpSocket.close();
 	unlock();
 	
 	
@@ -279,8 +282,8 @@ inline bool DacLaserDockNet :: sendPointsToDac(){
     int numPointsLeftToSend = totalNumPointsToSend;
    
     if(verbose)  {
-        ofLogNotice("maxEstimatedBufferFullness : ") <<maxEstimatedBufferFullness << " " << maxEstimatedBufferFullness+totalNumPointsToSend;
-        ofLogNotice("Sending ") << totalNumPointsToSend << " points... ";
+        logNotice("maxEstimatedBufferFullness : %d %d", maxEstimatedBufferFullness, maxEstimatedBufferFullness+totalNumPointsToSend);
+        logNotice("Sending %d points... ", totalNumPointsToSend);
     }
     if(verbose) cout << "Packets : ";
     
@@ -372,6 +375,7 @@ inline bool DacLaserDockNet :: sendPointsToDac(){
     if(success) {
         lastDataSentTime = ofGetElapsedTimeMicros();
         lastDataSentBufferSize = maxEstimatedBufferFullness + totalNumPointsToSend;
+        bufferEstimator.addPoints(totalNumPointsToSend, lastDataSentTime);
     }  else {
         logNotice("sendCommand failed!");
         
@@ -482,12 +486,12 @@ bool DacLaserDockNet :: checkDataPortIncoming() {
         
     } catch (Poco::Exception& exc) {
         //Handle your network errors.
-        ofLog(OF_LOG_ERROR,  "Network error: " + exc.displayText());
+        AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "Network error: %s", exc.displayText().c_str());
         //    isOpen = false;
         failed = true;
     } catch (Poco::TimeoutException& exc) {
         //Handle your network errors.
-        ofLog(OF_LOG_ERROR,  "Timeout error: " + exc.displayText());
+        AsyncLog::log(OF_LOG_ERROR, LOG_CATEGORY_DAC, "Timeout error: %s", exc.displayText().c_str());
         //    isOpen = false;
         failed = true;
         
@@ -498,6 +502,9 @@ bool DacLaserDockNet :: checkDataPortIncoming() {
             //cout << calculateBufferFullnessByTimeAcked() << " " ;
             lastAckTime = ofGetElapsedTimeMicros();
             lastReportedBufferFullness = getMaxPointBufferSize() - ByteStreamUtils::bytesToUInt16(&inBuffer[2]);
+            bufferEstimator.addMeasurement(lastReportedBufferFullness, lastAckTime, lastAckTime - lastCommandSendTime);
+            // no underflow flag from the LaserDock so an empty buffer will have to do
+            latencyTuner.addSample(lastAckTime, lastReportedBufferFullness, lastAckTime - lastCommandSendTime, pps, lastReportedBufferFullness==0);
             
            // cout << lastReportedBufferFullness << endl;
         }
@@ -579,6 +586,7 @@ void DacLaserDockNet :: close() {
     }
         
     dataUdpSocket.close();
+    commandUdpSocket.close();
 
 }
 
@@ -596,6 +604,7 @@ bool DacLaserDockNet::setPointsPerSecond(uint32_t newpps){
     if(newpps>maxPointRate) newpps = maxPointRate;
     if(!isThreadRunning()){
         pps = newPPS = newpps;
+        bufferEstimator.setPointRate(pps);
         return true;
     } else {
         while(!lock());
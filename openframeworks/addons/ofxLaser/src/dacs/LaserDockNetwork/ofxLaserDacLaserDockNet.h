@@ -57,6 +57,8 @@ public:
     bool checkDataPortIncoming(); 
    
     int getMaxPointBufferSize() override;
+    // the acks have the buffer fullness in them
+    bool canAutoLatency() override { return true; };
 //    // estimate the current dac buffer fullness based on the last time points were sent
 //    virtual int calculateBufferSizeByTimeSent() override;
 //    // estimate the current dac buffer fullness based on the last time points were acknowledged
@@ -43,6 +43,9 @@ class DacLaserDockNetStatus {
     string model_name;
     
     float lastUpdateTime = 0;
+    // not in the packet, the address of our network interface
+    // that it was found on
+    string interface_address;
     
     
     void deserialize(unsigned char* buffer) {
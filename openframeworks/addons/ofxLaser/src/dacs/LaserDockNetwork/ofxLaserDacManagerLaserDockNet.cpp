@@ -11,52 +11,7 @@ using namespace ofxLaser;
 
 DacManagerLaserDockNet :: DacManagerLaserDockNet()  {
 
-
-    
-    try {
-
-       // auto ip = address.get<Poco::Net::NetworkInterface::BROADCAST_ADDRESS>();
-        //commandUdpSocket.bind(
-        Poco::Net::SocketAddress sa("255.255.255.255", DacLaserDockNetConsts::ALIVE_PORT);
-        Poco::Net::SocketAddress la("10.0.1.188", DacLaserDockNetConsts::ALIVE_PORT);
-        //commandUdpSocket.bind(la);
-        
-        //commandUdpSocket = Poco::Net::DatagramSocket(sa);
-        //commandUdpSocket.setBlocking(false);
-       //commandUdpSocket.setBroadcast(true);
-        commandUdpSocket.bind(la);
-        commandUdpSocket.connect(sa);
-        commandUdpSocket.setBroadcast(true);
-        commandUdpSocket.setBlocking(false);
-
-        
-        ofLogNotice() << commandUdpSocket.address().toString();
-        //ofLogNotice() << commandUdpSocket.
-
-        connected = true;
-    } catch (Poco::Exception& exc) {
-        //Handle your network errors.
-        ofLog(OF_LOG_ERROR,  "DacLaserDockNet setup failed - Network error: " + exc.displayText());
-        connected = false;
-
-    }catch (Poco::Net::HostNotFoundException& exc) {
-        //Handle your network errors.
-        ofLog(OF_LOG_ERROR,  "DacLaserDockNet setup failed - host not found: " + exc.displayText());
-        connected = false;
-        
-    }catch (Poco::TimeoutException& exc) {
-        //Handle your network errors.
-        ofLog(OF_LOG_ERROR,  "DacLaserDockNet setup failed - Timeout error: " + exc.displayText());
-        connected = false;
-        
-    }
-    catch(...){
-        ofLog(OF_LOG_ERROR, "DacLaserDockNet setup failed - unknown error");
-        //std::rethrow_exception(current_exception);
-        connected = false;
-    }
-    
-   // udpConnection.Setup(settings);
+    // the sockets are made in the thread
     startThread();
 }
 
@@ -64,7 +19,43 @@ DacManagerLaserDockNet :: ~DacManagerLaserDockNet()  {
     stopThread();
     waitForThread();
     // TODO wait for all DACs threads to stop
-    commandUdpSocket.close();
+    closeSockets();
+}
+
+void DacManagerLaserDockNet :: closeSockets() {
+    for(Poco::Net::DatagramSocket& socket : commandUdpSockets) {
+        socket.close();
+    }
+    commandUdpSockets.clear();
+    connected = false;
+}
+
+void DacManagerLaserDockNet :: updateNetworkInterfaces() {
+    
+    lastInterfaceCheckTime = ofGetElapsedTimef();
+    
+    vector<NetworkInterfaceData> newInterfaces = NetworkInterfaces::getIPv4Interfaces();
+    if(connected && NetworkInterfaces::isSameList(newInterfaces, networkInterfaces)) return;
+    
+    closeSockets();
+    networkInterfaces.clear();
+    
+    for(NetworkInterfaceData& networkInterface : newInterfaces) {
+        try {
+            // the LaserCubes reply to the port we send from
+            Poco::Net::DatagramSocket socket;
+            socket.bind(Poco::Net::SocketAddress(networkInterface.address, DacLaserDockNetConsts::ALIVE_PORT), true);
+            socket.setBroadcast(true);
+            socket.setBlocking(false);
+            commandUdpSockets.push_back(socket);
+            networkInterfaces.push_back(networkInterface);
+            ofLogNotice("DacManagerLaserDockNet - looking for LaserCubes on "+networkInterface.name+" "+networkInterface.address);
+            
+        } catch (Poco::Exception& exc) {
+            ofLog(OF_LOG_ERROR,  "DacManagerLaserDockNet setup failed on "+networkInterface.name+" "+networkInterface.address+" - Network error: " + exc.displayText());
+        }
+    }
+    connected = !commandUdpSockets.empty();
 }
 
 void DacManagerLaserDockNet :: threadedFunction() {
@@ -72,101 +63,82 @@ void DacManagerLaserDockNet :: threadedFunction() {
     const int packetSize = 80; // should only need 64
     char udpMessage[packetSize];
     
-    auto & thread = getNativeThread();
-    //unsigned int n = std::thread::hardware_concurrency();
-    //    std::cout << n << " concurrent threads are supported.\n";
-   
-#ifndef _MSC_VER
-    // only linux and osx
-    //http://www.yonch.com/tech/82-linux-thread-priority
-    struct sched_param param;
-    param.sched_priority = 1; // (highest) sched_get_priority_max(SCHED_FIFO);//89; // - higher is faster
-    pthread_setschedparam(thread.native_handle(), SCHED_RR, &param );
-#else
-    // windows implementation
-    SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_LOWEST);
-#endif
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DISCOVERY, "LCNet discovery");
     
     while(isThreadRunning()) {
-        int numBytesSent = 0;
+        // network interfaces come and go (eg when a cable is plugged in)
+        if(!connected || (ofGetElapsedTimef()-lastInterfaceCheckTime > 5)) {
+            updateNetworkInterfaces();
+        }
         
         char cmd[] = {DacLaserDockNetConsts::CMD_GET_ALIVE, 0};
         
-        try {
-            //Poco::Net::SocketAddress sa("10.0.1.255", DacLaserDockNetConsts::ALIVE_PORT);
-            //commandUdpSocket.sendTo(cmd, 1, sa);
-            commandUdpSocket.sendBytes(cmd, 1);
-        }
-        catch (Poco::Exception& exc) {
-            //Handle your network errors.
-            std::cerr << "sendBytes : Network error: " << exc.displayText() << endl;
-            //networkerror = true;
-            //failed = true;
-            ofLogNotice() << commandUdpSocket.address().toString();
-        }
-        catch (Poco::TimeoutException& exc) {
-            //Handle your network errors.
-            std::cerr << "sendBytes : Timeout error: " << exc.displayText() << endl;
-            //    isOpen = false;
-            //failed = true;
-        } catch (...) {
-            
-            std::cerr << "sendBytes : unspecified error " << endl;
+        // broadcast on every network
+        for(size_t i = 0; i<commandUdpSockets.size(); i++) {
+            try {
+                Poco::Net::SocketAddress sa(networkInterfaces[i].broadcastAddress, DacLaserDockNetConsts::ALIVE_PORT);
+                commandUdpSockets[i].sendTo(cmd, 1, sa);
+            }
+            catch (Poco::Exception& exc) {
+                ofLog(OF_LOG_VERBOSE,  "DacManagerLaserDockNet broadcast failed on "+networkInterfaces[i].address+" - " + exc.displayText());
+            }
         }
         
         
-        
         // LET'S ASSUME FOR NOW...
         // that every packet is a complete message from a single dac.
         
         float sendTime = ofGetElapsedTimef();
         
-        int numBytesReceived = 0;
         do {
-            memset(udpMessage,0,sizeof(udpMessage));
-            Poco::Net::SocketAddress socketAddress;
-            //numBytesReceived = commandUdpSocket.receiveFrom(udpMessage,packetSize, socketAddress); //returns number of bytes received
-            numBytesReceived = commandUdpSocket.receiveFrom(udpMessage,packetSize, socketAddress);
-            if(numBytesReceived >=1)  {
-                
-               // ofLogNotice("Received "+ ofToString(numBytesReceived) + " bytes from UDP connection ") << ;
-                
-                
-                
-                string address = socketAddress.toString();
-                int port = socketAddress.port();
+            for(size_t socketIndex = 0; socketIndex<commandUdpSockets.size(); socketIndex++) {
+                int numBytesReceived = 0;
+                memset(udpMessage,0,sizeof(udpMessage));
+                Poco::Net::SocketAddress socketAddress;
+                try {
+                    numBytesReceived = commandUdpSockets[socketIndex].receiveFrom(udpMessage,packetSize, socketAddress);
+                } catch (Poco::Exception& exc) {
+                    numBytesReceived = 0;
+                }
+                if(numBytesReceived >=1)  {
                 
+                   // ofLogNotice("Received "+ ofToString(numBytesReceived) + " bytes from UDP connection ") << ;
                 
-                std::cout << "----------------------------------------------------------------------"<< std::endl;
-                            std::cout << "ip: " << address << " " << port << std::endl;
-                            std::cout << "Packet Size: " << numBytesReceived << std::endl;
-                            std::cout << "UDP Packet: " << std::endl;
                 
                 
-                if(numBytesReceived>=64) {
-                    DacLaserDockNetStatus status;
-                    status.deserialize((unsigned char*)(&udpMessage));
-                    cout << status.toString() << endl;
+                    if(numBytesReceived>=64) {
+                        DacLaserDockNetStatus status;
+                        status.deserialize((unsigned char*)(&udpMessage));
+                        status.interface_address = networkInterfaces[socketIndex].address;
+                        status.lastUpdateTime = ofGetElapsedTimef();
+                        // these come in every second so only build the
+                        // string if it's going to be logged
+                        if(ofGetLogLevel()<=OF_LOG_VERBOSE) {
+                            ofLogVerbose("DacManagerLaserDockNet - status from "+socketAddress.toString()+" : "+status.toString());
+                        }
                     
-                    string id = status.serial_number;
+                        string id = status.serial_number;
                     
-    //                // if we haven't already got this LaserDockNet, then add it
-                   if(dacStatusById.find(id) == dacStatusById.end()) {
+                        // if we haven't already got this LaserDockNet, then add it
+                        if(dacStatusById.find(id) == dacStatusById.end()) {
     
-                       if(lock()) {
-                            dacStatusById[id] = status;
-                            dacsChanged = true;
-                            unlock();
-                        }
-                    } else {
+                            if(lock()) {
+                                dacStatusById[id] = status;
+                                dacsChanged = true;
+                                unlock();
+                            }
+                        } else {
     
-                        if(lock()) {
-                            dacStatusById[id] = status;
-                            dacStatusById[id].lastUpdateTime = ofGetElapsedTimef();
-                            unlock();
+                            if(lock()) {
+                                // it's moved to a different network
+                                if(dacStatusById[id].interface_address != status.interface_address) dacsChanged = true;
+                                dacStatusById[id] = status;
+                                unlock();
+                            }
                         }
-                    }
                     
+                    }
                 }
             }
             sleep(10); 
@@ -11,6 +11,8 @@
 #include "ofxLaserDacLaserDockNet.h"
 #include "ofxNetwork.h"
 #include "ofThread.h"
+#include "ofxLaserThreadPolicy.h"
+#include "ofxLaserNetworkInterfaces.h"
 
 
 namespace ofxLaser {
@@ -35,11 +37,17 @@ class DacManagerLaserDockNet : public DacManagerBase, ofThread{
     
     protected :
     
+    // checks for new network interfaces (or ones that have gone) and
+    // makes a socket for each one
+    void updateNetworkInterfaces();
+    void closeSockets();
+    
     bool connected = false;
     //ofxUDPManager udpConnection;
-    Poco::Net::DatagramSocket commandUdpSocket;
- 
-
+    // one for each network interface, bound to its address
+    vector<Poco::Net::DatagramSocket> commandUdpSockets;
+    vector<NetworkInterfaceData> networkInterfaces;
+    float lastInterfaceCheckTime = 0;
     
 
     map<string, DacLaserDockNetStatus> dacStatusById;
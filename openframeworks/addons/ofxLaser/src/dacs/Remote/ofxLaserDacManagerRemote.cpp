@@ -0,0 +1,173 @@
+//
+//  ofxLaserDacManagerRemote.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacManagerRemote.h"
+
+using namespace ofxLaser;
+
+DacManagerRemote :: DacManagerRemote()  {
+
+    try {
+        announceSocket.bind(Poco::Net::SocketAddress("0.0.0.0", RemoteConsts::ANNOUNCE_PORT), true);
+        announceSocket.setBroadcast(true);
+        announceSocket.setBlocking(false);
+        connected = true;
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "DacManagerRemote setup failed - Network error: " + exc.displayText());
+        connected = false;
+    } catch(...){
+        ofLog(OF_LOG_ERROR, "DacManagerRemote setup failed - unknown error");
+        connected = false;
+    }
+
+    if(connected) startThread();
+}
+
+DacManagerRemote :: ~DacManagerRemote()  {
+    if(isThreadRunning()) {
+        stopThread();
+        waitForThread();
+    }
+    announceSocket.close();
+}
+
+void DacManagerRemote :: threadedFunction() {
+
+    vector<uint8_t> udpMessage(RemoteConsts::MAX_DATAGRAM_SIZE);
+    Poco::Timespan pollTime(100000); // 100ms
+
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DISCOVERY, "Remote discovery");
+
+    while(isThreadRunning()) {
+
+        try {
+            if(announceSocket.poll(pollTime, Poco::Net::Socket::SELECT_READ)) {
+                Poco::Net::SocketAddress sender;
+                int numBytesReceived = announceSocket.receiveFrom(udpMessage.data(), (int)udpMessage.size(), sender);
+                if(numBytesReceived>0) {
+                    processAnnounce(udpMessage.data(), numBytesReceived, sender.host().toString());
+                }
+            }
+        } catch (Poco::Exception& exc) {
+            ofLog(OF_LOG_ERROR,  "DacManagerRemote receive failed - " + exc.displayText());
+            sleep(100);
+        }
+
+        // delete DACs we haven't heard about for a while
+        if(lock()) {
+            for (auto it = remoteDataById.cbegin(); it != remoteDataById.cend(); )  {
+                if ((ofGetElapsedTimef() - it->second.lastUpdateTime)>expiryTime){
+                    ofLogNotice("DacManagerRemote - removing remote DAC "+ it->first);
+                    remoteDataById.erase(it++);
+                    dacsChanged = true;
+                } else {
+                    ++it;
+                }
+            }
+            unlock();
+        }
+    }
+}
+
+bool DacManagerRemote :: processAnnounce(uint8_t* data, int length, const string& ipAddress) {
+
+    RemotePacketReader reader(data, length);
+    if(reader.readPacketType()!=RemoteConsts::TYPE_ANNOUNCE) return false;
+
+    string nodeName = reader.readString();
+    int dataPort = reader.readUInt16();
+    int numDacs = reader.readUInt8();
+    if(reader.hasError()) return false;
+
+    float now = ofGetElapsedTimef();
+    if(lock()) {
+        for(int i = 0; i<numDacs; i++) {
+            DacRemoteData remoteData;
+            remoteData.nodeName = nodeName;
+            remoteData.dacLabel = reader.readString();
+            remoteData.dacStatus = reader.readUInt8();
+            remoteData.ipAddress = ipAddress;
+            remoteData.dataPort = dataPort;
+            remoteData.lastUpdateTime = now;
+            if(reader.hasError()) break;
+
+            string id = nodeName + ":" + remoteData.dacLabel;
+            auto it = remoteDataById.find(id);
+            if(it == remoteDataById.end()) {
+                ofLogNotice("DacManagerRemote - adding remote DAC "+ id) << " " << ipAddress << ":" << dataPort;
+                dacsChanged = true;
+            } else if((it->second.ipAddress != ipAddress) || (it->second.dataPort != dataPort)) {
+                dacsChanged = true;
+            }
+            remoteDataById[id] = remoteData;
+        }
+        unlock();
+    }
+    return !reader.hasError();
+}
+
+vector<DacData> DacManagerRemote :: updateDacList(){
+
+    vector<DacData> daclist;
+
+    if(lock()) {
+        for(auto& remotepair : remoteDataById) {
+            DacRemoteData& remoteData = remotepair.second;
+            daclist.emplace_back(getType(), remotepair.first, remoteData.ipAddress);
+        }
+        unlock();
+    }
+    return daclist;
+}
+
+DacBase* DacManagerRemote :: getAndConnectToDac(const string& id){
+
+    // returns a dac - if failed returns nullptr.
+
+    DacRemote* dac = (DacRemote*) getDacById(id);
+    if(dac!=nullptr) {
+        ofLogNotice("DacManagerRemote :: getAndConnectToDac(...) - Already a dac made with id "+ofToString(id));
+        return dac;
+    }
+
+    DacRemoteData remoteData;
+    bool found = false;
+    if(lock()) {
+        if(remoteDataById.find(id)!=remoteDataById.end()) {
+            remoteData = remoteDataById.at(id);
+            found = true;
+        }
+        unlock();
+    }
+    if(!found) return nullptr;
+
+    dac = new DacRemote();
+    if(!dac->setup(remoteData.nodeName, remoteData.ipAddress, remoteData.dataPort, remoteData.dacLabel)) {
+        delete dac;
+        return nullptr;
+    }
+    dacsById[id] = dac;
+    return dac;
+}
+
+bool DacManagerRemote :: disconnectAndDeleteDac(const string& id){
+
+    DacRemote* dac = (DacRemote*)getDacById(id);
+    if(dac==nullptr) {
+        ofLogError("DacManagerRemote::disconnectAndDeleteDac("+id+") - dac not found");
+        return false;
+    }
+
+    dac->close();
+    auto it=dacsById.find(id);
+    dacsById.erase(it);
+    delete dac;
+    return true;
+}
+
+void DacManagerRemote :: exit() {
+
+}
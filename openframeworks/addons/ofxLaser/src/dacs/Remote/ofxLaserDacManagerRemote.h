@@ -0,0 +1,53 @@
+//
+//  ofxLaserDacManagerRemote.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofxLaserDacManagerBase.h"
+#include "ofxLaserDacBase.h"
+#include "ofxLaserDacRemote.h"
+#include "ofxLaserDacRemoteData.h"
+#include "ofThread.h"
+#include "ofxLaserThreadPolicy.h"
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+
+
+namespace ofxLaser {
+
+// Finds the DACs on RemoteNodes. Every node broadcasts the list of its
+// DACs once a second and each one shows up here as
+// "Remote nodename:daclabel".
+class DacManagerRemote : public DacManagerBase, ofThread {
+
+    public :
+    DacManagerRemote();
+    ~DacManagerRemote();
+
+    virtual vector<DacData> updateDacList() override;
+    virtual DacBase* getAndConnectToDac(const string& id) override;
+    virtual bool disconnectAndDeleteDac(const string& id) override;
+    virtual string getType() override {
+        return "Remote";
+    }
+    virtual void exit() override;
+
+    void threadedFunction() override;
+
+    protected :
+
+    bool processAnnounce(uint8_t* data, int length, const string& ipAddress);
+
+    bool connected = false;
+    Poco::Net::DatagramSocket announceSocket;
+
+    map<string, DacRemoteData> remoteDataById;
+
+    // how long before a node that stops announcing is removed
+    float expiryTime = 3;
+
+};
+}
@@ -0,0 +1,207 @@
+//
+//  ofxLaserDacRemote.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacRemote.h"
+
+using namespace ofxLaser;
+
+DacRemote :: DacRemote() {
+    pps = 30000;
+    remoteArmed = false;
+    nextSequence = 1;
+    lastFrameNumPoints = 0;
+    lastFrameSentTime = 0;
+    lastStatusTime = 0;
+    statusLastSequence = 0;
+    statusBufferedFrames = 0;
+    statusJitterBufferMicros = 0;
+    statusJitterMicros = 0;
+    statusDacStatus = OFXLASER_DACSTATUS_NO_DAC;
+    statusFramesDropped = 0;
+    statusFramesIncomplete = 0;
+    framesSkipped = 0;
+    bytesSent = 0;
+
+    colourShiftImplemented = false;
+
+    displayData.push_back(&nodeNameDisplay.set("Node", ""));
+    displayData.push_back(&bufferedFramesDisplay.set("Node buffered frames", 0));
+    displayData.push_back(&jitterDisplay.set("Network jitter (ms)", 0));
+    displayData.push_back(&framesDroppedDisplay.set("Frames dropped", 0));
+    displayData.push_back(&framesIncompleteDisplay.set("Frames lost", 0));
+}
+
+DacRemote :: ~DacRemote() {
+    close();
+}
+
+bool DacRemote :: setup(const string& _nodeName, const string& _ipAddress, int _dataPort, const string& _dacLabel) {
+
+    nodeName = _nodeName;
+    ipAddress = _ipAddress;
+    dataPort = _dataPort;
+    dacLabel = _dacLabel;
+    nodeNameDisplay = nodeName + " (" + ipAddress + ")";
+
+    try {
+        nodeAddress = Poco::Net::SocketAddress(ipAddress, dataPort);
+        // the node sends its status back to this port
+        socket.bind(Poco::Net::SocketAddress("0.0.0.0", 0), true);
+        socket.setBlocking(false);
+        socketOpen = true;
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "DacRemote setup failed - Network error: " + exc.displayText());
+        socketOpen = false;
+        return false;
+    }
+
+    receiveBuffer.resize(RemoteConsts::MAX_DATAGRAM_SIZE);
+    startThread();
+    return true;
+}
+
+void DacRemote :: close() {
+    if(isThreadRunning()) {
+        frameChannel.close();
+        waitForThread(true);
+    }
+    if(socketOpen) {
+        socket.close();
+        socketOpen = false;
+    }
+    // delete any frames that didn't get sent
+    DacFrame* frame;
+    while(frameChannel.tryReceive(frame)) {
+        delete frame;
+    }
+}
+
+bool DacRemote :: sendFrame(const vector<Point>& points) {
+    if(!socketOpen) return false;
+
+    DacFrame* frame = new DacFrame(ofGetElapsedTimeMicros());
+    for(const Point& point : points) {
+        frame->addPoint(point);
+    }
+    lastFrameNumPoints = (int)points.size();
+    frameChannel.send(frame);
+    return true;
+}
+
+bool DacRemote :: setPointsPerSecond(uint32_t newpps) {
+    pps = newpps;
+    return true;
+}
+
+void DacRemote :: setArmed(bool _armed) {
+    armed = _armed;
+    remoteArmed = _armed;
+}
+
+bool DacRemote :: isReadyForFrame(int maxLatencyMS) {
+
+    uint64_t now = ofGetElapsedTimeMicros();
+    float frameDurationMicros = lastFrameNumPoints * 1000000.0f / MAX(1, (int)pps);
+
+    if(lastStatusTime==0 || (now - lastStatusTime > 1000000)) {
+        // we don't know anything about the node so send at the frame rate
+        return (now - lastFrameSentTime) >= frameDurationMicros;
+    }
+
+    // the frames that are on their way plus the frames waiting on the node
+    int inFlight = (int)(nextSequence - 1 - statusLastSequence);
+    int pending = MAX(0, inFlight) + statusBufferedFrames;
+
+    // the node deliberately holds on to frames for the jitter buffer
+    float allowedMicros = (maxLatencyMS + calculationTimeMS) * 1000.0f + statusJitterBufferMicros;
+    int allowedFrames = 1;
+    if(frameDurationMicros>0) allowedFrames = MAX(1, (int)(allowedMicros / frameDurationMicros));
+
+    return pending < allowedFrames;
+}
+
+int DacRemote :: getStatus() {
+    if(!socketOpen) return OFXLASER_DACSTATUS_ERROR;
+    uint64_t now = ofGetElapsedTimeMicros();
+    if(lastStatusTime==0) return OFXLASER_DACSTATUS_WARNING;
+    if(now - lastStatusTime > 1000000) return OFXLASER_DACSTATUS_ERROR;
+    return statusDacStatus;
+}
+
+const vector<ofAbstractParameter*>& DacRemote :: getDisplayData() {
+    bufferedFramesDisplay = statusBufferedFrames;
+    jitterDisplay = statusJitterMicros / 1000.0f;
+    framesDroppedDisplay = (int)statusFramesDropped;
+    framesIncompleteDisplay = (int)statusFramesIncomplete;
+    return displayData;
+}
+
+void DacRemote :: threadedFunction() {
+
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "Remote");
+
+    while(isThreadRunning()) {
+
+        DacFrame* frame = nullptr;
+        if(frameChannel.tryReceive(frame, 10)) {
+            // only the newest frame matters
+            DacFrame* newerFrame;
+            while(frameChannel.tryReceive(newerFrame)) {
+                delete frame;
+                frame = newerFrame;
+                framesSkipped++;
+            }
+            sendFrameToNode(frame);
+            delete frame;
+        }
+        receiveStatus();
+    }
+}
+
+void DacRemote :: sendFrameToNode(DacFrame* frame) {
+
+    uint32_t sequence = nextSequence;
+    encoder.encode(dacLabel, sequence, frame->frameTime, pps, remoteArmed, frame->framePoints);
+
+    try {
+        for(int i = 0; i<encoder.getNumDatagrams(); i++) {
+            bytesSent += socket.sendTo(encoder.getDatagram(i), (int)encoder.getDatagramSize(i), nodeAddress);
+        }
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "DacRemote send failed - " + exc.displayText());
+    }
+    nextSequence = sequence + 1;
+    lastFrameSentTime = ofGetElapsedTimeMicros();
+}
+
+void DacRemote :: receiveStatus() {
+
+    try {
+        while(socket.available()>0) {
+            Poco::Net::SocketAddress sender;
+            int numBytes = socket.receiveFrom(receiveBuffer.data(), (int)receiveBuffer.size(), sender);
+            if(numBytes<=0) break;
+
+            RemotePacketReader reader(receiveBuffer.data(), numBytes);
+            if(reader.readPacketType()!=RemoteConsts::TYPE_STATUS) continue;
+
+            RemoteDacStatus status;
+            string label;
+            if(!status.deserialize(reader, label) || (label!=dacLabel)) continue;
+
+            statusLastSequence = status.lastSequence;
+            statusBufferedFrames = status.bufferedFrames;
+            statusJitterBufferMicros = status.jitterBufferMicros;
+            statusJitterMicros = status.jitterMicros;
+            statusDacStatus = status.dacStatus;
+            statusFramesDropped = status.framesDropped;
+            statusFramesIncomplete = status.framesIncomplete;
+            lastStatusTime = ofGetElapsedTimeMicros();
+        }
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "DacRemote receive failed - " + exc.displayText());
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  ofxLaserDacRemote.h
+//  ofxLaser
+//
+// A DAC that's plugged into another computer running a RemoteNode. The
+// finished frames (after all the processing, including colour shift)
+// are sent over the network and the node outputs them to its local DAC.
+//
+// The node reports back how many frames it has buffered and played so
+// that isReadyForFrame can pace the frames just like a local DAC.
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxLaserDacBase.h"
+#include "ofxLaserDacFrame.h"
+#include "ofxLaserRemoteProtocol.h"
+#include "ofxLaserThreadPolicy.h"
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+
+namespace ofxLaser {
+
+class DacRemote : public DacBase, ofThread {
+    public:
+
+    DacRemote();
+    ~DacRemote();
+
+    bool setup(const string& nodeName, const string& ipAddress, int dataPort, const string& dacLabel);
+
+    bool sendFrame(const vector<Point>& points) override;
+    // the node only outputs frames
+    bool sendPoints(const vector<Point>& points) override { return false; };
+    int getPointStreamSpace(int maxLatencyMS) override { return 0; };
+    bool setPointsPerSecond(uint32_t pps) override;
+    // colour shift is applied before the points are sent so the node's
+    // DAC does the shifting
+    bool setColourShift(float shiftSeconds) override { return false; };
+    void setArmed(bool armed) override;
+
+    bool isReadyForFrame(int maxLatencyMS) override;
+
+    string getId() override { return nodeName + ":" + dacLabel; };
+    int getStatus() override;
+
+    const vector<ofAbstractParameter*>& getDisplayData() override;
+
+    void reset() override {};
+    void close() override;
+
+    protected :
+
+    void threadedFunction() override;
+    void sendFrameToNode(DacFrame* frame);
+    void receiveStatus();
+
+    string nodeName;
+    string ipAddress;
+    string dacLabel;
+    int dataPort;
+
+    Poco::Net::DatagramSocket socket;
+    Poco::Net::SocketAddress nodeAddress;
+    bool socketOpen = false;
+
+    ofThreadChannel<DacFrame*> frameChannel;
+    RemoteFrameEncoder encoder;
+    vector<uint8_t> receiveBuffer;
+
+    std::atomic<uint32_t> pps;
+    std::atomic<bool> remoteArmed;
+
+    // written by the thread
+    std::atomic<uint32_t> nextSequence;
+    std::atomic<int> lastFrameNumPoints;
+    std::atomic<uint64_t> lastFrameSentTime;
+    std::atomic<uint64_t> lastStatusTime;
+    std::atomic<uint32_t> statusLastSequence;
+    std::atomic<int> statusBufferedFrames;
+    std::atomic<int> statusJitterBufferMicros;
+    std::atomic<int> statusJitterMicros;
+    std::atomic<int> statusDacStatus;
+    std::atomic<uint32_t> statusFramesDropped;
+    std::atomic<uint32_t> statusFramesIncomplete;
+    std::atomic<uint32_t> framesSkipped;
+    std::atomic<uint32_t> bytesSent;
+
+    ofParameter<string> nodeNameDisplay;
+    ofParameter<int> bufferedFramesDisplay;
+    ofParameter<float> jitterDisplay;
+    ofParameter<int> framesDroppedDisplay;
+    ofParameter<int> framesIncompleteDisplay;
+
+};
+
+}
@@ -0,0 +1,19 @@
+//
+//  ofxLaserDacRemoteData.h
+//  ofxLaser
+//
+#pragma once
+
+
+namespace ofxLaser {
+
+// one of the DACs from a RemoteNode's announce packet
+struct DacRemoteData {
+    string nodeName;
+    string dacLabel;    // the DAC's label on the node, ie "EtherDream 1A2B3C"
+    string ipAddress;
+    int dataPort;
+    int dacStatus;
+    float lastUpdateTime;
+};
+}
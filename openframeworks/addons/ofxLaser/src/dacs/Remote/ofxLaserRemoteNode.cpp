@@ -0,0 +1,418 @@
+//
+//  ofxLaserRemoteNode.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserRemoteNode.h"
+
+using namespace ofxLaser;
+
+RemoteNode :: RemoteNode() {
+}
+
+RemoteNode :: ~RemoteNode() {
+    close();
+}
+
+bool RemoteNode :: setup(const RemoteNodeSettings& _settings) {
+
+    settings = _settings;
+    std::replace(settings.nodeName.begin(), settings.nodeName.end(), ' ', '-');
+
+    dacAssigner = DacAssigner::instance();
+    // we don't want to find other nodes' DACs (or our own!)
+    dacAssigner->removeManager("Remote");
+
+    try {
+        dataSocket.bind(Poco::Net::SocketAddress(settings.listenAddress, settings.dataPort), true);
+        dataSocket.setBlocking(false);
+        announceSocket.bind(Poco::Net::SocketAddress("0.0.0.0", 0), true);
+        announceSocket.setBroadcast(true);
+        socketsOpen = true;
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "RemoteNode setup failed - Network error: " + exc.displayText());
+        socketsOpen = false;
+        return false;
+    }
+
+    ofLogNotice("RemoteNode - " + settings.nodeName + " listening on port " + ofToString(settings.dataPort));
+    receiveBuffer.resize(RemoteConsts::MAX_DATAGRAM_SIZE);
+    startThread();
+    return true;
+}
+
+void RemoteNode :: close() {
+
+    if(isThreadRunning()) {
+        waitForThread(true);
+    }
+    if(socketsOpen) {
+        dataSocket.close();
+        announceSocket.close();
+        socketsOpen = false;
+    }
+    for(auto& outputpair : outputsByLabel) {
+        Output* output = outputpair.second;
+        if(output->dac!=nullptr) {
+            output->dac->setArmed(false);
+            DacData& dacData = dacAssigner->getDacDataForLabel(output->dacLabel);
+            DacManagerBase* manager = dacAssigner->getManagerForType(dacData.type);
+            if(manager!=nullptr) manager->disconnectAndDeleteDac(dacData.id);
+        }
+        for(BufferedFrame* frame : output->frames) delete frame;
+        for(BufferedFrame* frame : output->spareFrames) delete frame;
+        delete output;
+    }
+    outputsByLabel.clear();
+}
+
+void RemoteNode :: update() {
+
+    if(!socketsOpen) return;
+
+    if(dacAssigner->update()) {
+        // announce straight away so that new DACs show up quickly
+        lastAnnounceTime = 0;
+    }
+
+    // connect to the DACs that frames have arrived for
+    vector<string> labelsToConnect;
+    lock();
+    for(auto& outputpair : outputsByLabel) {
+        Output* output = outputpair.second;
+        if(output->dacRequested && (output->dac==nullptr)) {
+            labelsToConnect.push_back(output->dacLabel);
+        }
+    }
+    unlock();
+
+    for(string& label : labelsToConnect) {
+        DacData& dacData = dacAssigner->getDacDataForLabel(label);
+        if(!dacData.available) continue;
+        DacManagerBase* manager = dacAssigner->getManagerForType(dacData.type);
+        if(manager==nullptr) continue;
+        DacBase* dac = manager->getAndConnectToDac(dacData.id);
+        if(dac==nullptr) continue;
+
+        // the colour shift has already been applied by the sender
+        dac->setColourShift(0);
+        dac->maxLatencyMS = settings.dacLatencyMS;
+        ofLogNotice("RemoteNode - connected to " + label);
+
+        lock();
+        outputsByLabel[label]->dac = dac;
+        unlock();
+    }
+
+    if(ofGetElapsedTimef() - lastAnnounceTime > 1) {
+        sendAnnounce();
+        lastAnnounceTime = ofGetElapsedTimef();
+    }
+}
+
+vector<string> RemoteNode :: getAvailableDacLabels() {
+    vector<string> labels;
+    for(const DacData& dacData : dacAssigner->getDacList()) {
+        if(dacData.available && (dacData.type!="Remote")) labels.push_back(dacData.getLabel());
+    }
+    return labels;
+}
+
+void RemoteNode :: sendAnnounce() {
+
+    vector<string> labels = getAvailableDacLabels();
+
+    announceWriter.startPacket(RemoteConsts::TYPE_ANNOUNCE);
+    announceWriter.appendString(settings.nodeName);
+    announceWriter.appendUInt16(settings.dataPort);
+    announceWriter.appendUInt8(MIN((int)labels.size(), 255));
+    for(int i = 0; i<MIN((int)labels.size(), 255); i++) {
+        announceWriter.appendString(labels[i]);
+        DacData& dacData = dacAssigner->getDacDataForLabel(labels[i]);
+        DacManagerBase* manager = dacAssigner->getManagerForType(dacData.type);
+        DacBase* dac = (manager!=nullptr) ? manager->getDacById(dacData.id) : nullptr;
+        // DACs we haven't connected to yet are fine as far as we know
+        announceWriter.appendUInt8(dac!=nullptr ? dac->getStatus() : OFXLASER_DACSTATUS_GOOD);
+    }
+
+    try {
+        announceSocket.sendTo(announceWriter.getBuffer(), (int)announceWriter.size(), Poco::Net::SocketAddress("255.255.255.255", RemoteConsts::ANNOUNCE_PORT));
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_VERBOSE,  "RemoteNode announce broadcast failed - " + exc.displayText());
+    }
+    if(settings.announceLocalhost) {
+        try {
+            announceSocket.sendTo(announceWriter.getBuffer(), (int)announceWriter.size(), Poco::Net::SocketAddress("127.0.0.1", RemoteConsts::ANNOUNCE_PORT));
+        } catch (Poco::Exception& exc) {
+            ofLog(OF_LOG_VERBOSE,  "RemoteNode localhost announce failed - " + exc.displayText());
+        }
+    }
+}
+
+void RemoteNode :: threadedFunction() {
+
+    Poco::Timespan pollTime(1000); // 1ms, the playout needs to be checked often
+
+    // scheduling and CPU affinity are set in laserSettings.json
+    ThreadPolicy::apply(THREAD_ROLE_DAC, "Remote node");
+
+    while(isThreadRunning()) {
+
+        try {
+            if(dataSocket.poll(pollTime, Poco::Net::Socket::SELECT_READ)) {
+                // get everything that's waiting
+                while(dataSocket.available()>0) {
+                    Poco::Net::SocketAddress sender;
+                    int numBytes = dataSocket.receiveFrom(receiveBuffer.data(), (int)receiveBuffer.size(), sender);
+                    if(numBytes<=0) break;
+                    lock();
+                    processDatagram(receiveBuffer.data(), numBytes, sender);
+                    unlock();
+                }
+            }
+        } catch (Poco::Exception& exc) {
+            ofLog(OF_LOG_ERROR,  "RemoteNode receive failed - " + exc.displayText());
+            sleep(10);
+        }
+
+        uint64_t now = ofGetElapsedTimeMicros();
+        lock();
+        for(auto& outputpair : outputsByLabel) {
+            Output& output = *outputpair.second;
+            playFrames(output, now);
+            if(now - output.lastStatusSentTime > 100000) sendStatus(output, now);
+        }
+        unlock();
+    }
+}
+
+void RemoteNode :: processDatagram(const uint8_t* data, int length, const Poco::Net::SocketAddress& sender) {
+
+    RemotePacketReader reader(data, length);
+    if(reader.readPacketType()!=RemoteConsts::TYPE_FRAME) return;
+
+    string dacLabel = reader.readString();
+    uint32_t sequence = reader.readUInt32();
+    int fragmentIndex = reader.readUInt16();
+    int fragmentCount = reader.readUInt16();
+    if(reader.hasError() || (fragmentCount==0) || (fragmentIndex>=fragmentCount)) return;
+    // the points in the frame are checked against MAX_FRAME_POINTS when
+    // it's decoded
+    if(fragmentCount>RemoteConsts::MAX_FRAME_FRAGMENTS) return;
+
+    Output* outputptr;
+    auto it = outputsByLabel.find(dacLabel);
+    if(it==outputsByLabel.end()) {
+        ofLogNotice("RemoteNode - receiving frames for " + dacLabel + " from " + sender.host().toString());
+        outputptr = new Output();
+        outputptr->dacLabel = dacLabel;
+        outputptr->dacRequested = true;
+        outputsByLabel[dacLabel] = outputptr;
+    } else {
+        outputptr = it->second;
+    }
+    Output& output = *outputptr;
+
+    // a new sender, or the app was restarted, so start again
+    bool restarted = output.sequenceValid && ((int32_t)(sequence - output.lastPlayedSequence) < -1000);
+    if(restarted || (output.senderAddress != sender)) {
+        if(output.status.framesReceived>0) ofLogNotice("RemoteNode - new stream for " + dacLabel + " from " + sender.toString());
+        for(BufferedFrame* frame : output.frames) releaseFrame(output, frame);
+        output.frames.clear();
+        output.fragmentCount = 0;
+        output.sequenceValid = false;
+        output.transitValid = false;
+        output.status = RemoteDacStatus();
+        output.senderAddress = sender;
+    }
+
+    // too old, we've already played something newer
+    if(output.sequenceValid && ((int32_t)(sequence - output.lastPlayedSequence) <= 0)) return;
+
+    if(fragmentCount==1) {
+        processFrame(output, sequence, reader.getRemaining(), reader.getNumRemaining());
+        return;
+    }
+
+    // a new frame, anything left of the last one is abandoned
+    // (and counted as lost when the next frame completes)
+    if((sequence!=output.fragmentSequence) || (fragmentCount!=output.fragmentCount)) {
+        output.fragmentSequence = sequence;
+        output.fragmentCount = fragmentCount;
+        output.fragmentsReceived = 0;
+        output.fragmentReceived.assign(fragmentCount, false);
+        output.fragments.resize(fragmentCount);
+    }
+    if(output.fragmentReceived[fragmentIndex]) return;
+
+    output.fragments[fragmentIndex].assign(reader.getRemaining(), reader.getRemaining() + reader.getNumRemaining());
+    output.fragmentReceived[fragmentIndex] = true;
+    output.fragmentsReceived++;
+
+    if(output.fragmentsReceived==output.fragmentCount) {
+        output.payload.clear();
+        for(vector<uint8_t>& fragment : output.fragments) {
+            output.payload.insert(output.payload.end(), fragment.begin(), fragment.end());
+        }
+        processFrame(output, sequence, output.payload.data(), output.payload.size());
+        output.fragmentCount = 0;
+    }
+}
+
+void RemoteNode :: processFrame(Output& output, uint32_t sequence, const uint8_t* data, size_t length) {
+
+    uint64_t now = ofGetElapsedTimeMicros();
+
+    BufferedFrame* frame = getSpareFrame(output);
+    if(!decoder.decode(data, length, frame->points)) {
+        releaseFrame(output, frame);
+        return;
+    }
+
+    updateTiming(output, decoder.timestampMicros, now);
+
+    frame->sequence = sequence;
+    frame->pps = decoder.pps;
+    frame->armed = decoder.armed;
+    frame->playTime = decoder.timestampMicros + output.minTransit + output.status.jitterBufferMicros;
+    output.status.framesReceived++;
+    // count the frames that never arrived, a late one fills its gap back in
+    if(output.status.framesReceived==1) {
+        output.status.lastSequence = sequence;
+    } else if((int32_t)(sequence - output.status.lastSequence) > 0) {
+        output.status.framesIncomplete += sequence - output.status.lastSequence - 1;
+        output.status.lastSequence = sequence;
+    } else if(output.status.framesIncomplete>0) {
+        output.status.framesIncomplete--;
+    }
+
+    // keep the frames in order in case the network swapped them
+    auto insertPosition = output.frames.end();
+    while((insertPosition!=output.frames.begin()) && ((int32_t)((*(insertPosition-1))->sequence - sequence) > 0)) {
+        insertPosition--;
+    }
+    output.frames.insert(insertPosition, frame);
+
+    // don't let the buffer grow forever if the DAC isn't taking frames
+    while((int)output.frames.size() > settings.maxBufferedFrames) {
+        releaseFrame(output, output.frames.front());
+        output.frames.pop_front();
+        output.status.framesDropped++;
+    }
+}
+
+void RemoteNode :: updateTiming(Output& output, uint64_t timestamp, uint64_t now) {
+
+    // our clock minus the sender's clock plus the network delay
+    int64_t transit = (int64_t)now - (int64_t)timestamp;
+
+    if(!output.transitValid) {
+        output.minTransit = output.windowMinTransit = output.lastWindowMinTransit = transit;
+        output.windowStartTime = now;
+        output.lastTransit = transit;
+        output.jitter = 0;
+        output.transitValid = true;
+    }
+
+    // RFC 3550 style jitter
+    float difference = fabs((float)(transit - output.lastTransit));
+    output.jitter += (difference - output.jitter) / 16.0f;
+    output.lastTransit = transit;
+
+    // the lowest transit time is the network delay with no queueing.
+    // It's tracked over two 5 second windows so that it follows any
+    // drift between the clocks
+    output.windowMinTransit = MIN(output.windowMinTransit, transit);
+    if(now - output.windowStartTime > 5000000) {
+        output.lastWindowMinTransit = output.windowMinTransit;
+        output.windowMinTransit = transit;
+        output.windowStartTime = now;
+    }
+    output.minTransit = MIN(output.windowMinTransit, output.lastWindowMinTransit);
+
+    output.status.jitterMicros = (uint32_t)output.jitter;
+    int jitterBufferMicros = ofClamp(output.jitter * 4, settings.minJitterBufferMS * 1000, settings.maxJitterBufferMS * 1000);
+    output.status.jitterBufferMicros = jitterBufferMicros;
+}
+
+void RemoteNode :: playFrames(Output& output, uint64_t now) {
+
+    // if more than one frame is due, only the newest one matters
+    while((output.frames.size()>1) && (output.frames[1]->playTime <= now)) {
+        releaseFrame(output, output.frames.front());
+        output.frames.pop_front();
+        output.status.framesDropped++;
+    }
+    if(output.frames.empty()) return;
+
+    BufferedFrame* frame = output.frames.front();
+    if((frame->playTime > now) || (output.dac==nullptr)) return;
+    if(!output.dac->isReadyForFrame(settings.dacLatencyMS)) return;
+
+    if(frame->pps!=output.pps) {
+        output.dac->setPointsPerSecond(frame->pps);
+        output.pps = frame->pps;
+    }
+    if(frame->armed!=output.armed) {
+        output.dac->setArmed(frame->armed);
+        output.armed = frame->armed;
+    }
+    output.dac->sendFrame(frame->points);
+
+    output.lastPlayedSequence = frame->sequence;
+    output.sequenceValid = true;
+    output.status.framesPlayed++;
+
+    output.frames.pop_front();
+    releaseFrame(output, frame);
+
+    // let the sender know straight away so it can send the next one
+    sendStatus(output, now);
+}
+
+void RemoteNode :: sendStatus(Output& output, uint64_t now) {
+
+    output.lastStatusSentTime = now;
+    if(output.senderAddress.port()==0) return;
+
+    output.status.bufferedFrames = (uint16_t)output.frames.size();
+    output.status.dacStatus = (output.dac!=nullptr) ? output.dac->getStatus() : OFXLASER_DACSTATUS_NO_DAC;
+    output.status.serialize(statusWriter, output.dacLabel);
+
+    try {
+        dataSocket.sendTo(statusWriter.getBuffer(), (int)statusWriter.size(), output.senderAddress);
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_VERBOSE,  "RemoteNode status send failed - " + exc.displayText());
+    }
+}
+
+vector<RemoteNodeOutputInfo> RemoteNode :: getOutputInfo() {
+    vector<RemoteNodeOutputInfo> info;
+    lock();
+    for(auto& outputpair : outputsByLabel) {
+        Output& output = *outputpair.second;
+        info.emplace_back();
+        RemoteNodeOutputInfo& outputInfo = info.back();
+        outputInfo.dacLabel = output.dacLabel;
+        outputInfo.senderAddress = output.senderAddress.toString();
+        outputInfo.hasDac = output.dac!=nullptr;
+        outputInfo.status = output.status;
+        outputInfo.status.bufferedFrames = (uint16_t)output.frames.size();
+        outputInfo.pps = output.pps;
+        outputInfo.armed = output.armed;
+        outputInfo.transitSpreadMS = (output.lastTransit - output.minTransit) / 1000.0f;
+    }
+    unlock();
+    return info;
+}
+
+RemoteNode::BufferedFrame* RemoteNode :: getSpareFrame(Output& output) {
+    if(output.spareFrames.empty()) return new BufferedFrame();
+    BufferedFrame* frame = output.spareFrames.back();
+    output.spareFrames.pop_back();
+    return frame;
+}
+
+void RemoteNode :: releaseFrame(Output& output, BufferedFrame* frame) {
+    output.spareFrames.push_back(frame);
+}
@@ -0,0 +1,149 @@
+//
+//  ofxLaserRemoteNode.h
+//  ofxLaser
+//
+// A headless output node. It runs on a computer near the lasers, finds
+// the local DACs with the usual DacAssigner and announces them on the
+// network. A laser app sees them as "Remote" DACs (see DacRemote) and
+// sends them its finished frames.
+//
+// Frames go into a jitter buffer for each DAC. A frame's play time is
+// its timestamp converted to our clock (using the lowest transit time
+// we've seen, so the clocks don't need to be synchronised) plus the
+// jitter buffer time. The buffer grows and shrinks with the measured
+// network jitter between minJitterBufferMS and maxJitterBufferMS.
+//
+// Call update() from the main thread, the DAC connections are made
+// there. The network and the frame playout happen in a thread.
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxLaserDacAssigner.h"
+#include "ofxLaserRemoteProtocol.h"
+#include "ofxLaserThreadPolicy.h"
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+
+namespace ofxLaser {
+
+struct RemoteNodeSettings {
+    // spaces are replaced with - because the laser app uses the first
+    // space in a DAC label to find its type
+    string nodeName = "ofxLaserNode";
+    string listenAddress = "0.0.0.0";
+    int dataPort = RemoteConsts::DATA_PORT;
+    // also announce to localhost, for testing on one computer
+    bool announceLocalhost = true;
+    int minJitterBufferMS = 20;
+    int maxJitterBufferMS = 200;
+    // passed to the DAC's isReadyForFrame
+    int dacLatencyMS = 100;
+    // frames beyond this are dropped, oldest first
+    int maxBufferedFrames = 16;
+};
+
+// a copy of an output's state for display
+struct RemoteNodeOutputInfo {
+    string dacLabel;
+    string senderAddress;
+    bool hasDac;
+    RemoteDacStatus status;
+    int pps;
+    bool armed;
+    float transitSpreadMS;
+};
+
+class RemoteNode : public ofThread {
+
+    public :
+
+    RemoteNode();
+    ~RemoteNode();
+
+    bool setup(const RemoteNodeSettings& settings);
+    void update();
+    void close();
+
+    vector<RemoteNodeOutputInfo> getOutputInfo();
+    vector<string> getAvailableDacLabels();
+    const RemoteNodeSettings& getSettings() { return settings; };
+
+    protected :
+
+    struct BufferedFrame {
+        uint32_t sequence;
+        uint64_t playTime;
+        uint32_t pps;
+        bool armed;
+        vector<Point> points;
+    };
+
+    struct Output {
+        string dacLabel;
+        DacBase* dac = nullptr;
+        bool dacRequested = false;
+        Poco::Net::SocketAddress senderAddress;
+
+        // reassembly of the current frame
+        uint32_t fragmentSequence = 0;
+        int fragmentCount = 0;
+        int fragmentsReceived = 0;
+        vector<bool> fragmentReceived;
+        vector<vector<uint8_t>> fragments;
+        vector<uint8_t> payload;
+
+        // received frames waiting to be played, in sequence order
+        deque<BufferedFrame*> frames;
+        vector<BufferedFrame*> spareFrames;
+        uint32_t lastPlayedSequence = 0;
+        bool sequenceValid = false;
+
+        // timing, in microseconds
+        bool transitValid = false;
+        int64_t minTransit = 0;
+        int64_t windowMinTransit = 0;
+        int64_t lastWindowMinTransit = 0;
+        uint64_t windowStartTime = 0;
+        int64_t lastTransit = 0;
+        float jitter = 0;
+
+        uint32_t pps = 0;
+        bool armed = false;
+
+        RemoteDacStatus status;
+        uint64_t lastStatusSentTime = 0;
+    };
+
+    void threadedFunction() override;
+
+    void processDatagram(const uint8_t* data, int length, const Poco::Net::SocketAddress& sender);
+    void processFrame(Output& output, uint32_t sequence, const uint8_t* data, size_t length);
+    void updateTiming(Output& output, uint64_t timestamp, uint64_t now);
+    void playFrames(Output& output, uint64_t now);
+    void sendStatus(Output& output, uint64_t now);
+    void sendAnnounce();
+
+    BufferedFrame* getSpareFrame(Output& output);
+    void releaseFrame(Output& output, BufferedFrame* frame);
+
+    RemoteNodeSettings settings;
+    DacAssigner* dacAssigner = nullptr;
+
+    Poco::Net::DatagramSocket dataSocket;
+    Poco::Net::DatagramSocket announceSocket;
+    bool socketsOpen = false;
+    vector<uint8_t> receiveBuffer;
+    RemotePacketWriter statusWriter;
+    RemotePacketWriter announceWriter;
+    RemoteFrameDecoder decoder;
+
+    map<string, Output*> outputsByLabel;
+
+    float lastAnnounceTime = 0;
+
+};
+
+}
@@ -0,0 +1,255 @@
+//
+//  ofxLaserRemoteProtocol.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserRemoteProtocol.h"
+
+using namespace ofxLaser;
+
+// ------------------------------------------------------------ writer
+
+void RemotePacketWriter :: startPacket(uint8_t type) {
+    clear();
+    appendUInt8(RemoteConsts::MAGIC_0);
+    appendUInt8(RemoteConsts::MAGIC_1);
+    appendUInt8(RemoteConsts::VERSION);
+    appendUInt8(type);
+}
+
+void RemotePacketWriter :: appendUInt8(uint8_t n) {
+    ensureSpace(1);
+    buffer[index++] = n;
+}
+
+void RemotePacketWriter :: appendUInt16(uint16_t n) {
+    ensureSpace(2);
+    buffer[index++] = (n>>8) & 0xff;
+    buffer[index++] = n & 0xff;
+}
+
+void RemotePacketWriter :: appendUInt32(uint32_t n) {
+    ensureSpace(4);
+    for(int shift = 24; shift>=0; shift-=8) {
+        buffer[index++] = (n>>shift) & 0xff;
+    }
+}
+
+void RemotePacketWriter :: appendUInt64(uint64_t n) {
+    ensureSpace(8);
+    for(int shift = 56; shift>=0; shift-=8) {
+        buffer[index++] = (n>>shift) & 0xff;
+    }
+}
+
+void RemotePacketWriter :: appendVarint(uint64_t n) {
+    ensureSpace(10);
+    while(n>=0x80) {
+        buffer[index++] = (n & 0x7f) | 0x80;
+        n>>=7;
+    }
+    buffer[index++] = (uint8_t)n;
+}
+
+void RemotePacketWriter :: appendSignedVarint(int64_t n) {
+    appendVarint(((uint64_t)n << 1) ^ (uint64_t)(n >> 63));
+}
+
+void RemotePacketWriter :: appendString(const string& s) {
+    size_t length = MIN(s.size(), (size_t)255);
+    appendUInt8((uint8_t)length);
+    appendBytes((const uint8_t*)s.data(), length);
+}
+
+void RemotePacketWriter :: appendBytes(const uint8_t* bytes, size_t length) {
+    ensureSpace(length);
+    memcpy(buffer.data()+index, bytes, length);
+    index+=length;
+}
+
+// ------------------------------------------------------------ reader
+
+RemotePacketReader :: RemotePacketReader(const uint8_t* _data, size_t _length) : data(_data), length(_length) {
+}
+
+uint8_t RemotePacketReader :: readPacketType() {
+    if(!check(4)) return 0;
+    if((data[0]!=RemoteConsts::MAGIC_0) || (data[1]!=RemoteConsts::MAGIC_1) || (data[2]!=RemoteConsts::VERSION)) {
+        error = true;
+        return 0;
+    }
+    index = 4;
+    return data[3];
+}
+
+uint8_t RemotePacketReader :: readUInt8() {
+    if(!check(1)) return 0;
+    return data[index++];
+}
+
+uint16_t RemotePacketReader :: readUInt16() {
+    if(!check(2)) return 0;
+    uint16_t n = (data[index]<<8) | data[index+1];
+    index+=2;
+    return n;
+}
+
+uint32_t RemotePacketReader :: readUInt32() {
+    if(!check(4)) return 0;
+    uint32_t n = 0;
+    for(int i = 0; i<4; i++) n = (n<<8) | data[index++];
+    return n;
+}
+
+uint64_t RemotePacketReader :: readUInt64() {
+    if(!check(8)) return 0;
+    uint64_t n = 0;
+    for(int i = 0; i<8; i++) n = (n<<8) | data[index++];
+    return n;
+}
+
+uint64_t RemotePacketReader :: readVarint() {
+    uint64_t n = 0;
+    for(int shift = 0; shift<64; shift+=7) {
+        if(!check(1)) return 0;
+        uint8_t byte = data[index++];
+        n |= (uint64_t)(byte & 0x7f) << shift;
+        if((byte & 0x80)==0) return n;
+    }
+    // too many bytes
+    error = true;
+    return 0;
+}
+
+int64_t RemotePacketReader :: readSignedVarint() {
+    uint64_t n = readVarint();
+    return (int64_t)(n >> 1) ^ -(int64_t)(n & 1);
+}
+
+string RemotePacketReader :: readString() {
+    size_t stringLength = readUInt8();
+    if(!check(stringLength)) return "";
+    string s((const char*)data+index, stringLength);
+    index+=stringLength;
+    return s;
+}
+
+// ------------------------------------------------------------ frames
+
+void RemoteFrameEncoder :: encode(const string& dacLabel, uint32_t sequence, uint64_t timestampMicros, uint32_t pps, bool armed, const vector<Point*>& points) {
+
+    payload.clear();
+    payload.appendUInt64(timestampMicros);
+    payload.appendVarint(pps);
+    payload.appendUInt8(armed ? RemoteConsts::FRAME_FLAG_ARMED : 0);
+    payload.appendVarint(points.size());
+
+    int32_t lastX = 0, lastY = 0, lastR = 0, lastG = 0, lastB = 0;
+    for(Point* point : points) {
+        int32_t x = (int32_t)roundf(point->x * RemoteConsts::POSITION_SCALE);
+        int32_t y = (int32_t)roundf(point->y * RemoteConsts::POSITION_SCALE);
+        int32_t r = (int32_t)roundf(ofClamp(point->r, 0, 255) * RemoteConsts::COLOUR_SCALE);
+        int32_t g = (int32_t)roundf(ofClamp(point->g, 0, 255) * RemoteConsts::COLOUR_SCALE);
+        int32_t b = (int32_t)roundf(ofClamp(point->b, 0, 255) * RemoteConsts::COLOUR_SCALE);
+        payload.appendSignedVarint(x - lastX);
+        payload.appendSignedVarint(y - lastY);
+        payload.appendSignedVarint(r - lastR);
+        payload.appendSignedVarint(g - lastG);
+        payload.appendSignedVarint(b - lastB);
+        lastX = x; lastY = y; lastR = r; lastG = g; lastB = b;
+    }
+
+    // now split the payload up, every fragment gets the full header
+    size_t headerSize = 4 + 1 + MIN(dacLabel.size(), (size_t)255) + 4 + 2 + 2;
+    size_t fragmentSize = RemoteConsts::MAX_DATAGRAM_SIZE - headerSize;
+    int fragmentCount = MAX(1, (int)((payload.size() + fragmentSize - 1) / fragmentSize));
+
+    datagrams.clear();
+    datagramEnds.clear();
+    for(int i = 0; i<fragmentCount; i++) {
+        size_t start = i*fragmentSize;
+        size_t length = MIN(fragmentSize, payload.size() - start);
+        datagrams.appendUInt8(RemoteConsts::MAGIC_0);
+        datagrams.appendUInt8(RemoteConsts::MAGIC_1);
+        datagrams.appendUInt8(RemoteConsts::VERSION);
+        datagrams.appendUInt8(RemoteConsts::TYPE_FRAME);
+        datagrams.appendString(dacLabel);
+        datagrams.appendUInt32(sequence);
+        datagrams.appendUInt16(i);
+        datagrams.appendUInt16(fragmentCount);
+        datagrams.appendBytes(payload.getBuffer()+start, length);
+        datagramEnds.push_back(datagrams.size());
+    }
+}
+
+const uint8_t* RemoteFrameEncoder :: getDatagram(int i) {
+    size_t start = (i==0) ? 0 : datagramEnds[i-1];
+    return datagrams.getBuffer() + start;
+}
+
+size_t RemoteFrameEncoder :: getDatagramSize(int i) {
+    size_t start = (i==0) ? 0 : datagramEnds[i-1];
+    return datagramEnds[i] - start;
+}
+
+bool RemoteFrameDecoder :: decode(const uint8_t* data, size_t length, vector<Point>& points) {
+
+    RemotePacketReader reader(data, length);
+    timestampMicros = reader.readUInt64();
+    pps = (uint32_t)reader.readVarint();
+    armed = (reader.readUInt8() & RemoteConsts::FRAME_FLAG_ARMED) != 0;
+    uint64_t numPoints = reader.readVarint();
+    // every point takes at least 5 bytes, so this stops a bad
+    // packet from allocating a huge vector (divided rather than
+    // multiplied so a huge count can't wrap around)
+    if(reader.hasError() || (numPoints > reader.getNumRemaining()/5) || (numPoints > RemoteConsts::MAX_FRAME_POINTS)) return false;
+
+    points.resize(numPoints);
+    int32_t x = 0, y = 0, r = 0, g = 0, b = 0;
+    const float positionScale = 1.0f / RemoteConsts::POSITION_SCALE;
+    const float colourScale = 1.0f / RemoteConsts::COLOUR_SCALE;
+    for(Point& point : points) {
+        x += (int32_t)reader.readSignedVarint();
+        y += (int32_t)reader.readSignedVarint();
+        r += (int32_t)reader.readSignedVarint();
+        g += (int32_t)reader.readSignedVarint();
+        b += (int32_t)reader.readSignedVarint();
+        point.x = x * positionScale;
+        point.y = y * positionScale;
+        point.z = 0;
+        point.r = r * colourScale;
+        point.g = g * colourScale;
+        point.b = b * colourScale;
+    }
+    return !reader.hasError();
+}
+
+// ------------------------------------------------------------ status
+
+void RemoteDacStatus :: serialize(RemotePacketWriter& writer, const string& dacLabel) {
+    writer.startPacket(RemoteConsts::TYPE_STATUS);
+    writer.appendString(dacLabel);
+    writer.appendUInt32(framesReceived);
+    writer.appendUInt32(framesPlayed);
+    writer.appendUInt32(framesDropped);
+    writer.appendUInt32(framesIncomplete);
+    writer.appendUInt16(bufferedFrames);
+    writer.appendUInt32(jitterBufferMicros);
+    writer.appendUInt32(jitterMicros);
+    writer.appendUInt8(dacStatus);
+    writer.appendUInt32(lastSequence);
+}
+
+bool RemoteDacStatus :: deserialize(RemotePacketReader& reader, string& dacLabel) {
+    dacLabel = reader.readString();
+    framesReceived = reader.readUInt32();
+    framesPlayed = reader.readUInt32();
+    framesDropped = reader.readUInt32();
+    framesIncomplete = reader.readUInt32();
+    bufferedFrames = reader.readUInt16();
+    jitterBufferMicros = reader.readUInt32();
+    jitterMicros = reader.readUInt32();
+    dacStatus = reader.readUInt8();
+    lastSequence = reader.readUInt32();
+    return !reader.hasError();
+}
@@ -0,0 +1,168 @@
+//
+//  ofxLaserRemoteProtocol.h
+//  ofxLaser
+//
+// The protocol between a laser app and a remote output node (see
+// RemoteNode). Everything is UDP, multi-byte values are big endian.
+//
+// Every packet starts with 'o' 'L', the version and the packet type.
+//
+// ANNOUNCE  node -> broadcast, once a second
+//           nodeName, dataPort u16, numDacs u8, (dacLabel, status u8) x n
+// FRAME     app -> node, one or more fragments per frame
+//           dacLabel, sequence u32, fragmentIndex u16, fragmentCount u16
+//           then this fragment of the frame payload :
+//             timestamp u64 (sender's clock in microseconds)
+//             pps varint, flags u8, numPoints varint, points
+// STATUS    node -> app, every 50ms for each DAC that's receiving frames
+//
+// Points are delta encoded against the previous point as zigzag varints :
+// x and y in 1/64ths of a pixel, r g b in 1/256ths. Consecutive laser
+// points are close together so most points take 5 to 7 bytes.
+//
+// Strings are a u8 length followed by the characters.
+
+#pragma once
+#include "ofMain.h"
+#include "ofxLaserPoint.h"
+#include "ofxLaserDacBase.h"
+
+namespace ofxLaser {
+
+class RemoteConsts {
+    public :
+    static const int ANNOUNCE_PORT = 7730;
+    static const int DATA_PORT = 7731;
+
+    static const uint8_t MAGIC_0 = 'o';
+    static const uint8_t MAGIC_1 = 'L';
+    static const uint8_t VERSION = 1;
+
+    static const uint8_t TYPE_ANNOUNCE = 0x01;
+    static const uint8_t TYPE_FRAME = 0x02;
+    static const uint8_t TYPE_STATUS = 0x03;
+
+    static const uint8_t FRAME_FLAG_ARMED = 0x01;
+
+    // stays under the ethernet MTU
+    static const int MAX_DATAGRAM_SIZE = 1400;
+    // frames bigger than this are dropped by the node, so a bad packet
+    // can't make it allocate a huge buffer (a second at 100k pps, and
+    // room for it at 10 bytes a point)
+    static const int MAX_FRAME_POINTS = 100000;
+    static const int MAX_FRAME_FRAGMENTS = 1024;
+
+    static const int POSITION_SCALE = 64;
+    static const int COLOUR_SCALE = 256;
+};
+
+// Writes into a buffer that grows as needed but is never shrunk, so
+// once it's warmed up there's no allocation
+class RemotePacketWriter {
+    public :
+
+    void clear() { index = 0; };
+    void startPacket(uint8_t type);
+
+    void appendUInt8(uint8_t n);
+    void appendUInt16(uint16_t n);
+    void appendUInt32(uint32_t n);
+    void appendUInt64(uint64_t n);
+    void appendVarint(uint64_t n);
+    // zigzag encoded so small negative numbers are small too
+    void appendSignedVarint(int64_t n);
+    void appendString(const string& s);
+    void appendBytes(const uint8_t* bytes, size_t length);
+
+    const uint8_t* getBuffer() const { return buffer.data(); };
+    size_t size() const { return index; };
+
+    protected :
+    inline void ensureSpace(size_t bytes) {
+        if(index + bytes > buffer.size()) buffer.resize(MAX(buffer.size()*2, index + bytes + 1024));
+    }
+    vector<uint8_t> buffer;
+    size_t index = 0;
+};
+
+// Reads a packet, if anything runs off the end then hasError is set
+// and everything else returns 0
+class RemotePacketReader {
+    public :
+    RemotePacketReader(const uint8_t* data, size_t length);
+
+    // checks the magic and version and returns the packet type, or 0
+    uint8_t readPacketType();
+
+    uint8_t readUInt8();
+    uint16_t readUInt16();
+    uint32_t readUInt32();
+    uint64_t readUInt64();
+    uint64_t readVarint();
+    int64_t readSignedVarint();
+    string readString();
+    const uint8_t* getRemaining() { return data + index; };
+    size_t getNumRemaining() { return error ? 0 : length - index; };
+
+    bool hasError() { return error; };
+
+    protected :
+    inline bool check(size_t bytes) {
+        if(error || (index + bytes > length)) {
+            error = true;
+            return false;
+        }
+        return true;
+    }
+    const uint8_t* data;
+    size_t length;
+    size_t index = 0;
+    bool error = false;
+};
+
+// Encodes a frame and splits it into datagrams
+class RemoteFrameEncoder {
+    public :
+
+    void encode(const string& dacLabel, uint32_t sequence, uint64_t timestampMicros, uint32_t pps, bool armed, const vector<Point*>& points);
+
+    int getNumDatagrams() { return (int)datagramEnds.size(); };
+    const uint8_t* getDatagram(int i);
+    size_t getDatagramSize(int i);
+    // the size of the encoded points, for stats
+    size_t getPayloadSize() { return payload.size(); };
+
+    protected :
+    RemotePacketWriter payload;
+    RemotePacketWriter datagrams;
+    vector<size_t> datagramEnds;
+};
+
+// Decodes a complete frame payload (the fragments joined together)
+class RemoteFrameDecoder {
+    public :
+    bool decode(const uint8_t* data, size_t length, vector<Point>& points);
+
+    uint64_t timestampMicros = 0;
+    uint32_t pps = 0;
+    bool armed = false;
+};
+
+// the status of one of the node's DACs, sent back to the app
+struct RemoteDacStatus {
+    uint32_t framesReceived = 0;
+    uint32_t framesPlayed = 0;
+    uint32_t framesDropped = 0;
+    uint32_t framesIncomplete = 0;
+    uint16_t bufferedFrames = 0;
+    uint32_t jitterBufferMicros = 0;
+    uint32_t jitterMicros = 0;
+    uint8_t dacStatus = OFXLASER_DACSTATUS_NO_DAC;
+    uint32_t lastSequence = 0;
+
+    void serialize(RemotePacketWriter& writer, const string& dacLabel);
+    // reader should be just after the packet type
+    bool deserialize(RemotePacketReader& reader, string& dacLabel);
+};
+
+}
@@ -85,6 +85,8 @@ DacAssigner :: DacAssigner() {
     dacManagers.push_back(new DacManagerHelios());
     dacManagers.push_back(new DacManagerEtherDream());
     dacManagers.push_back(new DacManagerLaserDockNet());
+    dacManagers.push_back(new DacManagerIDN());
+    dacManagers.push_back(new DacManagerRemote());
     updateDacList();
 	
 }
@@ -330,6 +332,25 @@ DacManagerBase* DacAssigner :: getManagerForType(string type){
     
 }
 
+bool DacAssigner :: removeManager(string type){
+    for(size_t i = 0; i<dacManagers.size(); i++) {
+        DacManagerBase* manager = dacManagers[i];
+        if(manager->getType() != type) continue;
+        
+        // forget about any of its DACs that aren't in use
+        for(int j = (int)dacDataList.size()-1; j>=0; j--) {
+            if((dacDataList[j].type == type) && (dacDataList[j].assignedLaser==nullptr)) {
+                dacDataList.erase(dacDataList.begin()+j);
+            }
+        }
+        manager->exit();
+        delete manager;
+        dacManagers.erase(dacManagers.begin()+i);
+        return true;
+    }
+    return false;
+}
+
 DacData& DacAssigner ::getDacDataForLabel(const string& label){
     for(DacData& dacData : dacDataList) {
         if(dacData.getLabel() == label) {
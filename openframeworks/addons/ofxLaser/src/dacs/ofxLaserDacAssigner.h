@@ -35,6 +35,8 @@
 #include "ofxLaserDacManagerLaserDockNet.h"
 #include "ofxLaserDacManagerEtherDream.h"
 #include "ofxLaserDacManagerHelios.h"
+#include "ofxLaserDacManagerIDN.h"
+#include "ofxLaserDacManagerRemote.h"
 #include "ofxLaserDacAliasManager.h"
 
 namespace ofxLaser {
@@ -64,6 +66,9 @@ class DacAssigner {
     DacData& getDacDataForLaser(Laser& laser);
     
     DacManagerBase* getManagerForType(string type); 
+    // deletes the manager, for apps that shouldn't look for a type
+    // of DAC (a RemoteNode doesn't use Remote DACs)
+    bool removeManager(string type);
 
     vector<DacManagerBase*> dacManagers;
     vector<DacData> dacDataList;
@@ -5,7 +5,21 @@ using namespace ofxLaser;
 void DacBase::setArmed(bool _armed){
    armed = _armed;
 };
+void DacBase::setAutoLatency(bool enabled, float targetUnderrunProbability){
+    autoLatency = enabled;
+};
+bool DacBase::sendSyncedFrame(const vector<Point>& points, uint64_t presentationTimeMicros, int toleranceMicros){
+    return sendFrame(points);
+};
 const vector<ofAbstractParameter*>& DacBase::getDisplayData() {
     return displayData;
     
 };
+
+void DacBase::logNotice(const char* format, ...){
+    if(!logging) return;
+    va_list args;
+    va_start(args, format);
+    AsyncLog::logv(OF_LOG_NOTICE, LOG_CATEGORY_DAC, format, args);
+    va_end(args);
+}
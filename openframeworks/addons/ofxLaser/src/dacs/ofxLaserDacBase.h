@@ -8,6 +8,7 @@
 
 #pragma once
 #include "ofxLaserPoint.h"
+#include "ofxLaserAsyncLog.h"
 
 #define OFXLASER_DACSTATUS_GOOD 0
 #define OFXLASER_DACSTATUS_WARNING 1
@@ -23,7 +24,15 @@ namespace ofxLaser {
         ~DacBase() {}; 
 		
 		virtual bool sendFrame(const vector<Point>& points)  = 0;
+        // for lasers in a sync group, the DAC should aim to start
+        // outputting the frame at presentationTimeMicros, within
+        // toleranceMicros. DACs that can't do that just send the frame.
+        virtual bool sendSyncedFrame(const vector<Point>& points, uint64_t presentationTimeMicros, int toleranceMicros);
 		virtual bool sendPoints(const vector<Point>& points)  = 0;
+        // when streaming points with sendPoints, how many more the DAC
+        // will take before it's holding maxLatencyMS worth. -1 if the DAC
+        // can't tell, in which case send them at the point rate.
+        virtual int getPointStreamSpace(int maxLatencyMS) { return -1; };
 		virtual bool setPointsPerSecond(uint32_t pps)  = 0;
         virtual bool setColourShift(float shiftSeconds) = 0;
 		virtual string getId() = 0;
@@ -56,12 +65,38 @@ namespace ofxLaser {
         virtual bool isReadyForFrame(int maxLatencyMS){
             return true;
         }
+        // for frames sent with a presentation time horizonMS from now.
+        // The DAC should keep that much queued rather than its own
+        // latency, or it pads every frame out to it with blank points.
+        // maxLatencyMS is still its own latency (see getLatencyMS).
+        virtual bool isReadyForTimedFrame(int maxLatencyMS, int horizonMS){
+            return isReadyForFrame(maxLatencyMS);
+        }
+        // if autoLatency is on, the DAC finds its own latency and
+        // ignores the one passed into isReadyForFrame
+        virtual void setAutoLatency(bool enabled, float targetUnderrunProbability);
+        bool getAutoLatency() { return autoLatency; };
+        // auto latency needs the DAC to report how full its buffer is,
+        // DACs that don't always use the latency they're given
+        virtual bool canAutoLatency() { return false; };
+        // the latency the DAC is actually using
+        virtual int getLatencyMS() { return maxLatencyMS; };
+        // how long until a frame sent now would start being drawn, from
+        // everything queued ahead of it. -1 if the DAC can't tell.
+        virtual int getQueuedMicros() { return -1; };
         
+        // these go through AsyncLog so they don't hold up the DAC thread
         void logNotice(const string& msg) {
             if(logging) {
-                ofLogNotice() << msg;
+                AsyncLog::log(OF_LOG_NOTICE, LOG_CATEGORY_DAC, msg);
             }
         }
+        // printf style, so nothing is formatted unless logging is on
+        void logNotice(const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+            __attribute__((format(printf, 2, 3)))
+#endif
+            ;
         
         
         int maxLatencyMS;
@@ -83,6 +118,7 @@ namespace ofxLaser {
 		bool resetFlag = false;
         bool armed = false;
         bool frameMode = true;
+        bool autoLatency = false;
         //string alias = "";
         
         float colourShift = 0;
@@ -12,10 +12,12 @@ using namespace ofxLaser;
 
 
 bool DacBaseThreaded :: sendFrame(const vector<Point>& points){
+    return sendSyncedFrame(points, 0, 0);
+}
+
+bool DacBaseThreaded :: sendSyncedFrame(const vector<Point>& points, uint64_t presentationTimeMicros, int toleranceMicros){
 
     if(!isThreadRunning()) return false; 
-//    stateRecorder.update();
-//    frameRecorder.update();
 
     if((!frameMode) && lock()) {
         frameMode = true;
@@ -24,6 +26,8 @@ bool DacBaseThreaded :: sendFrame(const vector<Point>& points){
     }
     
     DacFrame* frame = new DacFrame(ofGetElapsedTimeMicros());
+    frame->presentationTime = presentationTimeMicros;
+    frame->syncToleranceMicros = toleranceMicros;
         
     // add the points to the frame
     for(size_t i= 0; i<points.size(); i++) {
@@ -38,23 +42,41 @@ bool DacBaseThreaded :: sendFrame(const vector<Point>& points){
 
 bool DacBaseThreaded:: sendPoints(const vector<Point>& points){
     
-    //stateRecorder.update();
- 
-    if(bufferedPoints.size()>pps*0.5) {
-        return false;
-    }
+    if(!isThreadRunning()) return false;
     
+    bool accepted = false;
     if(lock()) {
-        frameMode = false;
-        for(const Point& p: points) {
-            addPointToBuffer(p);
+        // the size has to be checked inside the lock as the thread
+        // is taking points out
+        size_t maxPoints = newPPS/2;
+        if(bufferedPoints.empty() || (bufferedPoints.size() + points.size() <= maxPoints)) {
+            frameMode = false;
+            for(const Point& p: points) {
+                addPointToBuffer(p);
+            }
+            accepted = true;
+        } else {
+            streamPointsRejected+=points.size();
         }
         unlock();
     }
-    return true;
+    return accepted;
   
 }
 
+int DacBaseThreaded :: getPointStreamSpace(int maxlatencyms) {
+    int space = 0;
+    if(lock()) {
+        if(autoLatency) maxlatencyms = latencyTuner.getLatencyMS();
+        maxLatencyMS = maxlatencyms;
+        // same target as isReadyForFrame but in points rather than frames
+        int targetPoints = MAX(minPacketDataSize, (maxlatencyms+calculationTimeMS)*(int)newPPS/1000);
+        space = MAX(0, targetPoints - getNumPointsInAllBuffers());
+        unlock();
+    }
+    return space;
+}
+
 int DacBaseThreaded :: calculateBufferFullnessByTimeSent() {
     
     
@@ -75,11 +97,26 @@ int DacBaseThreaded :: calculateBufferFullnessByTimeAcked() {
     
 }
 
+int DacBaseThreaded :: estimateBufferFullness(float sigmas) {
+    
+    if(useBufferEstimator && bufferEstimator.hasEstimate()) {
+        return bufferEstimator.getBufferFullness(ofGetElapsedTimeMicros(), sigmas);
+    } else {
+        return calculateBufferFullnessByTimeSent();
+    }
+}
+
 void DacBaseThreaded :: waitUntilReadyToSend(int maxPointsToFillBuffer){
 
-    int bufferFullness = calculateBufferFullnessByTimeSent();
+    // use the low estimate, better to wake up a little early than
+    // let the buffer run dry
+    int bufferFullness = estimateBufferFullness(-bufferEstimatorSigmas);
     int pointsUntilEmpty = MAX(0, bufferFullness - maxPointsToFillBuffer);
-    int microsToWait = pointsUntilEmpty * (1000000.0f/pps);
+    float pointRate = pps;
+    if(useBufferEstimator && bufferEstimator.hasEstimate()) {
+        pointRate = bufferEstimator.getActualPointRate();
+    }
+    int microsToWait = pointsUntilEmpty * (1000000.0f/pointRate);
     
     if(true) {
       
@@ -97,6 +134,7 @@ bool DacBaseThreaded :: isReadyForFrame(int maxlatencyms) {
     int queuedPointCount = 0;
     if(lock()) {
         queuedPointCount = getNumPointsInAllBuffers();
+        if(autoLatency) maxlatencyms = latencyTuner.getLatencyMS();
         maxLatencyMS = maxlatencyms;
         
         bool ready = (queuedPointCount<((maxlatencyms+calculationTimeMS)*newPPS/1000));// || (queuedPointCount<minBufferSize);
@@ -111,6 +149,58 @@ bool DacBaseThreaded :: isReadyForFrame(int maxlatencyms) {
     return false;
 }
 
+bool DacBaseThreaded :: isReadyForTimedFrame(int maxlatencyms, int horizonms) {
+    int queuedPointCount = 0;
+    if(lock()) {
+        queuedPointCount = getNumPointsInAllBuffers();
+        if(autoLatency) maxlatencyms = latencyTuner.getLatencyMS();
+        maxLatencyMS = maxlatencyms;
+        
+        // the frame is aligned to start horizonms from now, so if there's
+        // any less than that queued the gap is filled with blank points
+        bool ready = (queuedPointCount<(horizonms*newPPS/1000));
+        
+        unlock();
+        return ready;
+    }
+    return false;
+}
+
+void DacBaseThreaded :: setAutoLatency(bool enabled, float targetUnderrunProbability) {
+    latencyTuner.targetUnderrunProbability = targetUnderrunProbability;
+    // the tuner would never get any samples
+    if(!canAutoLatency()) enabled = false;
+    if(enabled && !autoLatency) {
+        // start from wherever we are now. The DAC thread adds
+        // samples to the tuner so it has to wait
+        if(lock()) {
+            latencyTuner.reset(maxLatencyMS);
+            unlock();
+        }
+    }
+    DacBase::setAutoLatency(enabled, targetUnderrunProbability);
+}
+
+int DacBaseThreaded :: getLatencyMS() {
+    return autoLatency ? latencyTuner.getLatencyMS() : maxLatencyMS;
+}
+
+int DacBaseThreaded :: getQueuedMicros() {
+    int queuedMicros = -1;
+    if(lock()) {
+        // the rate the DAC is really running at if we know it
+        float pointRate = newPPS;
+        if(useBufferEstimator && bufferEstimator.hasEstimate()) {
+            pointRate = bufferEstimator.getActualPointRate();
+        }
+        if(pointRate>0) {
+            queuedMicros = getNumPointsInAllBuffers() * (1000000.0f/pointRate);
+        }
+        unlock();
+    }
+    return queuedMicros;
+}
+
 // updates the frame buffer with new frames from the threadchannel,
 // adds frames to the frame queue until we have minPointsToQueue
 
@@ -122,8 +212,11 @@ void DacBaseThreaded ::  updateFrameQueue(int minPointsToQueue){
         bufferedFrames.push_back(frame);
     }
     deque<DacFrame*> queuedFrames;
+    // kept until the queued frames are recorded, so that the telemetry
+    // goes in in the order the frames were made
+    deque<DacFrame*> skippedFrames;
    
-    int dacBufferFullness = calculateBufferFullnessByTimeSent();
+    int dacBufferFullness = estimateBufferFullness();
 
     // go through the buffered frames and add them into the buffer until we have enough points
     // or we run out of frames
@@ -138,8 +231,7 @@ void DacBaseThreaded ::  updateFrameQueue(int minPointsToQueue){
         // if we didn't get to the frame in time and it's more than 10ms late then skip it
         if(frame->frameTime + ((maxLatencyMS)*1000) < lastPointTimeMicros) {
             // skip frame!
-            //frameRecorder.recordFrameInfoThreadSafe(frame->frameTime, 0, frame->framePoints.size(), 0, true);
-            delete frame;
+            skippedFrames.push_back(frame);
             skipcount++;
         } else {
             queuedFrames.push_back(frame);
@@ -152,11 +244,14 @@ void DacBaseThreaded ::  updateFrameQueue(int minPointsToQueue){
     //cout << "queued frames : " << queuedFrames.size()  << " buffered frames : " << bufferedFrames.size() << endl;
     // if we still don't have enough points then double up!
     // TODO make this better, spread the repeats better
-    int i = 0;
+    // Synced frames only repeat the last frame, repeating the others
+    // would push the following frames past their presentation time
+    bool synced = (queuedFrames.size()>0) && (queuedFrames.back()->presentationTime>0);
+    int i = synced ? queuedFrames.size()-1 : 0;
     while((i<queuedFrames.size()) && (getNumPointsInFrames(queuedFrames)<minPointsToQueue)) {
         queuedFrames[i]->repeatCount++;
         //cout << "+++ repeating " << i << " " << queuedFrames[i]->repeatCount << endl;
-        i++;
+        if(!synced) i++;
         if(i>=queuedFrames.size()) i=0;
     }
 
@@ -164,7 +259,18 @@ void DacBaseThreaded ::  updateFrameQueue(int minPointsToQueue){
     
     for(int i = 0; i<queuedFrames.size(); i++ ) {
         DacFrame& frame = *queuedFrames[i];
-        //frameRecorder.recordFrameInfoThreadSafe(frame.frameTime, ofGetElapsedTimeMicros() + (( calculateBufferSizeByTimeSent() + bufferedPoints.size()) * 1000000 / pps), frame.framePoints.size(), frame.repeatCount, frame.repeatCount == 0);
+        // the frame telemetry is searched by time, so the frames skipped
+        // before this one go in first
+        while((skippedFrames.size()>0) && (skippedFrames[0]->frameTime<=frame.frameTime)) {
+            frameRecorder.recordFrameInfoThreadSafe(skippedFrames[0]->frameTime, 0, pps, skippedFrames[0]->framePoints.size(), 0, true);
+            delete skippedFrames[0];
+            skippedFrames.pop_front();
+        }
+        if(frame.presentationTime>0) {
+            alignFrameToPresentationTime(frame, dacBufferFullness);
+        }
+        // the sent time is when we expect the frame to start playing
+        frameRecorder.recordFrameInfoThreadSafe(frame.frameTime, ofGetElapsedTimeMicros() + (( dacBufferFullness + bufferedPoints.size()) * 1000000 / pps), pps, frame.framePoints.size(), frame.repeatCount, false);
         
       
         while(frame.repeatCount>0) {
@@ -174,6 +280,11 @@ void DacBaseThreaded ::  updateFrameQueue(int minPointsToQueue){
             frame.repeatCount--;
         }
     }
+    for(DacFrame* frame : skippedFrames) {
+        frameRecorder.recordFrameInfoThreadSafe(frame->frameTime, 0, pps, frame->framePoints.size(), 0, true);
+        delete frame;
+    }
+    
     // now clear the frames!
 
     while(queuedFrames.size()>0) {
@@ -186,6 +297,48 @@ void DacBaseThreaded ::  updateFrameQueue(int minPointsToQueue){
 }
 
 
+void DacBaseThreaded :: alignFrameToPresentationTime(DacFrame& frame, int dacBufferFullness) {
+    
+    uint64_t now = ofGetElapsedTimeMicros();
+    int64_t startTime = now + ((int64_t)(dacBufferFullness + bufferedPoints.size()) * 1000000 / pps);
+    int64_t skew = startTime - (int64_t)frame.presentationTime;
+    int correctionPoints = 0;
+    
+    if(skew < -frame.syncToleranceMicros) {
+        // early, so hold the scanners where they are with the laser off
+        // until it's time for the frame to start
+        correctionPoints = (-skew * pps) / 1000000;
+        ofxLaser::Point holdPoint;
+        if(bufferedPoints.size()>0) holdPoint = *bufferedPoints.back();
+        else if(frame.framePoints.size()>0) holdPoint = *frame.framePoints[0];
+        holdPoint.setColour(0,0,0);
+        for(int i = 0; i<correctionPoints; i++) {
+            addPointToBuffer(holdPoint);
+        }
+    } else if(skew > frame.syncToleranceMicros) {
+        // late, so cut the end off the points that haven't been sent yet.
+        // If they've already gone to the DAC then there's nothing we can do.
+        int pointsToTrim = MIN((skew * pps) / 1000000, (int64_t)bufferedPoints.size());
+        for(int i = 0; i<pointsToTrim; i++) {
+            PointFactory :: releasePoint(bufferedPoints.back());
+            bufferedPoints.pop_back();
+        }
+        // make sure we don't draw a line to the start of the frame
+        if(bufferedPoints.size()>0) bufferedPoints.back()->setColour(0,0,0);
+        correctionPoints = -pointsToTrim;
+    }
+    
+    int correctionMicros = (int64_t)correctionPoints * 1000000 / pps;
+    syncCorrectionMicros = correctionMicros;
+    syncSkewMicros = (int)(skew + correctionMicros);
+    lastSyncedFrameTime = now;
+    
+}
+
+bool DacBaseThreaded :: isFrameSyncActive() {
+    return (ofGetElapsedTimeMicros() - lastSyncedFrameTime) < 1000000;
+}
+
 inline bool DacBaseThreaded :: addPointToBuffer(const ofxLaser::Point &point ){
     ofxLaser::Point* p = PointFactory :: getPoint(point);
     //*p = point; // copy assignment hopefully!
@@ -206,7 +359,7 @@ int DacBaseThreaded :: getNumPointsInFrames(deque<DacFrame*>& frames) {
 
 int DacBaseThreaded :: getNumPointsInAllBuffers() {
     // if not in thread then needs lock!
-      return calculateBufferFullnessByTimeSent() + bufferedPoints.size() + getNumPointsInBufferedFrames();
+      return estimateBufferFullness() + bufferedPoints.size() + getNumPointsInBufferedFrames();
     
 }
 
@@ -235,6 +388,33 @@ bool DacBaseThreaded::setColourShift(float shift)  {
     
 }
 
+void DacBaseThreaded::discardStaleFrames() {
+    
+    if(!lock()) return;
+    
+    // frames in the channel are newer than the buffered ones
+    DacFrame* frame;
+    while(frameThreadChannel.tryReceive(frame)) {
+        bufferedFrames.push_back(frame);
+    }
+    while(bufferedFrames.size()>1) {
+        delete bufferedFrames[0];
+        bufferedFrames.pop_front();
+    }
+    
+    // the points were for when the DAC was gone (and in stream mode
+    // the app will send more as soon as there's space)
+    for (size_t i= 0; i < bufferedPoints.size(); ++i) {
+        PointFactory :: releasePoint(bufferedPoints[i]);
+    }
+    bufferedPoints.clear();
+    
+    lastReportedBufferFullness = 0;
+    lastDataSentBufferSize = 0;
+    bufferEstimator.reset(0, ofGetElapsedTimeMicros());
+    unlock();
+}
+
 void DacBaseThreaded::cleanUpFramesAndPoints() {
     
     // NOTE thread must be stopped by now
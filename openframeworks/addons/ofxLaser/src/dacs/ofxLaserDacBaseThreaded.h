@@ -11,6 +11,10 @@
 #include "ofxLaserDacStateRecorder.h"
 #include "ofxLaserDacFrameInfoRecorder.h"
 #include "ofxLaserPointFactory.h"
+#include "ofxLaserDacBufferEstimator.h"
+#include "ofxLaserDacLatencyTuner.h"
+#include "ofxLaserThreadPolicy.h"
+#include "ofxLaserDacReconnector.h"
 #include "ofMain.h"
 
 namespace ofxLaser {
@@ -21,7 +25,11 @@ class DacBaseThreaded : public DacBase, public ofThread {
     
     // DacBase
     virtual bool sendFrame(const vector<Point>& points) override;
+    virtual bool sendSyncedFrame(const vector<Point>& points, uint64_t presentationTimeMicros, int toleranceMicros) override;
+    // rejects the points (and counts them in streamPointsRejected)
+    // rather than buffer more than half a second
     virtual bool sendPoints(const vector<Point>& points) override;
+    int getPointStreamSpace(int maxLatencyMS) override;
     virtual bool setColourShift(float shiftSeconds) override;
     
     virtual string getId() override = 0;
@@ -32,8 +40,15 @@ class DacBaseThreaded : public DacBase, public ofThread {
     virtual void reset() override = 0;
     virtual void close() override = 0;
     void cleanUpFramesAndPoints(); 
+    // after a reconnect, gets rid of everything that was waiting to go
+    // out while the DAC was gone, apart from the newest frame
+    void discardStaleFrames();
     
     bool isReadyForFrame(int maxLatencyMS) override;
+    bool isReadyForTimedFrame(int maxLatencyMS, int horizonMS) override;
+    void setAutoLatency(bool enabled, float targetUnderrunProbability) override;
+    int getLatencyMS() override;
+    int getQueuedMicros() override;
  
     
     //ofThread
@@ -41,6 +56,16 @@ class DacBaseThreaded : public DacBase, public ofThread {
     
     virtual int calculateBufferFullnessByTimeSent();
     virtual int calculateBufferFullnessByTimeAcked();
+    // uses the buffer estimator if the DAC feeds it, otherwise falls
+    // back to calculateBufferFullnessByTimeSent. sigmas moves the
+    // estimate up or down by that many standard deviations
+    int estimateBufferFullness(float sigmas = 0);
+    
+    // tracks the DAC's buffer level and clock drift from the acks
+    DacBufferEstimator bufferEstimator;
+    bool useBufferEstimator = true;
+    // how cautious to be when waiting to send more points
+    float bufferEstimatorSigmas = 2;
     
     // These two objects are for diagnostics...
     // stateRecorder periodically records the current buffer,
@@ -49,6 +74,21 @@ class DacBaseThreaded : public DacBase, public ofThread {
     // frameRecorder records data about every frame
     // that is sent to the DAC
     DacFrameInfoRecorder frameRecorder;
+    // finds the lowest latency that doesn't underrun
+    // (when autoLatency is on)
+    DacLatencyTuner latencyTuner;
+    // for getting the same device back quickly if it drops out
+    DacReconnector reconnector;
+    
+    // frame sync, how far the last synced frame started from its
+    // presentation time (after correction) and how much it was
+    // moved to get there (+ve is padding, -ve is trimming)
+    std::atomic<int> syncSkewMicros{0};
+    std::atomic<int> syncCorrectionMicros{0};
+    std::atomic<uint64_t> lastSyncedFrameTime{0};
+    bool isFrameSyncActive();
+    
+    std::atomic<uint64_t> streamPointsRejected{0};
     
     
     protected :
@@ -73,6 +113,9 @@ class DacBaseThreaded : public DacBase, public ofThread {
     
     void updateFrameQueue(int minPointsToQueue );
     int getNumPointsInFrames(deque<DacFrame*>& frames);
+    // pads or trims the buffered points so that a synced frame added
+    // next will start at its presentation time
+    void alignFrameToPresentationTime(DacFrame& frame, int dacBufferFullness);
     // adds a point into the buffer ready to be sent to the DAC
     bool addPointToBuffer(const ofxLaser::Point& point );
 
@@ -0,0 +1,156 @@
+//
+//  ofxLaserDacBufferEstimator.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacBufferEstimator.h"
+
+using namespace ofxLaser;
+
+void DacBufferEstimator :: reset(int bufferFullness, uint64_t timeMicros, bool resetDrift) {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    level = bufferFullness;
+    p00 = 10000;
+    p01 = 0;
+    if(resetDrift) {
+        drift = 0;
+        p11 = 2.5e-7;
+    }
+    stateTimeMicros = timeMicros;
+    initialised = true;
+}
+
+void DacBufferEstimator :: setPointRate(uint32_t pps) {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    // bring the level up to date at the old rate first
+    predict(ofGetElapsedTimeMicros());
+    pointRate = pps;
+}
+
+void DacBufferEstimator :: setPlaying(bool _playing, uint64_t timeMicros) {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    predict(timeMicros);
+    playing = _playing;
+}
+
+void DacBufferEstimator :: addPoints(int numPoints, uint64_t timeMicros) {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    predict(timeMicros);
+    level += numPoints;
+}
+
+void DacBufferEstimator :: addMeasurement(int bufferFullness, uint64_t ackTimeMicros, int roundTripMicros) {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    
+    if(!initialised) {
+        // start from the measurement, whatever was predicted before it
+        level = bufferFullness;
+        p00 = 10000;
+        p01 = 0;
+        stateTimeMicros = ackTimeMicros;
+        initialised = true;
+        return;
+    }
+    
+    predict(ackTimeMicros);
+    
+    // the DAC reported the fullness about half a round trip ago,
+    // and it's been draining at pointRate * (1 + drift) since then.
+    // so the measurement is z = level + lag * pointRate * (1 + drift)
+    double lag = playing ? MAX(0, roundTripMicros) * 0.5 / 1000000.0 : 0;
+    double h1 = lag * pointRate;
+    double predicted = level + h1 * (1 + drift);
+    
+    // the further back the measurement was, the less we trust it
+    double jitter = h1 * 0.5;
+    double r = measurementNoise + jitter * jitter;
+    
+    double s = p00 + 2 * h1 * p01 + h1 * h1 * p11 + r;
+    double k0 = (p00 + h1 * p01) / s;
+    double k1 = (p01 + h1 * p11) / s;
+    
+    double innovation = bufferFullness - predicted;
+    
+    level += k0 * innovation;
+    // only learn the drift while the buffer is actually draining
+    if(playing) drift += k1 * innovation;
+    drift = ofClamp(drift, -maxDrift, maxDrift);
+    
+    // P = (I - KH) P
+    double n00 = p00 - k0 * (p00 + h1 * p01);
+    double n01 = p01 - k0 * (p01 + h1 * p11);
+    double n11 = p11 - k1 * (p01 + h1 * p11);
+    p00 = MAX(n00, 0.0);
+    p01 = n01;
+    p11 = MAX(n11, 1e-12);
+    
+    if(level<0) level = 0;
+}
+
+bool DacBufferEstimator :: hasEstimate() {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    return initialised;
+}
+
+int DacBufferEstimator :: getBufferFullness(uint64_t timeMicros, float sigmas) {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    
+    // extrapolate without changing the state
+    double elapsed = (timeMicros > stateTimeMicros) ? (timeMicros - stateTimeMicros) / 1000000.0 : 0;
+    double estimate = level;
+    double variance = p00;
+    if(playing) {
+        double f = elapsed * pointRate;
+        estimate -= f * (1 + drift);
+        variance += - 2 * f * p01 + f * f * p11;
+    }
+    variance += bufferNoise * elapsed;
+    
+    estimate += sigmas * sqrt(MAX(variance, 0.0));
+    return MAX(0, (int)round(estimate));
+}
+
+float DacBufferEstimator :: getBufferUncertainty() {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    return sqrt(MAX(p00, 0.0));
+}
+
+float DacBufferEstimator :: getActualPointRate() {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    return pointRate * (1 + drift);
+}
+
+float DacBufferEstimator :: getDriftPPM() {
+    std::lock_guard<std::mutex> guard(estimatorMutex);
+    return drift * 1000000;
+}
+
+// note - must be called with the mutex locked
+void DacBufferEstimator :: predict(uint64_t timeMicros) {
+    
+    // the first time we see, otherwise the uncertainty would grow for
+    // the whole time since the app started
+    if(stateTimeMicros==0) {
+        stateTimeMicros = timeMicros;
+        return;
+    }
+    if(timeMicros <= stateTimeMicros) return;
+    
+    double elapsed = (timeMicros - stateTimeMicros) / 1000000.0;
+    stateTimeMicros = timeMicros;
+    
+    if(playing) {
+        // level -= elapsed * pointRate * (1 + drift)
+        double f = elapsed * pointRate;
+        level -= f * (1 + drift);
+        if(level<0) level = 0;
+        
+        // P = F P F' + Q, where F = [1, -f ; 0, 1]
+        double n00 = p00 - 2 * f * p01 + f * f * p11;
+        double n01 = p01 - f * p11;
+        p00 = n00;
+        p01 = n01;
+    }
+    p00 += bufferNoise * elapsed;
+    p11 += driftNoise * elapsed;
+}
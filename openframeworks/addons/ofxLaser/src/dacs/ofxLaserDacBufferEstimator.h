@@ -0,0 +1,86 @@
+//
+//  ofxLaserDacBufferEstimator.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+
+// Estimates how many points are in the DAC's buffer between acks.
+//
+// The old estimate just counted down from the last reported buffer
+// fullness at the nominal point rate, which drifts whenever the DAC's
+// clock is a little fast or slow, or when acks are held up on the
+// network. This is a small Kalman filter that tracks two things :
+//
+// - the buffer level (in points)
+// - the clock drift (the DAC's actual rate / the nominal rate - 1)
+//
+// Sent points are added to the level as they go out, and every ack
+// with a buffer fullness corrects it. The ack is assumed to report the
+// buffer as it was half a round trip ago.
+//
+// It's updated by the DAC thread and can be read from any thread.
+
+namespace ofxLaser {
+
+class DacBufferEstimator {
+    
+    public :
+    
+    // starts again from a known buffer level, keeps the drift estimate
+    // unless resetDrift is true
+    void reset(int bufferFullness, uint64_t timeMicros, bool resetDrift = false);
+    
+    void setPointRate(uint32_t pps);
+    // the buffer only drains while the DAC is playing
+    void setPlaying(bool playing, uint64_t timeMicros);
+    
+    // call when points have been sent to the DAC
+    void addPoints(int numPoints, uint64_t timeMicros);
+    // call with the buffer fullness from an ack
+    void addMeasurement(int bufferFullness, uint64_t ackTimeMicros, int roundTripMicros);
+    
+    // true once we've had at least one measurement
+    bool hasEstimate();
+    
+    // estimated buffer level at the time, plus / minus the number of
+    // standard deviations. Use a lower bound to avoid underruns and
+    // an upper bound to avoid overflowing the buffer.
+    int getBufferFullness(uint64_t timeMicros, float sigmas = 0);
+    // one standard deviation of the buffer level, in points
+    float getBufferUncertainty();
+    
+    // the estimated point rate that the DAC is actually running at
+    float getActualPointRate();
+    float getDriftPPM();
+    
+    // process noise for the buffer level (points^2 per second)
+    float bufferNoise = 400;
+    // process noise for the clock drift (per second)
+    float driftNoise = 1e-10;
+    // measurement noise (points^2), the round trip jitter is added on top
+    float measurementNoise = 4;
+    // the drift can't be more than this (2%)
+    float maxDrift = 0.02;
+    
+    protected :
+    
+    // moves the state forward to the time
+    void predict(uint64_t timeMicros);
+    
+    std::mutex estimatorMutex;
+    
+    // state
+    double level = 0;
+    double drift = 0;
+    // covariance
+    double p00 = 10000, p01 = 0, p11 = 2.5e-7;
+    
+    uint64_t stateTimeMicros = 0;
+    uint32_t pointRate = 30000;
+    bool playing = false;
+    bool initialised = false;
+    
+};
+}
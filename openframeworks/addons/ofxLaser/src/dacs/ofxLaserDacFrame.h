@@ -45,6 +45,10 @@ class DacFrame {
     vector<Point*> framePoints;
     uint64_t frameTime;
     int repeatCount = 1; // number of times to repeat the frame
+    // when the frame should start playing if it's in a sync
+    // group, 0 if it isn't
+    uint64_t presentationTime = 0;
+    int syncToleranceMicros = 0;
    
     
 };
@@ -6,59 +6,47 @@
 //
 
 #include "ofxLaserDacFrameInfoRecorder.h"
+#include "ofxLaserDacTelemetryWriter.h"
 
 
 DacFrameInfoRecorder :: DacFrameInfoRecorder() {
+    recording = true;
+    ofxLaser::DacTelemetryWriter::instance()->addFrameInfoRecorder(this);
 }
 
-void DacFrameInfoRecorder :: recordFrameInfoThreadSafe (uint64_t createdtimemicros, uint64_t senttimemicros, uint32_t numpoints, int repeatcount, bool skipped) {
+DacFrameInfoRecorder :: ~DacFrameInfoRecorder() {
+    ofxLaser::DacTelemetryWriter::instance()->removeFrameInfoRecorder(this);
+}
+
+void DacFrameInfoRecorder :: recordFrameInfoThreadSafe (uint64_t createdtimemicros, uint64_t senttimemicros, uint32_t pointrate, uint32_t numpoints, int repeatcount, bool skipped) {
     
-    FrameAtTime* frameInfoPointer = new FrameAtTime();
-    FrameAtTime& frameInfo = *frameInfoPointer;
+    if(!recording) return;
+    FrameAtTime frameInfo;
     frameInfo.createdTimeMicros = createdtimemicros;
     frameInfo.sentTimeMicros = senttimemicros;
+    frameInfo.pointRate = pointrate;
     frameInfo.numPoints = numpoints;
     frameInfo.repeatCount = repeatcount;
     frameInfo.skipped = skipped;
     
-    frameInfoChannel.send(frameInfoPointer);
-    
+    frameHistory.push(frameInfo);
     
 }
-void DacFrameInfoRecorder :: update() {
-    
-    FrameAtTime* frameInfo;
-    while(frameInfoChannel.tryReceive(frameInfo)) {
-        frameHistory.push_back(frameInfo);
-    }
-    while(frameHistory.size()>=1000) {
-        FrameAtTime* spare = frameHistory.front();
-        frameHistory.pop_front();
-        delete spare; // recycle?
-    }
-    
+
+void DacFrameInfoRecorder :: setLabel(const string& _label) {
+    std::lock_guard<std::mutex> guard(labelMutex);
+    label = _label;
 }
 
+string DacFrameInfoRecorder :: getLabel() {
+    std::lock_guard<std::mutex> guard(labelMutex);
+    return label;
+}
 
-const vector<FrameAtTime*>& DacFrameInfoRecorder :: getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros) {
-    // assumes that history date is sorted by time
-    frameHistoryForTimePeriod.clear();
-    
-    for(size_t i = 0; i<frameHistory.size(); i++) {
-        FrameAtTime* frameAtTime = frameHistory[i];
-        bool firstfound = true;
-        if((frameAtTime->sentTimeMicros >= starttimemicros) && (frameAtTime->sentTimeMicros <= endtimemicros)) {
-            if(firstfound) {
-                if(i>0) frameHistoryForTimePeriod.push_back(frameHistory[i-1]);
-                firstfound = false;
-            }
-            frameHistoryForTimePeriod.push_back(frameAtTime);
-        }
-        
-    }
-    
+const vector<FrameAtTime>& DacFrameInfoRecorder :: getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros) {
+    // binary searches the ring buffer for the start and end
+    frameHistory.copyForTimePeriod(starttimemicros, endtimemicros, frameHistoryForTimePeriod);
     return frameHistoryForTimePeriod;
-    
 }
 
 void DacFrameInfoRecorder :: getFrameLatencyValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) {
@@ -70,7 +58,7 @@ void DacFrameInfoRecorder :: getFrameLatencyValuesForTime(uint64_t starttimemicr
     if(frameHistoryForTimePeriod.size()>0) {
         // get the first buffer index for the start time
         
-        FrameAtTime* frameInfo = frameHistoryForTimePeriod[bufferIndex];
+        FrameAtTime* frameInfo = &frameHistoryForTimePeriod[bufferIndex];
         int latencyMicros =  0; //frameInfo->sentTimeMicros-frameInfo->createdTimeMicros;
         
         for (int i =0; i<numvalues; i++) {
@@ -80,10 +68,10 @@ void DacFrameInfoRecorder :: getFrameLatencyValuesForTime(uint64_t starttimemicr
             timeMicros+=starttimemicros;
             
             latencyMicros = 0;
-            while((bufferIndex+1<frameHistoryForTimePeriod.size()) &&  (frameHistoryForTimePeriod[bufferIndex+1]->createdTimeMicros < timeMicros)) {
+            while((bufferIndex+1<frameHistoryForTimePeriod.size()) &&  (frameHistoryForTimePeriod[bufferIndex+1].createdTimeMicros < timeMicros)) {
                 
                 bufferIndex++;
-                frameInfo = (frameHistoryForTimePeriod[bufferIndex]);
+                frameInfo = &frameHistoryForTimePeriod[bufferIndex];
                 //buffersize = 5000;
                 if(!frameInfo->skipped) latencyMicros = frameInfo->sentTimeMicros-frameInfo->createdTimeMicros;
             }
@@ -107,7 +95,7 @@ void DacFrameInfoRecorder :: getFrameRepeatValuesForTime(uint64_t starttimemicro
     if(frameHistoryForTimePeriod.size()>0) {
         // get the first buffer index for the start time
         
-        FrameAtTime* frameInfo = frameHistoryForTimePeriod[bufferIndex];
+        FrameAtTime* frameInfo = &frameHistoryForTimePeriod[bufferIndex];
         int repeatcount =  0; //frameInfo->sentTimeMicros-frameInfo->createdTimeMicros;
         
         for (int i =0; i<numvalues; i++) {
@@ -117,10 +105,10 @@ void DacFrameInfoRecorder :: getFrameRepeatValuesForTime(uint64_t starttimemicro
             timeMicros+=starttimemicros;
             
             repeatcount = 0;
-            while((bufferIndex+1<frameHistoryForTimePeriod.size()) &&  (frameHistoryForTimePeriod[bufferIndex+1]->createdTimeMicros < timeMicros)) {
+            while((bufferIndex+1<frameHistoryForTimePeriod.size()) &&  (frameHistoryForTimePeriod[bufferIndex+1].createdTimeMicros < timeMicros)) {
                 
                 bufferIndex++;
-                frameInfo = (frameHistoryForTimePeriod[bufferIndex]);
+                frameInfo = &frameHistoryForTimePeriod[bufferIndex];
                 //buffersize = 5000;
                 repeatcount = frameInfo->repeatCount;
             }
@@ -145,7 +133,7 @@ void DacFrameInfoRecorder :: getFrameSkipValuesForTime(uint64_t starttimemicros,
     if(frameHistoryForTimePeriod.size()>0) {
         // get the first buffer index for the start time
         
-        FrameAtTime* frameInfo = frameHistoryForTimePeriod[bufferIndex];
+        FrameAtTime* frameInfo = &frameHistoryForTimePeriod[bufferIndex];
         int skip =  0; //frameInfo->sentTimeMicros-frameInfo->createdTimeMicros;
         
         for (int i =0; i<numvalues; i++) {
@@ -155,10 +143,10 @@ void DacFrameInfoRecorder :: getFrameSkipValuesForTime(uint64_t starttimemicros,
             timeMicros+=starttimemicros;
             
             skip = 0;
-            while((bufferIndex+1<frameHistoryForTimePeriod.size()) &&  (frameHistoryForTimePeriod[bufferIndex+1]->createdTimeMicros < timeMicros)) {
+            while((bufferIndex+1<frameHistoryForTimePeriod.size()) &&  (frameHistoryForTimePeriod[bufferIndex+1].createdTimeMicros < timeMicros)) {
                 
                 bufferIndex++;
-                frameInfo = (frameHistoryForTimePeriod[bufferIndex]);
+                frameInfo = &frameHistoryForTimePeriod[bufferIndex];
                 //buffersize = 5000;
                 skip = frameInfo->skipped ? 1 : 0;
             }
@@ -7,6 +7,11 @@
 
 #pragma once
 #include "ofMain.h"
+#include "ofxLaserTelemetryRingBuffer.h"
+
+// Stores data about every frame that goes to the DAC, whether it was
+// sent, repeated or skipped. Like the DacStateRecorder it uses a
+// ring buffer so it can be left on.
 
 struct FrameAtTime {
     uint64_t createdTimeMicros = 0;
@@ -15,33 +20,38 @@ struct FrameAtTime {
     uint32_t numPoints = 0;
     int repeatCount = 1;
     bool skipped = false;
+    
+    // skipped frames are never sent, so they're sorted by created time
+    uint64_t getTimeMicros() const { return createdTimeMicros; };
 };
 
-// TODO make the state history transfer a threadchannel
 class DacFrameInfoRecorder {
     public :
     DacFrameInfoRecorder();
+    ~DacFrameInfoRecorder();
     
-    void recordFrameInfoThreadSafe(uint64_t createdTimeMicros, uint64_t sentTimeMicros, uint32_t numPoints, int repeatCount, bool skipped);
-    void update();
-    //void recordState(uint64_t timemicros, int playbackstate, int bufferfullness, int roundtriptime, int numpointssent, int pointrate);
-    
-    const vector<FrameAtTime*>& getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros);
+    void recordFrameInfoThreadSafe(uint64_t createdTimeMicros, uint64_t sentTimeMicros, uint32_t pointRate, uint32_t numPoints, int repeatCount, bool skipped);
     
+    const vector<FrameAtTime>& getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros);
     
     void getFrameLatencyValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues);
-    
-//    
     void getFrameRepeatValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) ;
     void getFrameSkipValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) ;
-//    void getDataRateValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) ;
-//   
     
-    deque<FrameAtTime*> frameHistory;
-    vector<FrameAtTime*> frameHistoryForTimePeriod;
-    ofThreadChannel<FrameAtTime*> frameInfoChannel;
+    // the name that is used when the data is exported
+    void setLabel(const string& label);
+    string getLabel();
+    
+    // written by the DAC thread, can be read from anywhere
+    ofxLaser::TelemetryRingBuffer<FrameAtTime, 4096> frameHistory;
+    vector<FrameAtTime> frameHistoryForTimePeriod;
     
     float values[10000]; // used to store plot data, temporary storage
+    std::atomic<bool> recording;
+    
+    protected :
+    std::mutex labelMutex;
+    string label;
     
 };
 
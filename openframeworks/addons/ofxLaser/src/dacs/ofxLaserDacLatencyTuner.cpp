@@ -0,0 +1,80 @@
+//
+//  ofxLaserDacLatencyTuner.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacLatencyTuner.h"
+
+using namespace ofxLaser;
+
+void DacLatencyTuner :: reset(int latency) {
+    latencyMS = ofClamp(latency, minLatencyMS, maxLatencyMS);
+    underrunProbability = 0;
+    windowStartMicros = 0;
+    windowSampleCount = 0;
+    windowUnderflow = false;
+    wasUnderflowing = false;
+    rttMean = rttM2 = 0;
+}
+
+void DacLatencyTuner :: addSample(uint64_t timeMicros, int bufferFullness, int roundTripMicros, int pointRate, bool underflow) {
+    
+    if(pointRate<=0) return;
+    
+    if(windowSampleCount == 0) {
+        windowStartMicros = timeMicros;
+        windowMinBufferMS = std::numeric_limits<float>::max();
+        windowUnderflow = false;
+        rttMean = rttM2 = 0;
+    }
+    windowSampleCount++;
+    
+    // only count the start of an underflow, the flag stays set until the
+    // DAC is prepared again
+    if(underflow && !wasUnderflowing) {
+        windowUnderflow = true;
+        underrunCount++;
+    }
+    wasUnderflowing = underflow;
+    
+    float bufferMS = (float)bufferFullness * 1000.0f / pointRate;
+    if(!underflow && (bufferMS<windowMinBufferMS)) windowMinBufferMS = bufferMS;
+    
+    double delta = roundTripMicros - rttMean;
+    rttMean += delta / windowSampleCount;
+    rttM2 += delta * (roundTripMicros - rttMean);
+    
+    if(timeMicros - windowStartMicros >= (uint64_t)windowMicros) {
+        endWindow();
+        windowSampleCount = 0;
+    }
+    
+}
+
+void DacLatencyTuner :: endWindow() {
+    
+    // smooth over about the last 20 windows
+    const float smoothing = 0.05;
+    underrunProbability = underrunProbability * (1-smoothing) + (windowUnderflow ? smoothing : 0);
+    
+    float jitter = (windowSampleCount>1) ? sqrt(rttM2 / (windowSampleCount-1)) / 1000.0f : 0;
+    jitterMS = jitter;
+    lastWindowMinBufferMS = (windowMinBufferMS == std::numeric_limits<float>::max()) ? 0 : windowMinBufferMS;
+    
+    int latency = latencyMS;
+    
+    if(windowUnderflow) {
+        // back off quickly
+        latency = latency * 1.25f + 5;
+    } else if(underrunProbability < targetUnderrunProbability) {
+        // how much of the buffer we didn't need
+        float spareMS = lastWindowMinBufferMS - (jitter * jitterHeadroom) - 1;
+        if(spareMS > 0) {
+            // come down slowly, no more than 5ms a window
+            latency -= MIN(5, MAX(1, (int)(spareMS * 0.5f)));
+        }
+    }
+    
+    latencyMS = ofClamp(latency, minLatencyMS, maxLatencyMS);
+    
+}
@@ -0,0 +1,72 @@
+//
+//  ofxLaserDacLatencyTuner.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+
+// Finds the lowest latency that a DAC can run at without underrunning.
+//
+// The DAC thread gives it a sample for every ack (the same data that
+// goes to the DacStateRecorder). Every few seconds it looks at the
+// window that just finished :
+//
+// - if the buffer ran dry, the latency goes up quickly
+// - if the chance of an underrun is below the target and the buffer
+//   never got close to empty (allowing for the ack jitter), the
+//   latency comes down a little
+//
+// The underrun probability is the chance that a window has an underrun
+// in it, smoothed over the last few windows.
+
+namespace ofxLaser {
+
+class DacLatencyTuner {
+    
+    public :
+    
+    // call from the DAC thread
+    void addSample(uint64_t timeMicros, int bufferFullness, int roundTripMicros, int pointRate, bool underflow);
+    
+    // starts again from this latency
+    void reset(int latencyMS);
+    
+    int getLatencyMS() { return latencyMS; };
+    float getUnderrunProbability() { return underrunProbability; };
+    float getJitterMS() { return jitterMS; };
+    float getMinBufferMS() { return lastWindowMinBufferMS; };
+    int getUnderrunCount() { return underrunCount; };
+    
+    // the chance of a window containing an underrun that we're happy with
+    std::atomic<float> targetUnderrunProbability{0.01};
+    std::atomic<int> minLatencyMS{10};
+    std::atomic<int> maxLatencyMS{400};
+    // how long each window is
+    int windowMicros = 5000000;
+    // how much buffer to keep above the ack jitter, in standard deviations
+    float jitterHeadroom = 3;
+    
+    protected :
+    
+    void endWindow();
+    
+    std::atomic<int> latencyMS{150};
+    std::atomic<float> underrunProbability{0};
+    std::atomic<float> jitterMS{0};
+    std::atomic<float> lastWindowMinBufferMS{0};
+    std::atomic<int> underrunCount{0};
+    
+    // current window
+    uint64_t windowStartMicros = 0;
+    bool windowUnderflow = false;
+    float windowMinBufferMS = 0;
+    int windowSampleCount = 0;
+    // running round trip mean and variance (Welford)
+    double rttMean = 0;
+    double rttM2 = 0;
+    
+    bool wasUnderflowing = false;
+    
+};
+}
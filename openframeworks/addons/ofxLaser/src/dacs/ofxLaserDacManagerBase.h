@@ -13,6 +13,7 @@ namespace ofxLaser {
 class DacManagerBase {
     
     public :
+    virtual ~DacManagerBase() {};
     virtual vector<DacData> updateDacList() = 0;
     DacBase* getDacById(string id) {
         if(dacsById.count(id) == 1) {
@@ -24,13 +25,8 @@ class DacManagerBase {
     };
     
     bool checkDacsChanged() {
-        if(dacsChanged) {
-            dacsChanged = false;
-            return true;
-        } else {
-            return false;
-        }
-        
+        // the managers set this from their own threads
+        return dacsChanged.exchange(false);
     }
     virtual DacBase* getAndConnectToDac(const string& dacdata) = 0;
     virtual bool disconnectAndDeleteDac(const string& dacdata) = 0;
@@ -39,8 +35,7 @@ class DacManagerBase {
     
     protected :
     map<string, DacBase*>dacsById;
-    // TODO thread safe??? 
-    bool dacsChanged = false;
+    std::atomic<bool> dacsChanged{false};
     
     private :
     
@@ -0,0 +1,46 @@
+//
+//  ofxLaserDacReconnector.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacReconnector.h"
+
+using namespace ofxLaser;
+
+bool DacReconnector :: connectionLost() {
+    if(isReconnecting()) return false;
+    lostTime = ofGetElapsedTimeMicros();
+    reconnectedTime = 0;
+    lastAttemptTime = 0;
+    attempts = 0;
+    return true;
+}
+
+bool DacReconnector :: isTimeToRetry() {
+    uint64_t now = ofGetElapsedTimeMicros();
+    if((lastAttemptTime>0) && (now - lastAttemptTime < (uint64_t)retryIntervalMicros)) return false;
+    lastAttemptTime = now;
+    attempts++;
+    return true;
+}
+
+void DacReconnector :: reconnected() {
+    if(!isReconnecting()) return;
+    reconnectedTime = ofGetElapsedTimeMicros();
+}
+
+void DacReconnector :: lightRestored(const string& dacLabel) {
+    // only once after each reconnect
+    if(reconnectedTime==0) return;
+    
+    uint64_t now = ofGetElapsedTimeMicros();
+    int reconnectMS = (int)((reconnectedTime - lostTime)/1000);
+    int timeToLightMS = (int)((now - lostTime)/1000);
+    
+    lastTimeToLightMS = timeToLightMS;
+    reconnectCount++;
+    ofLogNotice(dacLabel + " reconnected after " + ofToString(reconnectMS) + "ms (" + ofToString(attempts) + " attempts), time to light " + ofToString(timeToLightMS) + "ms");
+    
+    lostTime = 0;
+    reconnectedTime = 0;
+}
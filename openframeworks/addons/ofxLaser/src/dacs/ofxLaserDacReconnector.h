@@ -0,0 +1,55 @@
+//
+//  ofxLaserDacReconnector.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+
+// Keeps track of a DAC that has dropped out while its thread tries to
+// get it back. The DAC reconnects to the same device itself (by IP
+// address or USB port / serial number) rather than waiting for its
+// manager to find it again, so that a network blip or a USB
+// re-enumeration only costs a few tens of milliseconds.
+//
+// The DAC thread calls :
+// - connectionLost() when it notices
+// - isTimeToRetry() before each attempt
+// - reconnected() when the device is back
+// - lightRestored() the first time it outputs points again, which logs
+//   how long the laser was dark for
+
+namespace ofxLaser {
+
+class DacReconnector {
+    
+    public :
+    
+    // returns false if we already knew
+    bool connectionLost();
+    bool isReconnecting() { return lostTime>0; };
+    bool isTimeToRetry();
+    void reconnected();
+    void lightRestored(const string& dacLabel);
+    
+    // how long to wait between attempts
+    int retryIntervalMicros = 10000;
+    // how long each attempt can take (for network DACs)
+    int connectTimeoutMicros = 50000;
+    
+    int getReconnectCount() { return reconnectCount; };
+    // from the connection dropping until the laser was outputting again
+    int getLastTimeToLightMS() { return lastTimeToLightMS; };
+    
+    protected :
+    
+    uint64_t lostTime = 0;
+    uint64_t reconnectedTime = 0;
+    uint64_t lastAttemptTime = 0;
+    int attempts = 0;
+    
+    std::atomic<int> reconnectCount{0};
+    std::atomic<int> lastTimeToLightMS{-1};
+    
+};
+}
@@ -6,62 +6,47 @@
 //
 
 #include "ofxLaserDacStateRecorder.h"
+#include "ofxLaserDacTelemetryWriter.h"
 
 
 DacStateRecorder :: DacStateRecorder() {
-    recording = false;
+    recording = true;
+    ofxLaser::DacTelemetryWriter::instance()->addStateRecorder(this);
+}
+
+DacStateRecorder :: ~DacStateRecorder() {
+    ofxLaser::DacTelemetryWriter::instance()->removeStateRecorder(this);
 }
 
 void DacStateRecorder :: recordStateThreadSafe(uint64_t timemicros, int playbackstate, int bufferfullness, int roundtriptime, int numpointssent, int pointrate, int numbytes) {
     if(!recording) return;
-    DacStateAtTime* dacState = new DacStateAtTime();
-    DacStateAtTime& bufferState = *dacState;
+    DacStateAtTime bufferState;
     bufferState.timeMicros = timemicros;
     bufferState.buffer = bufferfullness;
     bufferState.playing = playbackstate;
     bufferState.pointRate = pointrate;
     bufferState.roundTripTime = roundtriptime;
     bufferState.numBytes = numbytes;
-    bufferState.bytesPerSecond = (float)numbytes *1000000.0f/  (float)roundtriptime ;
-    
-    stateChannel.send(dacState);
-    
+    bufferState.bytesPerSecond = (roundtriptime>0) ? (float)numbytes *1000000.0f/  (float)roundtriptime : 0;
     
-}
-void DacStateRecorder :: update() {
-    
-    DacStateAtTime* dacState;
-    while(stateChannel.tryReceive(dacState)) {
-        stateHistory.push_back(dacState);
-    }
-    while(stateHistory.size()>=1000) {
-        DacStateAtTime* spare = stateHistory.front();
-        stateHistory.pop_front();
-        delete spare; // recycle?
-    }
+    stateHistory.push(bufferState);
     
 }
 
+void DacStateRecorder :: setLabel(const string& _label) {
+    std::lock_guard<std::mutex> guard(labelMutex);
+    label = _label;
+}
 
-const vector<DacStateAtTime*>& DacStateRecorder :: getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros) {
-    // assumes that history date is sorted by time
-    stateHistoryForTimePeriod.clear();
-
-    for(size_t i = 0; i<stateHistory.size(); i++) {
-        DacStateAtTime* stateAtTime = stateHistory[i];
-        bool firstfound = true;
-        if((stateAtTime->timeMicros >= starttimemicros) && (stateAtTime->timeMicros <= endtimemicros)) {
-            if(firstfound) {
-                if(i>0) stateHistoryForTimePeriod.push_back(stateHistory[i-1]);
-                firstfound = false;
-            }
-            stateHistoryForTimePeriod.push_back(stateAtTime);
-        }
-        
-    }
+string DacStateRecorder :: getLabel() {
+    std::lock_guard<std::mutex> guard(labelMutex);
+    return label;
+}
 
+const vector<DacStateAtTime>& DacStateRecorder :: getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros) {
+    // binary searches the ring buffer for the start and end
+    stateHistory.copyForTimePeriod(starttimemicros, endtimemicros, stateHistoryForTimePeriod);
     return stateHistoryForTimePeriod;
-    
 }
 
 void DacStateRecorder :: getBufferSizeValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) {
@@ -73,7 +58,7 @@ void DacStateRecorder :: getBufferSizeValuesForTime(uint64_t starttimemicros, ui
     if(stateHistoryForTimePeriod.size()>0) {
         // get the first buffer index for the start time
         
-        DacStateAtTime* bufferstate = stateHistoryForTimePeriod[bufferIndex];
+        DacStateAtTime* bufferstate = &stateHistoryForTimePeriod[bufferIndex];
         float buffersize =  (float)bufferstate->buffer;;
         
         for (int i =0; i<numvalues; i++) {
@@ -83,10 +68,10 @@ void DacStateRecorder :: getBufferSizeValuesForTime(uint64_t starttimemicros, ui
             timeMicros+=starttimemicros;
             
             
-            while((bufferIndex+1<stateHistoryForTimePeriod.size()) && stateHistoryForTimePeriod[bufferIndex+1]->timeMicros < timeMicros) {
+            while((bufferIndex+1<stateHistoryForTimePeriod.size()) && stateHistoryForTimePeriod[bufferIndex+1].timeMicros < timeMicros) {
                 
                 bufferIndex++;
-                bufferstate = (stateHistoryForTimePeriod[bufferIndex]);
+                bufferstate = &stateHistoryForTimePeriod[bufferIndex];
                 //buffersize = 5000;
                 buffersize = (float)bufferstate->buffer;
             }
@@ -112,9 +97,9 @@ void DacStateRecorder :: getDataRateValuesForTime(uint64_t starttimemicros, uint
     uint64_t visibledurationmicros = endtimemicros-starttimemicros;
     if(stateHistoryForTimePeriod.size()>0) {
         // get the first buffer index for the start time
-        float latency = stateHistoryForTimePeriod[bufferIndex]->bytesPerSecond/1000.0f;
+        float latency = stateHistoryForTimePeriod[bufferIndex].bytesPerSecond/1000.0f;
         
-        DacStateAtTime* bufferstate = stateHistoryForTimePeriod[bufferIndex];
+        DacStateAtTime* bufferstate = &stateHistoryForTimePeriod[bufferIndex];
         
         
         for (int i =0; i<numvalues; i++) {
@@ -124,10 +109,10 @@ void DacStateRecorder :: getDataRateValuesForTime(uint64_t starttimemicros, uint
             timeMicros+=starttimemicros;
             
             
-            while((bufferIndex+1<stateHistoryForTimePeriod.size()) && stateHistoryForTimePeriod[bufferIndex+1]->timeMicros < timeMicros) {
+            while((bufferIndex+1<stateHistoryForTimePeriod.size()) && stateHistoryForTimePeriod[bufferIndex+1].timeMicros < timeMicros) {
                 
                 bufferIndex++;
-                bufferstate = (stateHistoryForTimePeriod[bufferIndex]);
+                bufferstate = &stateHistoryForTimePeriod[bufferIndex];
                 //buffersize = 5000;
                 latency = (float)bufferstate->bytesPerSecond/1000.0f;
             }
@@ -149,9 +134,9 @@ void DacStateRecorder :: getLatencyValuesForTime(uint64_t starttimemicros, uint6
     uint64_t visibledurationmicros = endtimemicros-starttimemicros;
     if(stateHistoryForTimePeriod.size()>0) {
         // get the first buffer index for the start time
-        float latency = stateHistoryForTimePeriod[bufferIndex]->roundTripTime/1000.0f;
+        float latency = stateHistoryForTimePeriod[bufferIndex].roundTripTime/1000.0f;
         
-        DacStateAtTime* bufferstate = stateHistoryForTimePeriod[bufferIndex];
+        DacStateAtTime* bufferstate = &stateHistoryForTimePeriod[bufferIndex];
         
         
         for (int i =0; i<numvalues; i++) {
@@ -161,10 +146,10 @@ void DacStateRecorder :: getLatencyValuesForTime(uint64_t starttimemicros, uint6
             timeMicros+=starttimemicros;
             
             
-            while((bufferIndex+1<stateHistoryForTimePeriod.size()) && stateHistoryForTimePeriod[bufferIndex+1]->timeMicros < timeMicros) {
+            while((bufferIndex+1<stateHistoryForTimePeriod.size()) && stateHistoryForTimePeriod[bufferIndex+1].timeMicros < timeMicros) {
                 
                 bufferIndex++;
-                bufferstate = (stateHistoryForTimePeriod[bufferIndex]);
+                bufferstate = &stateHistoryForTimePeriod[bufferIndex];
                 //buffersize = 5000;
                 latency = (float)bufferstate->roundTripTime/1000.0f;
             }
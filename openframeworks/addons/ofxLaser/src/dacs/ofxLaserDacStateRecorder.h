@@ -7,8 +7,11 @@
 
 #pragma once
 #include "ofMain.h"
+#include "ofxLaserTelemetryRingBuffer.h"
 
-// This system stores data about the last packet that was sent to the DAC
+// This system stores data about the last packet that was sent to the DAC.
+// It's cheap enough to leave running all the time, the DAC thread just
+// writes into a ring buffer. See ofxLaserTelemetryRingBuffer.h
 
 struct DacStateAtTime {
     uint64_t timeMicros = 0;
@@ -19,30 +22,37 @@ struct DacStateAtTime {
     uint32_t numBytes = 0;
     float bytesPerSecond = 0; 
     bool playing = false;
+    
+    uint64_t getTimeMicros() const { return timeMicros; };
 
 };
 
-// TODO make the state history transfer a threadchannel
 class DacStateRecorder {
     public :
     DacStateRecorder();
+    ~DacStateRecorder();
     void recordStateThreadSafe(uint64_t timemicros, int playbackstate, int bufferfullness, int roundtriptime, int numpointssent, int pointrate, int numbytes);
-    void update();
       
-    const vector<DacStateAtTime*>& getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros);
+    const vector<DacStateAtTime>& getStateHistoryForTimePeriod(uint64_t starttimemicros, uint64_t endtimemicros);
 
     void getBufferSizeValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues);
 
     void getLatencyValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) ;
     void getDataRateValuesForTime(uint64_t starttimemicros, uint64_t endtimemicros, int numvalues) ;
    
+    // the name that is used when the data is exported
+    void setLabel(const string& label);
+    string getLabel();
     
-    deque<DacStateAtTime*> stateHistory;
-    vector<DacStateAtTime*> stateHistoryForTimePeriod;
-    ofThreadChannel<DacStateAtTime*> stateChannel;
+    // written by the DAC thread, can be read from anywhere
+    ofxLaser::TelemetryRingBuffer<DacStateAtTime, 4096> stateHistory;
+    vector<DacStateAtTime> stateHistoryForTimePeriod;
     
     float values[10000]; // used to store plot data, temporary storage
-    bool recording; 
+    std::atomic<bool> recording;
+    
+    protected :
+    std::mutex labelMutex;
+    string label;
     
 };
-
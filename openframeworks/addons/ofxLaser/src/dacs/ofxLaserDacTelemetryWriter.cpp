@@ -0,0 +1,213 @@
+//
+//  ofxLaserDacTelemetryWriter.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDacTelemetryWriter.h"
+
+using namespace ofxLaser;
+
+DacTelemetryWriter * DacTelemetryWriter :: instance() {
+    // a function static rather than the usual pointer check because the
+    // recorders are made (and register themselves) from the DAC managers'
+    // threads as well as the main one
+    static DacTelemetryWriter* telemetryWriter = new DacTelemetryWriter();
+    return telemetryWriter;
+}
+
+DacTelemetryWriter :: ~DacTelemetryWriter() {
+    stop();
+}
+
+void DacTelemetryWriter :: addStateRecorder(DacStateRecorder* recorder) {
+    std::lock_guard<std::mutex> guard(writerMutex);
+    // only export new data
+    stateSources.push_back({recorder, recorder->stateHistory.getWriteCount()});
+}
+
+void DacTelemetryWriter :: removeStateRecorder(DacStateRecorder* recorder) {
+    std::lock_guard<std::mutex> guard(writerMutex);
+    // get the last of its data out before it goes
+    if(stateFile.is_open()) writeNewRecords();
+    stateSources.erase(std::remove_if(stateSources.begin(), stateSources.end(), [&](Source<DacStateRecorder>& source) {
+        return source.recorder == recorder;
+    }), stateSources.end());
+}
+
+void DacTelemetryWriter :: addFrameInfoRecorder(DacFrameInfoRecorder* recorder) {
+    std::lock_guard<std::mutex> guard(writerMutex);
+    frameSources.push_back({recorder, recorder->frameHistory.getWriteCount()});
+}
+
+void DacTelemetryWriter :: removeFrameInfoRecorder(DacFrameInfoRecorder* recorder) {
+    std::lock_guard<std::mutex> guard(writerMutex);
+    if(frameFile.is_open()) writeNewRecords();
+    frameSources.erase(std::remove_if(frameSources.begin(), frameSources.end(), [&](Source<DacFrameInfoRecorder>& source) {
+        return source.recorder == recorder;
+    }), frameSources.end());
+}
+
+void DacTelemetryWriter :: start(string _folder, DacTelemetryFormat _format) {
+    
+    if(isThreadRunning()) stop();
+    
+    std::lock_guard<std::mutex> guard(writerMutex);
+    folder = _folder;
+    format = _format;
+    sessionName = ofGetTimestampString("%Y-%m-%d-%H-%M-%S");
+    fileCount = 0;
+    ofDirectory::createDirectory(folder, true, true);
+    
+    // start from now rather than exporting everything in the buffers
+    for(auto& source : stateSources) source.nextIndex = source.recorder->stateHistory.getWriteCount();
+    for(auto& source : frameSources) source.nextIndex = source.recorder->frameHistory.getWriteCount();
+    
+    if(!openNextFile(stateFile, "dacstate", stateFileHistory, stateFileBytes) ||
+       !openNextFile(frameFile, "frameinfo", frameFileHistory, frameFileBytes)) {
+        closeFiles();
+        return;
+    }
+    
+    startThread();
+}
+
+void DacTelemetryWriter :: stop() {
+    if(isThreadRunning()) {
+        waitForThread(true);
+    }
+    std::lock_guard<std::mutex> guard(writerMutex);
+    if(stateFile.is_open()) writeNewRecords();
+    closeFiles();
+}
+
+bool DacTelemetryWriter :: isExporting() {
+    return isThreadRunning();
+}
+
+void DacTelemetryWriter :: threadedFunction() {
+    
+    // this isn't urgent, so it runs at normal priority
+    while(isThreadRunning()) {
+        {
+            std::lock_guard<std::mutex> guard(writerMutex);
+            writeNewRecords();
+        }
+        // sleep in short bursts so we stop quickly
+        for(int i = 0; (i<10) && isThreadRunning(); i++) {
+            sleep(100);
+        }
+    }
+}
+
+void DacTelemetryWriter :: writeNewRecords() {
+    
+    if(!stateFile.is_open() || !frameFile.is_open()) return;
+    
+    vector<DacStateAtTime>& states = stateBuffer;
+    vector<FrameAtTime>& frames = frameBuffer;
+    
+    for(auto& source : stateSources) {
+        states.clear();
+        uint64_t endIndex = source.recorder->stateHistory.getWriteCount();
+        uint64_t firstIndex = source.recorder->stateHistory.copy(source.nextIndex, endIndex, states);
+        if(firstIndex>source.nextIndex) {
+            ofLogWarning("DacTelemetryWriter") << (firstIndex-source.nextIndex) << " DAC state records were lost";
+        }
+        source.nextIndex = endIndex;
+        if(states.empty()) continue;
+        
+        string label = source.recorder->getLabel();
+        if(label.empty()) label = "unassigned";
+        
+        std::ostringstream out;
+        for(DacStateAtTime& state : states) {
+            if(format == DAC_TELEMETRY_CSV) {
+                out << label << "," << state.timeMicros << "," << state.playing << "," << state.buffer << "," << state.pointRate << "," << state.roundTripTime << "," << state.numBytes << "," << state.bytesPerSecond << "\n";
+            } else {
+                char labelBytes[32] = {0};
+                strncpy(labelBytes, label.c_str(), sizeof(labelBytes)-1);
+                out.write(labelBytes, sizeof(labelBytes));
+                out.write((const char*)&state, sizeof(DacStateAtTime));
+            }
+        }
+        string data = out.str();
+        stateFile << data;
+        stateFileBytes += data.size();
+    }
+    
+    for(auto& source : frameSources) {
+        frames.clear();
+        uint64_t endIndex = source.recorder->frameHistory.getWriteCount();
+        uint64_t firstIndex = source.recorder->frameHistory.copy(source.nextIndex, endIndex, frames);
+        if(firstIndex>source.nextIndex) {
+            ofLogWarning("DacTelemetryWriter") << (firstIndex-source.nextIndex) << " frame info records were lost";
+        }
+        source.nextIndex = endIndex;
+        if(frames.empty()) continue;
+        
+        string label = source.recorder->getLabel();
+        if(label.empty()) label = "unassigned";
+        
+        std::ostringstream out;
+        for(FrameAtTime& frame : frames) {
+            if(format == DAC_TELEMETRY_CSV) {
+                out << label << "," << frame.createdTimeMicros << "," << frame.sentTimeMicros << "," << frame.pointRate << "," << frame.numPoints << "," << frame.repeatCount << "," << frame.skipped << "\n";
+            } else {
+                char labelBytes[32] = {0};
+                strncpy(labelBytes, label.c_str(), sizeof(labelBytes)-1);
+                out.write(labelBytes, sizeof(labelBytes));
+                out.write((const char*)&frame, sizeof(FrameAtTime));
+            }
+        }
+        string data = out.str();
+        frameFile << data;
+        frameFileBytes += data.size();
+    }
+    
+    stateFile.flush();
+    frameFile.flush();
+    
+    if(stateFileBytes>maxFileBytes) openNextFile(stateFile, "dacstate", stateFileHistory, stateFileBytes);
+    if(frameFileBytes>maxFileBytes) openNextFile(frameFile, "frameinfo", frameFileHistory, frameFileBytes);
+    
+}
+
+bool DacTelemetryWriter :: openNextFile(ofstream& file, const string& type, deque<string>& fileHistory, size_t& bytesWritten) {
+    
+    if(file.is_open()) file.close();
+    
+    string extension = (format == DAC_TELEMETRY_CSV) ? ".csv" : ".bin";
+    string filename = ofToDataPath(folder + "/" + type + "_" + sessionName + "_" + ofToString(fileCount++, 3, '0') + extension, true);
+    
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file.is_open()) {
+        ofLogError("DacTelemetryWriter") << "couldn't open " << filename;
+        return false;
+    }
+    bytesWritten = 0;
+    
+    if(format == DAC_TELEMETRY_CSV) {
+        string header;
+        if(type == "dacstate") {
+            header = "dac,timeMicros,playbackState,bufferFullness,pointRate,roundTripMicros,numBytes,bytesPerSecond\n";
+        } else {
+            header = "dac,createdTimeMicros,sentTimeMicros,pointRate,numPoints,repeatCount,skipped\n";
+        }
+        file << header;
+        bytesWritten += header.size();
+    }
+    
+    // only keep the most recent files
+    fileHistory.push_back(filename);
+    while((int)fileHistory.size()>maxFiles) {
+        ofFile::removeFile(fileHistory.front(), false);
+        fileHistory.pop_front();
+    }
+    
+    return true;
+}
+
+void DacTelemetryWriter :: closeFiles() {
+    if(stateFile.is_open()) stateFile.close();
+    if(frameFile.is_open()) frameFile.close();
+}
@@ -0,0 +1,92 @@
+//
+//  ofxLaserDacTelemetryWriter.h
+//  ofxLaser
+//
+// Writes the data from all the DacStateRecorders and
+// DacFrameInfoRecorders to disk in the background, for looking at
+// after a show.
+//
+// Once a second it picks up any new records from the recorders' ring
+// buffers and appends them to two files, one for DAC state and one for
+// frame info. When a file gets bigger than maxFileBytes it starts a new
+// one, and it only keeps the last maxFiles of each.
+//
+// CSV files have a header row. Binary files are a sequence of records,
+// each one is a 32 byte DAC label (zero padded) followed by the
+// DacStateAtTime or FrameAtTime struct as it is in memory.
+
+#pragma once
+#include "ofMain.h"
+#include "ofxLaserDacStateRecorder.h"
+#include "ofxLaserDacFrameInfoRecorder.h"
+
+namespace ofxLaser {
+
+enum DacTelemetryFormat {
+    DAC_TELEMETRY_CSV,
+    DAC_TELEMETRY_BINARY
+};
+
+class DacTelemetryWriter : public ofThread {
+    
+    public :
+    
+    // it's a Singleton so shouldn't ever have more than one.
+    static DacTelemetryWriter * instance();
+    
+    ~DacTelemetryWriter();
+    
+    // the recorders add themselves
+    void addStateRecorder(DacStateRecorder* recorder);
+    void removeStateRecorder(DacStateRecorder* recorder);
+    void addFrameInfoRecorder(DacFrameInfoRecorder* recorder);
+    void removeFrameInfoRecorder(DacFrameInfoRecorder* recorder);
+    
+    // folder is relative to the data folder
+    void start(string folder = "ofxLaser/telemetry", DacTelemetryFormat format = DAC_TELEMETRY_CSV);
+    void stop();
+    bool isExporting();
+    
+    size_t maxFileBytes = 50 * 1024 * 1024;
+    int maxFiles = 10;
+    
+    protected :
+    
+    // use instance()
+    DacTelemetryWriter() {};
+    
+    void threadedFunction() override;
+    
+    // writes out any new records, call with the mutex locked
+    void writeNewRecords();
+    bool openNextFile(ofstream& file, const string& type, deque<string>& fileHistory, size_t& bytesWritten);
+    void closeFiles();
+    
+    template<typename T>
+    struct Source {
+        T* recorder;
+        uint64_t nextIndex;
+    };
+    
+    std::mutex writerMutex;
+    vector<Source<DacStateRecorder>> stateSources;
+    vector<Source<DacFrameInfoRecorder>> frameSources;
+    
+    string folder;
+    DacTelemetryFormat format = DAC_TELEMETRY_CSV;
+    string sessionName;
+    int fileCount = 0;
+    
+    ofstream stateFile;
+    ofstream frameFile;
+    size_t stateFileBytes = 0;
+    size_t frameFileBytes = 0;
+    deque<string> stateFileHistory;
+    deque<string> frameFileHistory;
+    
+    // reused so we don't allocate every time we write
+    vector<DacStateAtTime> stateBuffer;
+    vector<FrameAtTime> frameBuffer;
+    
+};
+}
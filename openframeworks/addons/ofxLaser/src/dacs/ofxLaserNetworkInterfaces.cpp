@@ -0,0 +1,61 @@
+//
+//  ofxLaserNetworkInterfaces.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserNetworkInterfaces.h"
+
+using namespace ofxLaser;
+
+bool NetworkInterfaceData :: isOnSubnet(const Poco::Net::IPAddress& otherAddress) const {
+    if(otherAddress.family()!=Poco::Net::IPAddress::IPv4) return false;
+    return (otherAddress & subnetMask) == (ipAddress & subnetMask);
+}
+
+vector<NetworkInterfaceData> NetworkInterfaces :: getIPv4Interfaces() {
+
+    vector<NetworkInterfaceData> interfaces;
+
+    try {
+        Poco::Net::NetworkInterface::List list = Poco::Net::NetworkInterface::list(true, true);
+        for(Poco::Net::NetworkInterface& networkInterface : list) {
+            if(networkInterface.isLoopback() || !networkInterface.supportsIPv4()) continue;
+
+            for(auto& addressTuple : networkInterface.addressList()) {
+                const Poco::Net::IPAddress& address = addressTuple.get<Poco::Net::NetworkInterface::IP_ADDRESS>();
+                const Poco::Net::IPAddress& broadcastAddress = addressTuple.get<Poco::Net::NetworkInterface::BROADCAST_ADDRESS>();
+                if((address.family()!=Poco::Net::IPAddress::IPv4) || broadcastAddress.isWildcard()) continue;
+
+                NetworkInterfaceData data;
+                data.name = networkInterface.name();
+                data.ipAddress = address;
+                data.subnetMask = addressTuple.get<Poco::Net::NetworkInterface::SUBNET_MASK>();
+                data.address = address.toString();
+                data.broadcastAddress = broadcastAddress.toString();
+                interfaces.push_back(data);
+            }
+        }
+    } catch (Poco::Exception& exc) {
+        ofLog(OF_LOG_ERROR,  "NetworkInterfaces :: getIPv4Interfaces - couldn't list network interfaces : " + exc.displayText());
+    }
+    return interfaces;
+}
+
+const NetworkInterfaceData* NetworkInterfaces :: findInterfaceForAddress(const vector<NetworkInterfaceData>& interfaces, const string& ipAddress) {
+
+    Poco::Net::IPAddress address;
+    if(!Poco::Net::IPAddress::tryParse(ipAddress, address)) return nullptr;
+
+    for(const NetworkInterfaceData& networkInterface : interfaces) {
+        if(networkInterface.isOnSubnet(address)) return &networkInterface;
+    }
+    return nullptr;
+}
+
+bool NetworkInterfaces :: isSameList(const vector<NetworkInterfaceData>& interfaces1, const vector<NetworkInterfaceData>& interfaces2) {
+    if(interfaces1.size()!=interfaces2.size()) return false;
+    for(size_t i = 0; i<interfaces1.size(); i++) {
+        if((interfaces1[i].name!=interfaces2[i].name) || (interfaces1[i].address!=interfaces2[i].address)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+//
+//  ofxLaserNetworkInterfaces.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+#include "Poco/Net/NetworkInterface.h"
+#include "Poco/Net/IPAddress.h"
+
+// The computer's IPv4 network interfaces, for the network DAC managers.
+// A show computer often has more than one network (eg a control network
+// and a laser network) so the managers broadcast on each of them, and
+// remember which one each DAC was found on so that its data socket can
+// be bound to it.
+
+namespace ofxLaser {
+
+struct NetworkInterfaceData {
+    string name;
+    string address;
+    string broadcastAddress;
+    Poco::Net::IPAddress ipAddress;
+    Poco::Net::IPAddress subnetMask;
+
+    // whether the address is on this interface's subnet
+    bool isOnSubnet(const Poco::Net::IPAddress& otherAddress) const;
+};
+
+class NetworkInterfaces {
+
+    public :
+
+    // the interfaces that are up and have an IPv4 broadcast address
+    // (so not loopback)
+    static vector<NetworkInterfaceData> getIPv4Interfaces();
+
+    // the interface on the same subnet as the IP address, or nullptr
+    static const NetworkInterfaceData* findInterfaceForAddress(const vector<NetworkInterfaceData>& interfaces, const string& ipAddress);
+
+    // whether the two lists have the same names and addresses
+    static bool isSameList(const vector<NetworkInterfaceData>& interfaces1, const vector<NetworkInterfaceData>& interfaces2);
+
+};
+}
@@ -0,0 +1,114 @@
+//
+//  ofxLaserTelemetryRingBuffer.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+
+// A fixed size ring buffer of plain records, for diagnostics data.
+//
+// One thread (the DAC thread) writes and any number of threads can read
+// without locks. The writer never waits, it just overwrites the oldest
+// record. Readers copy the records they want and then check that the
+// writer hasn't lapped them while they were copying, and throw away
+// anything that was overwritten.
+//
+// Every record gets an index that keeps going up, so a reader can keep
+// its place (like the telemetry writer does) and pick up where it left
+// off.
+//
+// T must be trivially copyable and have a getTimeMicros() function that
+// goes up (or at least never goes down) with each new record.
+
+namespace ofxLaser {
+
+template<typename T, size_t N>
+class TelemetryRingBuffer {
+    
+    static_assert(std::is_trivially_copyable<T>::value, "TelemetryRingBuffer records must be trivially copyable");
+    static_assert((N & (N-1)) == 0, "TelemetryRingBuffer size must be a power of two");
+    
+    public :
+    
+    // only call from one thread
+    void push(const T& record) {
+        uint64_t index = writeCount.load(std::memory_order_relaxed);
+        records[index & (N-1)] = record;
+        writeCount.store(index+1, std::memory_order_release);
+    }
+    
+    // the index of the next record to be written
+    uint64_t getWriteCount() const {
+        return writeCount.load(std::memory_order_acquire);
+    }
+    
+    // the index of the oldest record we can still read. The writer could
+    // be in the middle of writing over index count-N (in the slot for
+    // index count) so that one doesn't count.
+    uint64_t getOldestIndex() const {
+        uint64_t count = getWriteCount();
+        return (count >= N) ? count - N + 1 : 0;
+    }
+    
+    // copies records from startIndex up to (not including) endIndex onto
+    // the end of target. Returns the index of the first record copied,
+    // which is later than startIndex if some were overwritten.
+    uint64_t copy(uint64_t startIndex, uint64_t endIndex, vector<T>& target) const {
+        
+        startIndex = MAX(startIndex, getOldestIndex());
+        if(endIndex<=startIndex) return startIndex;
+        
+        size_t firstTargetIndex = target.size();
+        for(uint64_t i = startIndex; i<endIndex; i++) {
+            target.push_back(records[i & (N-1)]);
+        }
+        
+        // anything older than this may have been written over while we
+        // were copying it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t oldest = getOldestIndex();
+        if(oldest>startIndex) {
+            size_t numOverwritten = MIN(oldest - startIndex, endIndex-startIndex);
+            target.erase(target.begin()+firstTargetIndex, target.begin()+firstTargetIndex+numOverwritten);
+            startIndex += numOverwritten;
+        }
+        return startIndex;
+    }
+    
+    // binary search for the index of the first record at or after the time
+    uint64_t findIndexForTime(uint64_t timeMicros) const {
+        uint64_t low = getOldestIndex();
+        uint64_t high = getWriteCount();
+        while(low<high) {
+            uint64_t mid = low + (high-low)/2;
+            // a record could be written over while we're looking at it,
+            // but the worst that can happen is we end up a few records out
+            if(records[mid & (N-1)].getTimeMicros() < timeMicros) {
+                low = mid+1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+    
+    // copies all the records between the two times, plus the one before
+    // (so that plots know what the value was at the start time)
+    void copyForTimePeriod(uint64_t startTimeMicros, uint64_t endTimeMicros, vector<T>& target) const {
+        target.clear();
+        uint64_t startIndex = findIndexForTime(startTimeMicros);
+        uint64_t endIndex = findIndexForTime(endTimeMicros+1);
+        if(startIndex>0) startIndex--;
+        copy(startIndex, endIndex, target);
+    }
+    
+    static size_t capacity() { return N; }
+    
+    protected :
+    
+    T records[N];
+    std::atomic<uint64_t> writeCount{0};
+    
+};
+}
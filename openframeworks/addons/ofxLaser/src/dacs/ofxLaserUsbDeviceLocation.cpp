@@ -0,0 +1,75 @@
+//
+//  ofxLaserUsbDeviceLocation.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserUsbDeviceLocation.h"
+
+using namespace ofxLaser;
+
+void UsbDeviceLocation :: set(libusb_device* device) {
+    
+    struct libusb_device_descriptor descriptor;
+    if(libusb_get_device_descriptor(device, &descriptor)<0) return;
+    vendorId = descriptor.idVendor;
+    productId = descriptor.idProduct;
+    
+    busNumber = libusb_get_bus_number(device);
+    uint8_t ports[8];
+    int numPorts = libusb_get_port_numbers(device, ports, sizeof(ports));
+    portNumbers.assign(ports, ports + MAX(0, numPorts));
+}
+
+bool UsbDeviceLocation :: isSamePort(libusb_device* device) {
+    if(libusb_get_bus_number(device)!=busNumber) return false;
+    uint8_t ports[8];
+    int numPorts = libusb_get_port_numbers(device, ports, sizeof(ports));
+    return (numPorts==(int)portNumbers.size()) && std::equal(portNumbers.begin(), portNumbers.end(), ports);
+}
+
+string UsbDeviceLocation :: getPortPath(libusb_device* device) {
+    string path = ofToString((int)libusb_get_bus_number(device));
+    uint8_t ports[8];
+    int numPorts = libusb_get_port_numbers(device, ports, sizeof(ports));
+    for(int i = 0; i<numPorts; i++) {
+        path += (i==0 ? "-" : ".") + ofToString((int)ports[i]);
+    }
+    return path;
+}
+
+bool UsbDeviceLocation :: find(std::function<bool(libusb_device*)> tryDevice) {
+    
+    if(!isSet()) return false;
+    
+    libusb_device **deviceList;
+    ssize_t count = libusb_get_device_list(NULL, &deviceList);
+    if(count<0) return false;
+    
+    // sort out the devices that might be it, the one on the same port
+    // goes first
+    vector<libusb_device*> candidates;
+    for(ssize_t i = 0; i<count; i++) {
+        struct libusb_device_descriptor descriptor;
+        if(libusb_get_device_descriptor(deviceList[i], &descriptor)<0) continue;
+        if((descriptor.idVendor!=vendorId) || (descriptor.idProduct!=productId)) continue;
+        
+        if(isSamePort(deviceList[i])) {
+            candidates.insert(candidates.begin(), deviceList[i]);
+        } else {
+            candidates.push_back(deviceList[i]);
+        }
+    }
+    
+    bool found = false;
+    for(libusb_device* device : candidates) {
+        if(tryDevice(device)) {
+            // it might have moved to a different port
+            set(device);
+            found = true;
+            break;
+        }
+    }
+    
+    libusb_free_device_list(deviceList, 1);
+    return found;
+}
@@ -0,0 +1,45 @@
+//
+//  ofxLaserUsbDeviceLocation.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+#include "libusb.h"
+
+// Remembers which USB port a DAC is plugged into so that it can be found
+// again after it re-enumerates (it gets a new address but it's usually
+// on the same port). Used by the USB DACs to reconnect without going
+// through their manager.
+
+namespace ofxLaser {
+
+class UsbDeviceLocation {
+    
+    public :
+    
+    void set(libusb_device* device);
+    bool isSet() { return vendorId!=0; };
+    
+    // Goes through the devices with the same vendor and product IDs,
+    // the one on the same port first, and calls tryDevice on each until
+    // it returns true. tryDevice should open the device, check that it's
+    // the right one (by serial number or name) and keep it if it is.
+    // The device is only valid during the call, libusb_open adds a
+    // reference if you need to keep it.
+    bool find(std::function<bool(libusb_device*)> tryDevice);
+    
+    // the bus and ports as a string, eg "1-2.3"
+    static string getPortPath(libusb_device* device);
+    
+    protected :
+    
+    bool isSamePort(libusb_device* device);
+    
+    uint16_t vendorId = 0;
+    uint16_t productId = 0;
+    uint8_t busNumber = 0;
+    vector<uint8_t> portNumbers;
+    
+};
+}
@@ -0,0 +1,142 @@
+//
+//  ofxLaserUsbHotplugMonitor.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserUsbHotplugMonitor.h"
+
+using namespace ofxLaser;
+
+UsbHotplugMonitor * UsbHotplugMonitor :: instance() {
+    // a function static so that it's safe to create from any thread, and
+    // never deleted because libusb might still call hotplugCallback
+    static UsbHotplugMonitor* usbHotplugMonitor = new UsbHotplugMonitor();
+    return usbHotplugMonitor;
+}
+
+bool UsbHotplugMonitor :: isSupported() {
+    return libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)!=0;
+}
+
+UsbHotplugMonitor :: UsbHotplugMonitor() {
+    // keeps the default context alive while we're using it
+    int result = libusb_init(NULL);
+    if(result<0) {
+        ofLogError("UsbHotplugMonitor - error initializing libusb : "+ofToString(result));
+    }
+}
+
+UsbHotplugMonitor :: ~UsbHotplugMonitor() {
+    if(isThreadRunning()) {
+        stopThread();
+        waitForThread(false);
+    }
+    libusb_exit(NULL);
+}
+
+int UsbHotplugMonitor :: addWatch(uint16_t vendorId, uint16_t productId, WatchCallback callback) {
+
+    if(!isSupported()) return -1;
+
+    int watchId;
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        watchId = nextWatchId++;
+        watchesById[watchId] = Watch{watchId, 0, callback};
+    }
+
+    // with the enumerate flag, libusb calls hotplugCallback for the devices
+    // that are already there before it returns
+    libusb_hotplug_callback_handle handle;
+    int result = libusb_hotplug_register_callback(NULL,
+        (libusb_hotplug_event)(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+        LIBUSB_HOTPLUG_ENUMERATE, vendorId, productId, LIBUSB_HOTPLUG_MATCH_ANY,
+        hotplugCallback, (void*)(intptr_t)watchId, &handle);
+
+    if(result!=LIBUSB_SUCCESS) {
+        ofLogError("UsbHotplugMonitor :: addWatch - couldn't register hotplug callback : "+ofToString(result));
+        std::lock_guard<std::mutex> lock(watchMutex);
+        watchesById.erase(watchId);
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        watchesById[watchId].handle = handle;
+    }
+
+    if(!isThreadRunning()) startThread();
+    return watchId;
+}
+
+void UsbHotplugMonitor :: removeWatch(int watchId) {
+
+    bool noWatchesLeft;
+    {
+        // waits for the callback to finish if it's being called
+        std::lock_guard<std::mutex> lock(watchMutex);
+        auto it = watchesById.find(watchId);
+        if(it==watchesById.end()) return;
+        libusb_hotplug_deregister_callback(NULL, it->second.handle);
+        watchesById.erase(it);
+        noWatchesLeft = watchesById.empty();
+    }
+    if(noWatchesLeft && isThreadRunning()) {
+        stopThread();
+        waitForThread(false);
+        // the events for the removed watches are just thrown away
+        processEvents();
+    }
+}
+
+int LIBUSB_CALL UsbHotplugMonitor :: hotplugCallback(libusb_context* context, libusb_device* device, libusb_hotplug_event event, void* userData) {
+
+    // we're not allowed to open the device in here so pass it on
+    // to the event thread
+    UsbHotplugMonitor* monitor = instance();
+    libusb_ref_device(device);
+    std::lock_guard<std::mutex> lock(monitor->eventMutex);
+    monitor->pendingEvents.push_back(HotplugEvent{(int)(intptr_t)userData, device, event==LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED});
+
+    // returning 0 keeps the callback registered
+    return 0;
+}
+
+void UsbHotplugMonitor :: threadedFunction() {
+
+    ThreadPolicy::apply(THREAD_ROLE_DISCOVERY, "USB hotplug");
+
+    while(isThreadRunning()) {
+        // the enumerated devices are already queued so deal with those first
+        processEvents();
+
+        // returns as soon as something happens, the timeout is just so
+        // that we notice when the thread is stopped
+        timeval timeout = {0, 100000};
+        int result = libusb_handle_events_timeout_completed(NULL, &timeout, NULL);
+        if((result<0) && (result!=LIBUSB_ERROR_INTERRUPTED)) {
+            ofLogError("UsbHotplugMonitor - libusb_handle_events failed : "+ofToString(result));
+            sleep(100);
+        }
+    }
+}
+
+void UsbHotplugMonitor :: processEvents() {
+
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        if(pendingEvents.empty()) return;
+        std::swap(pendingEvents, eventsToProcess);
+    }
+
+    for(HotplugEvent& event : eventsToProcess) {
+        {
+            std::lock_guard<std::mutex> lock(watchMutex);
+            auto it = watchesById.find(event.watchId);
+            if(it!=watchesById.end()) {
+                it->second.callback(event.device, event.arrived);
+            }
+        }
+        libusb_unref_device(event.device);
+    }
+    eventsToProcess.clear();
+}
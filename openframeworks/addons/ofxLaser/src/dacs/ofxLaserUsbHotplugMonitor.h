@@ -0,0 +1,77 @@
+//
+//  ofxLaserUsbHotplugMonitor.h
+//  ofxLaser
+//
+
+#pragma once
+#include "ofMain.h"
+#include "libusb.h"
+#include "ofxLaserThreadPolicy.h"
+
+// Tells the USB DAC managers when their devices are plugged in or
+// unplugged, so they don't have to go through every USB device (and
+// open them all) whenever the DAC list is updated.
+//
+// It uses libusb's hotplug callbacks with one event thread shared by
+// all the managers. libusb doesn't let you open a device from inside
+// the callback, so the callback only queues the event and the watch
+// callback is called afterwards, still on the event thread. The managers
+// don't open the device there either (a DAC thread might be claiming it
+// back), they queue it again and read the serial number on their own
+// thread in updateDacList.
+//
+// Hotplug isn't available everywhere (notably Windows), check
+// isSupported() and fall back to scanning the device list.
+
+namespace ofxLaser {
+
+class UsbHotplugMonitor : public ofThread {
+
+    public :
+
+    static UsbHotplugMonitor* instance();
+    static bool isSupported();
+
+    // called on the event thread, with arrived false when the device is
+    // unplugged. The device is valid for the duration of the call.
+    typedef std::function<void(libusb_device*, bool)> WatchCallback;
+
+    // calls the callback for devices that are already plugged in, then
+    // for every change. Returns an id for removeWatch or -1 if it
+    // couldn't register with libusb.
+    int addWatch(uint16_t vendorId, uint16_t productId, WatchCallback callback);
+    void removeWatch(int watchId);
+
+    protected :
+
+    // use instance()
+    UsbHotplugMonitor();
+    ~UsbHotplugMonitor();
+
+    void threadedFunction() override;
+    void processEvents();
+
+    static int LIBUSB_CALL hotplugCallback(libusb_context* context, libusb_device* device, libusb_hotplug_event event, void* userData);
+
+    struct Watch {
+        int id;
+        libusb_hotplug_callback_handle handle;
+        WatchCallback callback;
+    };
+    struct HotplugEvent {
+        int watchId;
+        libusb_device* device;
+        bool arrived;
+    };
+
+    std::mutex watchMutex;
+    std::map<int, Watch> watchesById;
+    int nextWatchId = 0;
+
+    std::mutex eventMutex;
+    vector<HotplugEvent> pendingEvents;
+    // swapped with pendingEvents so we don't allocate for each event
+    vector<HotplugEvent> eventsToProcess;
+
+};
+}
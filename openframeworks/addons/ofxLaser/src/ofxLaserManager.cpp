@@ -33,15 +33,10 @@ Manager :: Manager(bool hidecanvas) {
     if(hidecanvas) showCanvas = false;
 
 
+    // also makes a laser if none were loaded
     initAndLoadSettings();
     
-    // if no lasers are loaded make one and add a zone
-    if(lasers.size()==0) {
-        createAndAddLaser();
-        
-        //lasers[0]->addZone(0);
-       
-    }
+    // add a zone if there isn't one
     if(showCanvas) {
         if(canvasTarget.getNumZoneIds()==0) {
             createDefaultCanvasZone();
@@ -80,7 +75,6 @@ Manager :: Manager(bool hidecanvas) {
         }
     }
     
-    params.add(customParams);
     ofAddListener(ofEvents().mouseEntered, this, &Manager::mouseEntered, OF_EVENT_ORDER_BEFORE_APP);
     ofAddListener(ofEvents().mouseExited, this, &Manager::mouseExited, OF_EVENT_ORDER_BEFORE_APP);
     
@@ -104,7 +98,6 @@ Manager::~Manager() {
     ofRemoveListener(ofEvents().mousePressed, this, &Manager::mousePressed, OF_EVENT_ORDER_BEFORE_APP);
     ofRemoveListener(ofEvents().mouseReleased, this, &Manager::mouseReleased, OF_EVENT_ORDER_BEFORE_APP);
     ofRemoveListener(ofEvents().mouseDragged, this, &Manager::mouseDragged, OF_EVENT_ORDER_BEFORE_APP);
-    ofRemoveListener(params.parameterChangedE(), this, &Manager::paramChanged);
 
 }
 
@@ -146,8 +139,6 @@ void Manager :: initAndLoadSettings() {
     //interfaceParams.add(laserMasks.set("Laser mask shapes", false));
     params.add(interfaceParams);
     
-    customParams.setName("CUSTOM PARAMETERS");
-    
     // is this still used ?
     //params.add(zoneEditorShowLaserPath.set("Show path in zone editor", true));
     //params.add(zoneEditorShowLaserPoints.set("Show points in zone editor", false));
@@ -156,19 +147,16 @@ void Manager :: initAndLoadSettings() {
     
     params.add(canvasGridSnap.set("Canvas snap to grid", true));
     params.add(canvasGridSize.set("Canvas grid size", 20,1,50));
-    
-    params.add(globalLatency.set("Latency (ms)", 150,0,400));
 
    // params.add(showDacAssignmentWindow.set("showDacAssignmentWindow", false));
     params.add(showCustomParametersWindow.set("showCustomParametersWindow", true));
     params.add(showLaserOverviewWindow.set("showLaserManagementWindow", true));
     params.add(showLaserOutputSettingsWindow.set("showLaserOutputSettingsWindow", true));
 
-    loadSettings();
+ 
+    // the latency settings, loading and the laser settings
+    ManagerBase::initAndLoadSettings();
     showDacAssignmentWindow = false; 
-    // param changed updates zone settings and global latency on all
-    paramChanged(params);
-    ofAddListener(params.parameterChangedE(), this, &Manager::paramChanged);
  
     //showInputPreview = true;
     
@@ -204,10 +192,8 @@ void Manager :: serialize(ofJson& json) {
 }
 
 void Manager :: paramChanged(ofAbstractParameter& e) {
-    for(Laser* laser : lasers) {
-        //laser->setGrid(zoneGridSnap, zoneGridSize);
-        laser->maxLatencyMS = globalLatency;
-    }
+    // latency settings and saving
+    ManagerBase :: paramChanged(e);
     for(LaserZoneViewController& laserview : laserZoneViews) {
         laserview.setGrid(zoneGridSnap, zoneGridSize);
         
@@ -215,13 +201,19 @@ void Manager :: paramChanged(ofAbstractParameter& e) {
     canvasViewController.setGrid(canvasGridSnap, canvasGridSize);
     
     //ofLogNotice() << "paramChanged " << e.getName();
-    scheduleSaveSettings();
 }
 
 void Manager :: update() {
  
     
-    ManagerBase :: update();
+    updateFrame();
+    updateUI();
+   
+}
+
+void Manager :: updateUI() {
+    
+    std::lock_guard<std::mutex> lock(frameMutex);
 
     updateDisplayRectangle();
     
@@ -470,32 +462,6 @@ bool Manager::isGuiVisible() {
     return guiIsVisible;
 }
 
-void Manager::addCustomParameter(ofAbstractParameter& param, bool loadFromSettings){
-    customParams.add(param);
-    if(loadFromSettings){
-        //loadJson.find("custom");
-        if(!loadedJson.empty()) {
-            if(loadedJson.contains("Laser")) {
-                if(loadedJson["Laser"].contains("CUSTOM_PARAMETERS")) {
-                    //     auto value = loadJson["Laser"]["Custom"][param.getName()];
-                    try {
-                        ofDeserialize(loadedJson["Laser"]["CUSTOM_PARAMETERS"], param);
-                    } catch(...) {
-                        
-                    }
-                    
-                }
-            }
-        }
-        //ofDeserialize(loadJson["custom"], param);
-        //ofLogNotice(loadJson.dump(3));
-        //ofLogNotice(loadJson["Laser"].dump(3));
-        //ofLogNotice(loadJson["Laser"]["Custom"].dump(3));
-        //ofLogNotice(loadJson["Laser"]["Custom"][param.getName()].dump(3));
-        
-    }
-}
-
 glm::vec2 Manager::screenToLaserInput(glm::vec2& pos){
     
     glm::vec2 returnpos= pos ;//
@@ -506,9 +472,15 @@ glm::vec2 Manager::screenToLaserInput(glm::vec2& pos){
 
 void Manager:: drawUI(){
     
-    drawPreviews();
-    ofxLaser::UI::startGui();
-    drawLaserGui();
+    {
+        // the previews and the gui read and change the lasers and zones,
+        // so the frame can't be drawn or sent until they're done. The
+        // gui's draw lists are rendered after that.
+        std::lock_guard<std::mutex> lock(frameMutex);
+        drawPreviews();
+        ofxLaser::UI::startGui();
+        drawLaserGui();
+    }
     finishLaserUI();
 }
 
@@ -1535,6 +1507,21 @@ void Manager :: guiLaserOverview() {
 //
 //        }
         UI::addIntSlider(globalLatency);
+        UI::addCheckbox(autoLatency);
+        UI::toolTip("Only for DACs that report their buffer level (Ether Dream and LaserDock network), the others stay at the latency above");
+        if(autoLatency) {
+            UI::addFloatSlider(autoLatencyUnderrunProbability, "%.3f");
+        }
+        UI::addCheckbox(syncLasers);
+        if(syncLasers) {
+            UI::addFloatSlider(syncToleranceMS, "%.1f");
+        }
+        UI::addCheckbox(useSharedFrames);
+        if(useSharedFrames && sharedFrameReader.isOpen()) {
+            // from when the other process wrote the frame
+            ImGui::Text("%d inputs, %.0f fps", sharedFrameReader.getNumActiveSlots(), sharedFrameReader.getFramesPerSecond());
+            ImGui::Text("Latency to DAC %.1f ms, to output %.1f ms (max %.1f)", sharedFrameReader.getSendLatencyMS(), sharedFrameReader.getOutputLatencyMS(), sharedFrameReader.getMaxOutputLatencyMS());
+        }
         
         if(viewMode == OFXLASER_VIEW_CANVAS) {
 //            if(UI::addParameter(canvasTarget.getWidth())) {
@@ -2471,7 +2458,6 @@ void Manager::guiDacAnalytics() {
             uint64_t endTimeMicros = ofGetElapsedTimeMicros();
             uint64_t startTimeMicros = endTimeMicros - visibledurationmicros;
             int numvalues = 1000;
-            dac->stateRecorder.recording = true;
             dac->stateRecorder.getLatencyValuesForTime(startTimeMicros, endTimeMicros, numvalues);
             label = "Round trip time";
             ImGui::PlotHistogram(label.c_str(), dac->stateRecorder.values, numvalues, 0, "", 0.0f, 1000.0f, ImVec2(0,80));
@@ -2497,9 +2483,44 @@ void Manager::guiDacAnalytics() {
             label = "Frame skips ";
             ImGui::PlotHistogram(label.c_str(), dac->frameRecorder.values, numvalues, 0, "",0.0f, 1.0f, ImVec2(0,80));
 
+            if(dac->getAutoLatency()) {
+                DacLatencyTuner& tuner = dac->latencyTuner;
+                ImGui::Text("Latency (auto) : %d ms", tuner.getLatencyMS());
+                ImGui::Text("Underrun probability : %.3f (target %.3f)  Underruns : %d", tuner.getUnderrunProbability(), tuner.targetUnderrunProbability.load(), tuner.getUnderrunCount());
+                ImGui::Text("Min buffer : %.1f ms  Round trip jitter : %.2f ms", tuner.getMinBufferMS(), tuner.getJitterMS());
+            } else if(autoLatency && !dac->canAutoLatency()) {
+                ImGui::Text("Latency : %d ms (auto latency isn't available for this DAC)", dac->getLatencyMS());
+            } else {
+                ImGui::Text("Latency : %d ms", dac->getLatencyMS());
+            }
+            ImGui::Text("Clock drift : %.0f ppm  Buffer estimate : %d +/- %.0f", dac->bufferEstimator.getDriftPPM(), dac->estimateBufferFullness(), dac->bufferEstimator.getBufferUncertainty());
+            
+            if(syncLasers) {
+                // how far each laser's frames start from the shared
+                // presentation time
+                ImGui::Text("Frame sync skew :");
+                for(size_t i = 0; i<lasers.size(); i++) {
+                    DacBaseThreaded* laserdac = dynamic_cast<DacBaseThreaded*> (lasers[i]->getDac());
+                    if(laserdac==nullptr) continue;
+                    if(laserdac->isFrameSyncActive()) {
+                        ImGui::Text("  Laser %d : %.2f ms (corrected %.2f ms)", (int)i+1, laserdac->syncSkewMicros/1000.0f, laserdac->syncCorrectionMicros/1000.0f);
+                    } else {
+                        ImGui::Text("  Laser %d : not synced", (int)i+1);
+                    }
+                }
+            }
+
           //  UI::addIntSlider(dac->pointBufferMinParam);
             UI::addFloatSlider(dacSettingsTimeSlice);
             
+            // writes the data for all the DACs to data/ofxLaser/telemetry
+            DacTelemetryWriter& telemetryWriter = *DacTelemetryWriter::instance();
+            bool exporting = telemetryWriter.isExporting();
+            if(ImGui::Checkbox("Export telemetry to CSV", &exporting)) {
+                if(exporting) telemetryWriter.start();
+                else telemetryWriter.stop();
+            }
+            
            
         }
         
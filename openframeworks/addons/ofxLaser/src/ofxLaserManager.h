@@ -11,6 +11,7 @@
 #include "ofxLaserZoneViewController.h"
 #include "ofxLaserCanvasViewController.h"
 #include "ofxLaserIconSVGs.h"
+#include "ofxLaserBitmapMaskManager.h"
 
 #define OFX_LASER_HIDE_CANVAS true
 
@@ -36,15 +37,17 @@ class Manager : public ManagerBase {
     Manager(bool hidecanvas = false);
     ~Manager();
     
-    virtual void initAndLoadSettings();
+    virtual void initAndLoadSettings() override;
     virtual void update() override;
+    // update() is updateFrame() then updateUI(). If the show is drawn and
+    // sent on its own thread, that thread calls updateFrame() (holding
+    // getFrameMutex()) and the app's update() only calls updateUI().
+    void updateUI();
     virtual void createAndAddLaser() override;
-    void paramChanged(ofAbstractParameter& e) ;
+    void paramChanged(ofAbstractParameter& e) override;
     
     bool deleteLaser(Laser* laser) override;
     
-    void addCustomParameter(ofAbstractParameter& param, bool loadFromSettings = true);
-    
     virtual void serialize(ofJson& json) override;
     virtual bool deserialize(ofJson& json) override;
     
@@ -76,6 +79,23 @@ class Manager : public ManagerBase {
     void drawUI();
     void drawPreviews();
     
+    // for drawing into the canvas with the usual oF drawing functions.
+    // These need a window so they're here rather than in ManagerBase.
+    void beginDraw() {
+        // to do : check target
+        ofViewport((ofGetWidth()-canvasTarget.getWidth())/-2, (ofGetHeight()-canvasTarget.getHeight())/-2, ofGetWidth(), ofGetHeight()) ;
+        ofPushMatrix();
+        ofTranslate((ofGetWidth()-canvasTarget.getWidth())/2, (ofGetHeight()-canvasTarget.getHeight())/2);
+        
+    }
+    void endDraw() {
+        ofPopMatrix();
+        ofViewport(0,0,ofGetWidth(), ofGetHeight());
+    }
+    
+    // it's an ofFbo, so it lives here rather than in ManagerBase
+    BitmapMaskManager laserMask;
+    
     void renderPreview();
    
     glm::vec2 screenToLaserInput(glm::vec2& pos);
@@ -141,7 +161,6 @@ class Manager : public ManagerBase {
     
     
     ofParameterGroup interfaceParams;
-    ofParameterGroup customParams;
     ofParameter<bool> zoneGridSnap;
     ofParameter<int> zoneGridSize;
     
@@ -152,8 +171,6 @@ class Manager : public ManagerBase {
     ofParameter<bool> zoneEditorShowLaserPath;
     ofParameter<bool> zoneEditorShowLaserPoints;
     
-    ofParameter<int> globalLatency; 
-
     bool showDacAnalytics;
     ofParameter<float> dacSettingsTimeSlice;
 
@@ -165,7 +182,6 @@ class Manager : public ManagerBase {
   
     protected :
     
-    bool initialised = false;
     bool windowActive = true; 
    
     int selectedLaserIndex;
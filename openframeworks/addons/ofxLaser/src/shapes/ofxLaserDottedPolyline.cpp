@@ -0,0 +1,117 @@
+//
+//  ofxLaserDottedPolyline.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserDottedPolyline.h"
+
+using namespace ofxLaser;
+
+DottedPolyline :: DottedPolyline(const vector<glm::vec3>& vertices, bool closed, float dotSpacing, float phaseOffset, const ColourFunction& colourFunction, float dotDwell, string profilelabel) {
+    init(vertices, closed, dotSpacing, phaseOffset, colourFunction, dotDwell, profilelabel);
+}
+
+DottedPolyline :: DottedPolyline(const vector<glm::vec3>& vertices, bool closed, float dotSpacing, float phaseOffset, const ofColor& col, float dotDwell, string profilelabel) {
+    init(vertices, closed, dotSpacing, phaseOffset, [&](const glm::vec3&, int) { return col; }, dotDwell, profilelabel);
+}
+
+void DottedPolyline :: init(const vector<glm::vec3>& vertices, bool closed, float dotSpacing, float phaseOffset, const ColourFunction& colourFunction, float dotDwell, string profilelabel) {
+
+    reversable = true;
+    tested = false;
+    profileLabel = profilelabel;
+    dwell = dotDwell;
+    colour = ofColor::white;
+
+    size_t numVertices = vertices.size();
+    if((numVertices<2) || (dotSpacing<=0)) return;
+    size_t numSegments = closed ? numVertices : numVertices-1;
+
+    // the first dot is between 0 and dotSpacing along the path
+    float length = fmodf(phaseOffset, dotSpacing);
+    if(length<0) length+=dotSpacing;
+
+    // walk along the path segment by segment, length is how far
+    // along the current segment the next dot is
+    for(size_t i = 0; i<numSegments; i++) {
+        const glm::vec3& start = vertices[i];
+        const glm::vec3& end = vertices[(i+1)%numVertices];
+        float segmentLength = glm::distance(start, end);
+        for(; length<segmentLength; length+=dotSpacing) {
+            glm::vec3 p = glm::mix(start, end, length/segmentLength);
+            dotPositions.push_back(p);
+            dotColours.push_back(colourFunction(p, (int)i));
+        }
+        length-=segmentLength;
+    }
+    if(dotPositions.empty()) return;
+
+    colour = dotColours.front();
+    startPos = dotPositions.front();
+    endPos = dotPositions.back();
+    boundingBox.set(dotPositions.front(), 1, 1);
+    for(const glm::vec3& p : dotPositions) {
+        boundingBox.growToInclude(p);
+    }
+}
+
+void DottedPolyline :: appendPointsToVector(vector<ofxLaser::Point>& points, const RenderProfile& profile, float speedMultiplier) {
+
+    if((&profile==cachedProfile) && (speedMultiplier==cachedSpeedMultiplier)) {
+        points.insert(points.end(), cachedPoints.begin(), cachedPoints.end());
+        return;
+    }
+    cachedProfile = &profile;
+    cachedSpeedMultiplier = speedMultiplier;
+    cachedPoints.clear();
+
+    // each dot is on for as long as a Dot with the same intensity would be
+    int dwellPoints = MAX(1, (int)ceil(profile.dotMaxPoints * dwell / speedMultiplier));
+
+    for(size_t i = 0; i<dotPositions.size(); i++) {
+        if(i>0) {
+            // blank move from the last dot at the profile's speed, the first
+            // and last points are on the dots so they're left out
+            const glm::vec3& from = dotPositions[i-1];
+            const glm::vec3& to = dotPositions[i];
+            vector<float>& unitDistances = getPointsAlongDistance(glm::distance(from, to), profile.acceleration, profile.speed, speedMultiplier);
+            for(size_t j = 1; j+1<unitDistances.size(); j++) {
+                cachedPoints.push_back(ofxLaser::Point(glm::mix(from, to, unitDistances[j]), ofColor(0)));
+            }
+        }
+        for(int j = 0; j<dwellPoints; j++) {
+            cachedPoints.push_back(ofxLaser::Point(dotPositions[i], dotColours[i]));
+        }
+    }
+    points.insert(points.end(), cachedPoints.begin(), cachedPoints.end());
+}
+
+void DottedPolyline :: addPreviewToMesh(ofMesh& mesh) {
+    // a small circle for each dot, the same as Dot
+    float radius = ofMap(dwell, 0, 1, 0.1, 1.5, true);
+    float brightness = ofMap(dwell, 0, 0.5, 0, 1, true);
+    for(size_t i = 0; i<dotPositions.size(); i++) {
+        ofColor c = dotColours[i];
+        c*=brightness;
+        ofVec3f v(0, -radius);
+        mesh.addColor(ofColor(0));
+        mesh.addVertex(v + dotPositions[i]);
+        for(int angle = 0; angle<=360; angle+=30) {
+            v.set(0, -radius);
+            v.rotate(angle, ofVec3f(0, 0, 1));
+            mesh.addColor(c);
+            mesh.addVertex(v + dotPositions[i]);
+        }
+        v.set(0, -radius);
+        mesh.addColor(ofColor(0));
+        mesh.addVertex(v + dotPositions[i]);
+    }
+}
+
+bool DottedPolyline :: intersectsRect(ofRectangle & rect) {
+    if(!rect.intersects(boundingBox)) return false;
+    for(const glm::vec3& p : dotPositions) {
+        if(rect.inside(p)) return true;
+    }
+    return false;
+}
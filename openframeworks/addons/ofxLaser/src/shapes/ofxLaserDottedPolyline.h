@@ -0,0 +1,54 @@
+//
+//  ofxLaserDottedPolyline.h
+//  ofxLaser
+//
+// A path drawn as evenly spaced dots, as a single shape. Drawing the same
+// thing with separate Dots means the optimiser sorts every dot and puts a
+// full blank move and pre/post dwell between each one. Here the dots are
+// joined by short blank moves at the render profile's speed, so the whole
+// path is sorted and blanked as one unit.
+
+#pragma once
+
+#include "ofxLaserShape.h"
+
+namespace ofxLaser {
+class DottedPolyline : public Shape {
+
+    public :
+
+    // gets each dot's position and the index of the vertex at the start of
+    // the path segment it's on, and returns the dot's colour
+    typedef std::function<ofColor(const glm::vec3& position, int vertexIndex)> ColourFunction;
+
+    // dots are every dotSpacing along the path, starting phaseOffset from
+    // the first vertex (it wraps around on closed paths). dotDwell is how
+    // long each dot is on, as a fraction of the render profile's dot max
+    // points, like a Dot's intensity
+    DottedPolyline(const vector<glm::vec3>& vertices, bool closed, float dotSpacing, float phaseOffset, const ColourFunction& colourFunction, float dotDwell, string profilelabel);
+    DottedPolyline(const vector<glm::vec3>& vertices, bool closed, float dotSpacing, float phaseOffset, const ofColor& col, float dotDwell, string profilelabel);
+
+    virtual Shape* clone() const override {
+        return new DottedPolyline(*this);
+    }
+
+    void appendPointsToVector(vector<ofxLaser::Point>& points, const RenderProfile& profile, float speedMultiplier) override;
+    void addPreviewToMesh(ofMesh& mesh) override;
+    virtual bool intersectsRect(ofRectangle & rect) override;
+
+    int getNumDots() const { return (int)dotPositions.size(); }
+
+    protected :
+    void init(const vector<glm::vec3>& vertices, bool closed, float dotSpacing, float phaseOffset, const ColourFunction& colourFunction, float dotDwell, string profilelabel);
+
+    vector<glm::vec3> dotPositions;
+    vector<ofColor> dotColours;
+    float dwell = 1;
+    ofRectangle boundingBox;
+
+    const RenderProfile* cachedProfile = nullptr;
+    float cachedSpeedMultiplier = 0;
+    vector<ofxLaser::Point> cachedPoints;
+
+};
+}
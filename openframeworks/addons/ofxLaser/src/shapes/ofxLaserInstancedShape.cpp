@@ -0,0 +1,106 @@
+//
+//  ofxLaserInstancedShape.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserInstancedShape.h"
+
+using namespace ofxLaser;
+
+InstanceSource :: InstanceSource(Shape* sourceshape) {
+    shape = sourceshape;
+    shape->addPreviewToMesh(previewMesh);
+    const vector<glm::vec3>& vertices = previewMesh.getVertices();
+    if(vertices.size()>0) {
+        boundingBox.set(vertices.front(), 1, 1);
+        for(const glm::vec3& v : vertices) {
+            boundingBox.growToInclude(v);
+        }
+    } else {
+        boundingBox.set(shape->getStartPos(), 1, 1);
+        boundingBox.growToInclude(shape->getEndPos());
+    }
+}
+
+InstanceSource :: ~InstanceSource() {
+    delete shape;
+}
+
+const vector<ofxLaser::Point>& InstanceSource :: getPoints(const RenderProfile& profile, float speedMultiplier) {
+    if((&profile!=cachedProfile) || (speedMultiplier!=cachedSpeedMultiplier)) {
+        cachedProfile = &profile;
+        cachedSpeedMultiplier = speedMultiplier;
+        cachedPoints.clear();
+        shape->appendPointsToVector(cachedPoints, profile, speedMultiplier);
+    }
+    return cachedPoints;
+}
+
+InstancedShape :: InstancedShape(std::shared_ptr<InstanceSource> instancesource, const ShapeInstance& shapeinstance) {
+
+    source = instancesource;
+    instance = shapeinstance;
+
+    Shape& sourceshape = *source->shape;
+    reversable = sourceshape.reversable;
+    tested = false;
+    profileLabel = sourceshape.profileLabel;
+
+    red = instance.colour.r/255.0f*instance.intensity;
+    green = instance.colour.g/255.0f*instance.intensity;
+    blue = instance.colour.b/255.0f*instance.intensity;
+    colour = sourceshape.getColour();
+    colour.r*=red;
+    colour.g*=green;
+    colour.b*=blue;
+
+    startPos = getTransformed(sourceshape.getStartPos());
+    endPos = getTransformed(sourceshape.getEndPos());
+
+    // the transformed corners of the source's bounds
+    const ofRectangle& sourcebounds = source->boundingBox;
+    boundingBox.set(getTransformed(sourcebounds.getTopLeft()), 1, 1);
+    boundingBox.growToInclude(getTransformed(sourcebounds.getTopRight()));
+    boundingBox.growToInclude(getTransformed(sourcebounds.getBottomLeft()));
+    boundingBox.growToInclude(getTransformed(sourcebounds.getBottomRight()));
+}
+
+void InstancedShape :: appendPointsToVector(vector<ofxLaser::Point>& points, const RenderProfile& profile, float speedMultiplier) {
+
+    const vector<ofxLaser::Point>& sourcepoints = source->getPoints(profile, speedMultiplier);
+
+    // one pass over the cached points, with the matrix and tint pulled out
+    // of the loop
+    const glm::mat4& m = instance.transform;
+    size_t start = points.size();
+    points.resize(start + sourcepoints.size());
+    for(size_t i = 0; i<sourcepoints.size(); i++) {
+        const ofxLaser::Point& s = sourcepoints[i];
+        ofxLaser::Point& p = points[start+i];
+        p.x = m[0][0]*s.x + m[1][0]*s.y + m[2][0]*s.z + m[3][0];
+        p.y = m[0][1]*s.x + m[1][1]*s.y + m[2][1]*s.z + m[3][1];
+        p.z = m[0][2]*s.x + m[1][2]*s.y + m[2][2]*s.z + m[3][2];
+        p.r = s.r*red;
+        p.g = s.g*green;
+        p.b = s.b*blue;
+        p.useCalibration = s.useCalibration;
+    }
+}
+
+void InstancedShape :: addPreviewToMesh(ofMesh& mesh) {
+    const ofMesh& sourcemesh = source->previewMesh;
+    const vector<glm::vec3>& vertices = sourcemesh.getVertices();
+    const vector<ofFloatColor>& colours = sourcemesh.getColors();
+    for(size_t i = 0; i<vertices.size(); i++) {
+        ofFloatColor c = (i<colours.size()) ? colours[i] : ofFloatColor::white;
+        c.r*=red;
+        c.g*=green;
+        c.b*=blue;
+        mesh.addColor(c);
+        mesh.addVertex(getTransformed(vertices[i]));
+    }
+}
+
+bool InstancedShape :: intersectsRect(ofRectangle & rect) {
+    return rect.intersects(boundingBox);
+}
@@ -0,0 +1,80 @@
+//
+//  ofxLaserInstancedShape.h
+//  ofxLaser
+//
+// For drawing copies of the same shape, like prism and array effects.
+// The points for the shape are only worked out once per render profile
+// and each instance then transforms and tints the cached points. Every
+// instance is still its own shape, so the optimiser sorts them separately.
+//
+// The instance transforms are in canvas space and are applied to the
+// rendered points, so scaling an instance up also spreads its points out.
+
+#pragma once
+
+#include "ofxLaserShape.h"
+
+namespace ofxLaser {
+
+struct ShapeInstance {
+    ShapeInstance(const glm::mat4& instancetransform = glm::mat4(1.0f), const ofColor& instancecolour = ofColor::white, float instanceintensity = 1) : transform(instancetransform), colour(instancecolour), intensity(instanceintensity) {}
+    glm::mat4 transform;
+    // multiplies the shape's colours
+    ofColor colour;
+    float intensity;
+};
+
+// the shape that all the instances share
+class InstanceSource {
+
+    public :
+
+    // takes ownership of the shape
+    InstanceSource(Shape* sourceshape);
+    ~InstanceSource();
+
+    const vector<ofxLaser::Point>& getPoints(const RenderProfile& profile, float speedMultiplier);
+
+    Shape* shape;
+    // from the shape's preview, for the instances' bounds and previews
+    ofMesh previewMesh;
+    ofRectangle boundingBox;
+
+    protected :
+    const RenderProfile* cachedProfile = nullptr;
+    float cachedSpeedMultiplier = 0;
+    vector<ofxLaser::Point> cachedPoints;
+
+};
+
+class InstancedShape : public Shape {
+
+    public :
+
+    InstancedShape(std::shared_ptr<InstanceSource> instancesource, const ShapeInstance& shapeinstance);
+
+    // the clone shares the source, which stays around until the last
+    // instance using it is deleted
+    virtual Shape* clone() const override {
+        return new InstancedShape(*this);
+    }
+
+    void appendPointsToVector(vector<ofxLaser::Point>& points, const RenderProfile& profile, float speedMultiplier) override;
+    void addPreviewToMesh(ofMesh& mesh) override;
+    virtual bool intersectsRect(ofRectangle & rect) override;
+
+    protected :
+    glm::vec3 getTransformed(const glm::vec3& p) const {
+        glm::vec4 transformed = instance.transform * glm::vec4(p.x, p.y, p.z, 1);
+        return glm::vec3(transformed.x, transformed.y, transformed.z);
+    }
+
+    std::shared_ptr<InstanceSource> source;
+    ShapeInstance instance;
+    // colour multipliers from the instance's colour and intensity
+    float red, green, blue;
+    ofRectangle boundingBox;
+
+};
+
+}
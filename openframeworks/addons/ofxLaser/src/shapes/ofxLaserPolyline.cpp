@@ -200,7 +200,7 @@ void Polyline::appendPointsToVector(vector<ofxLaser::Point>& points, const Rende
 				
 				if(multicoloured) {
 					int colourindex = round(polyline.getIndexAtLength(distanceAlongPoly)); // TODO - interpolate?
-					colourindex = ofClamp(colourindex, 0,colours.size());
+					colourindex = ofClamp(colourindex, 0, (int)colours.size()-1);
 					cachedPoints.push_back(ofxLaser::Point(p, colours[colourindex]));
 					
 				} else {
@@ -0,0 +1,78 @@
+//
+//  ofxLaserSharedPointsShape.h
+//  ofxLaser
+//
+// A shape made of points that live in the shared memory segment (see
+// SharedFrameReader). The points are read straight out of the segment
+// when the laser renders them, so this is only valid until the reader
+// takes the next frame, which happens after the shapes are deleted.
+
+#pragma once
+
+#include "ofxLaserShape.h"
+#include "ofxLaserManualShape.h"
+#include "ofxLaserSharedFrames.h"
+
+namespace ofxLaser {
+class SharedPointsShape : public Shape {
+
+    public :
+
+    SharedPointsShape(const ofxlaser_shm_point* sharedpoints, int numpoints, string profilelabel) {
+        points = sharedpoints;
+        numPoints = numpoints;
+        profileLabel = profilelabel;
+
+        startPos.set(points[0].x, points[0].y);
+        endPos.set(points[numPoints-1].x, points[numPoints-1].y);
+
+        float left = points[0].x, right = points[0].x, top = points[0].y, bottom = points[0].y;
+        for(int i = 1; i<numPoints; i++) {
+            left = MIN(left, points[i].x);
+            right = MAX(right, points[i].x);
+            top = MIN(top, points[i].y);
+            bottom = MAX(bottom, points[i].y);
+        }
+        boundingBox.set(left, top, MAX(right-left, 1), MAX(bottom-top, 1));
+        tested = false;
+    }
+
+    // if the laser is paused it keeps a clone, which has to outlive
+    // the shared memory so it gets a copy
+    virtual Shape* clone() const override {
+        vector<ofPoint> copiedpoints;
+        vector<ofColor> copiedcolours;
+        for(int i = 0; i<numPoints; i++) {
+            copiedpoints.emplace_back(points[i].x, points[i].y);
+            copiedcolours.emplace_back(points[i].r, points[i].g, points[i].b);
+        }
+        return new ManualShape(copiedpoints, copiedcolours, true, profileLabel);
+    }
+
+    void appendPointsToVector(vector<ofxLaser::Point>& destpoints, const RenderProfile& profile, float speedMultiplier) override {
+        for(int i = 0; i<numPoints; i++) {
+            const ofxlaser_shm_point& p = points[i];
+            destpoints.push_back(ofxLaser::Point(ofPoint(p.x, p.y), ofColor(p.r, p.g, p.b), true));
+        }
+    };
+
+    void addPreviewToMesh(ofMesh& mesh) override {
+        for(int i = 0; i<numPoints; i++) {
+            const ofxlaser_shm_point& p = points[i];
+            mesh.addVertex(glm::vec3(p.x, p.y, 0));
+            mesh.addColor(ofColor(p.r, p.g, p.b));
+        }
+    }
+
+    bool intersectsRect(ofRectangle & rect) override {
+        return rect.intersects(boundingBox);
+    }
+
+    protected :
+    const ofxlaser_shm_point* points;
+    int numPoints;
+    ofRectangle boundingBox;
+
+};
+
+}
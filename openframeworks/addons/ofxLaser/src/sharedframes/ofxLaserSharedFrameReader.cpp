@@ -0,0 +1,241 @@
+//
+//  ofxLaserSharedFrameReader.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserSharedFrameReader.h"
+#include "ofxLaserSharedPointsShape.h"
+#include "ofxLaserPolyline.h"
+#include "ofxLaserConstants.h"
+
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+using namespace ofxLaser;
+
+// the layout is shared with other languages so make sure the compiler
+// hasn't added anything
+static_assert(sizeof(ofxlaser_shm_point) == 12, "ofxlaser_shm_point should be 12 bytes");
+static_assert(sizeof(ofxlaser_shm_buffer) == 2080 + 12 * OFXLASER_SHM_MAX_POINTS, "ofxlaser_shm_buffer has padding");
+static_assert(sizeof(ofxlaser_shm_slot) == 64 + 3 * sizeof(ofxlaser_shm_buffer), "ofxlaser_shm_slot has padding");
+static_assert(sizeof(ofxlaser_shm_header) == 48, "ofxlaser_shm_header should be 48 bytes");
+
+SharedFrameReader :: SharedFrameReader() {
+}
+
+SharedFrameReader :: ~SharedFrameReader() {
+    close();
+}
+
+uint64_t SharedFrameReader :: getMonotonicNanos() {
+#ifndef _MSC_VER
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+bool SharedFrameReader :: open() {
+
+    if(isOpen()) return true;
+
+#ifndef _MSC_VER
+    // only this user can write frames
+    fileDescriptor = shm_open(OFXLASER_SHM_NAME, O_CREAT | O_RDWR, 0600);
+    if(fileDescriptor<0) {
+        ofLogError("SharedFrameReader :: open - shm_open failed : " + string(strerror(errno)));
+        return false;
+    }
+    // in case it was left over from something that made it more open
+    fchmod(fileDescriptor, 0600);
+
+    struct stat fileStats;
+    fstat(fileDescriptor, &fileStats);
+    bool sizeChanged = fileStats.st_size != (off_t)OFXLASER_SHM_SIZE;
+    if(sizeChanged && (ftruncate(fileDescriptor, OFXLASER_SHM_SIZE)!=0)) {
+        ofLogError("SharedFrameReader :: open - couldn't set the segment size : " + string(strerror(errno)));
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+
+    void* memory = mmap(nullptr, OFXLASER_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if(memory==MAP_FAILED) {
+        ofLogError("SharedFrameReader :: open - mmap failed : " + string(strerror(errno)));
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+    header = (ofxlaser_shm_header*)memory;
+
+    // if a writer is already attached to a valid segment then leave it
+    // alone, otherwise set it up from scratch
+    if(sizeChanged || (header->magic!=OFXLASER_SHM_MAGIC) || (header->version!=OFXLASER_SHM_VERSION)) {
+        memset(memory, 0, OFXLASER_SHM_SIZE);
+        header->version = OFXLASER_SHM_VERSION;
+        header->headerSize = sizeof(ofxlaser_shm_header);
+        header->slotSize = sizeof(ofxlaser_shm_slot);
+        header->numSlots = OFXLASER_SHM_NUM_SLOTS;
+        header->maxPoints = OFXLASER_SHM_MAX_POINTS;
+        header->maxPaths = OFXLASER_SHM_MAX_PATHS;
+        for(int i = 0; i<OFXLASER_SHM_NUM_SLOTS; i++) {
+            ofxlaser_shm_slot* slot = ofxlaser_shm_get_slot(header, i);
+            slot->writerBuffer = 0;
+            slot->middle = 1;
+            slot->readerBuffer = 2;
+        }
+        // writers wait for the magic number
+        __atomic_store_n(&header->magic, OFXLASER_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+    ofLogNotice("SharedFrameReader - opened " OFXLASER_SHM_NAME " (" + ofToString(OFXLASER_SHM_SIZE/1024) + " kB)");
+    return true;
+#else
+    ofLogError("SharedFrameReader :: open - shared memory input isn't supported on Windows");
+    return false;
+#endif
+}
+
+void SharedFrameReader :: close() {
+#ifndef _MSC_VER
+    // the segment stays around (until it's unlinked or the computer
+    // restarts) so that writers don't have to reconnect
+    if(header!=nullptr) {
+        munmap(header, OFXLASER_SHM_SIZE);
+        header = nullptr;
+    }
+    if(fileDescriptor>=0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    pendingSlots.clear();
+    pendingWriteTimes.clear();
+    numActiveSlots = 0;
+}
+
+void SharedFrameReader :: update(ShapeTarget& canvasTarget, BeamZoneContainer& beamZones) {
+
+    if(!isOpen()) return;
+#ifndef _MSC_VER
+    uint64_t now = getMonotonicNanos();
+    header->readerHeartbeatNanos = now;
+    lastUpdateTime = now;
+
+    pendingSlots.clear();
+    pendingWriteTimes.clear();
+    numActiveSlots = 0;
+
+    for(int i = 0; i<OFXLASER_SHM_NUM_SLOTS; i++) {
+        ofxlaser_shm_slot* slot = ofxlaser_shm_get_slot(header, i);
+        if(!slot->active) continue;
+        numActiveSlots++;
+
+        int taken = ofxlaser_shm_take(slot);
+        // the slot is writable by the other process, so the index is
+        // copied and checked before it's used
+        uint32_t bufferIndex = slot->readerBuffer;
+        if((taken<0) || (bufferIndex>=OFXLASER_SHM_NUM_BUFFERS)) continue;
+        bool newFrame = taken>0;
+        const ofxlaser_shm_buffer& buffer = slot->buffers[bufferIndex];
+
+        // an old frame is shown until a newer one arrives, unless
+        // the writer has gone quiet
+        uint64_t timeoutNanos = (slot->timeoutMillis>0 ? slot->timeoutMillis : 1000) * 1000000ull;
+        if((buffer.writeTimeNanos==0) || ((now > buffer.writeTimeNanos) && (now - buffer.writeTimeNanos > timeoutNanos))) continue;
+
+        ShapeTarget* target = &canvasTarget;
+        if(slot->target==OFXLASER_SHM_TARGET_BEAM_ZONE) {
+            target = beamZones.getBeamZoneAtIndex(slot->targetIndex);
+            if(target==nullptr) continue;
+        }
+        addShapesForBuffer(buffer, *target);
+
+        if(newFrame) {
+            slot->framesRead++;
+            slot->lastFrameNumberRead = buffer.frameNumber;
+            pendingSlots.push_back(i);
+            pendingWriteTimes.push_back(buffer.writeTimeNanos);
+        }
+    }
+#endif
+}
+
+void SharedFrameReader :: addShapesForBuffer(const ofxlaser_shm_buffer& buffer, ShapeTarget& target) {
+
+    // unsigned so that a huge count can't go negative
+    int numPoints = (int)MIN(buffer.numPoints, (uint32_t)OFXLASER_SHM_MAX_POINTS);
+    if(numPoints==0) return;
+
+    string profile = OFXLASER_PROFILE_DEFAULT;
+    if(buffer.renderProfile==OFXLASER_SHM_PROFILE_DETAIL) profile = OFXLASER_PROFILE_DETAIL;
+    else if(buffer.renderProfile==OFXLASER_SHM_PROFILE_FAST) profile = OFXLASER_PROFILE_FAST;
+
+    if(buffer.frameType==OFXLASER_SHM_FRAME_POINTS) {
+        target.addShape(new SharedPointsShape(buffer.points, numPoints, profile));
+        return;
+    }
+
+    int numPaths = (int)MIN(buffer.numPaths, (uint32_t)OFXLASER_SHM_MAX_PATHS);
+    int start = 0;
+    for(int path = 0; path<numPaths; path++) {
+        int end = (int)MIN(buffer.pathEnds[path], (uint32_t)numPoints);
+        if(end - start >= 2) {
+            polylinePoints.clear();
+            polylineColours.clear();
+            for(int i = start; i<end; i++) {
+                const ofxlaser_shm_point& p = buffer.points[i];
+                polylinePoints.emplace_back(p.x, p.y, 0);
+                polylineColours.emplace_back(p.r, p.g, p.b);
+            }
+            Polyline* polyline = new Polyline(polylinePoints, polylineColours, profile, 1);
+            if(polyline->polylinePointer->getPerimeter()>0.1) {
+                target.addShape(polyline);
+            } else {
+                delete polyline;
+            }
+        }
+        start = MAX(start, end);
+    }
+}
+
+void SharedFrameReader :: frameSent(int dacLatencyMS) {
+
+    if(!isOpen()) return;
+
+    uint64_t now = getMonotonicNanos();
+    for(size_t i = 0; i<pendingSlots.size(); i++) {
+        uint64_t sendNanos = now - pendingWriteTimes[i];
+        uint64_t outputNanos = sendNanos + (uint64_t)dacLatencyMS * 1000000ull;
+        ofxlaser_shm_get_slot(header, pendingSlots[i])->lastLatencyNanos = sendNanos;
+
+        statsFrames++;
+        // the frame can be published just after the update started
+        statsIngestNanos += (lastUpdateTime > pendingWriteTimes[i]) ? lastUpdateTime - pendingWriteTimes[i] : 0;
+        statsSendNanos += sendNanos;
+        statsOutputNanos += outputNanos;
+        statsMaxOutputNanos = MAX(statsMaxOutputNanos, (double)outputNanos);
+    }
+    pendingSlots.clear();
+    pendingWriteTimes.clear();
+
+    if(now - statsStartTime >= 1000000000ull) {
+        float seconds = (now - statsStartTime) / 1e9f;
+        framesPerSecond = (statsStartTime==0) ? 0 : statsFrames / seconds;
+        if(statsFrames>0) {
+            ingestLatencyMS = statsIngestNanos / statsFrames / 1e6;
+            sendLatencyMS = statsSendNanos / statsFrames / 1e6;
+            outputLatencyMS = statsOutputNanos / statsFrames / 1e6;
+            maxOutputLatencyMS = statsMaxOutputNanos / 1e6;
+        }
+        statsStartTime = now;
+        statsFrames = 0;
+        statsIngestNanos = statsSendNanos = statsOutputNanos = statsMaxOutputNanos = 0;
+    }
+}
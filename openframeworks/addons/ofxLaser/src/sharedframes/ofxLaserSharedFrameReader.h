@@ -0,0 +1,87 @@
+//
+//  ofxLaserSharedFrameReader.h
+//  ofxLaser
+//
+// Takes frames from other processes through the shared memory segment
+// described in ofxLaserSharedFrames.h and turns them into shapes in the
+// canvas or beam zones, so they end up in the ZoneContent along with
+// everything that's drawn in the app.
+//
+// Point frames become SharedPointsShapes which read from the segment
+// without copying. Polyline frames have to be resampled using the
+// render profile so they're copied into Polyline shapes.
+//
+// It also measures the latency of each new frame from when it was
+// written until it was sent to the DACs, and adds the DACs' latency to
+// estimate when it comes out of the laser.
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxLaserSharedFrames.h"
+#include "ofxLaserShapeTarget.h"
+#include "ofxLaserBeamZoneContainer.h"
+
+namespace ofxLaser {
+
+class SharedFrameReader {
+    public :
+
+    SharedFrameReader();
+    ~SharedFrameReader();
+
+    // creates the segment if it doesn't exist and maps it
+    bool open();
+    void close();
+    bool isOpen() { return header!=nullptr; };
+
+    // takes the newest frame from each active slot and adds its shapes
+    // to the targets. The shapes from the last call must be deleted
+    // first, ManagerBase::update does this.
+    void update(ShapeTarget& canvasTarget, BeamZoneContainer& beamZones);
+    // call once the frames have been sent to the DACs
+    void frameSent(int dacLatencyMS);
+
+    int getNumActiveSlots() { return numActiveSlots; };
+    // averages over the last second
+    float getFramesPerSecond() { return framesPerSecond; };
+    float getIngestLatencyMS() { return ingestLatencyMS; };
+    float getSendLatencyMS() { return sendLatencyMS; };
+    float getOutputLatencyMS() { return outputLatencyMS; };
+    float getMaxOutputLatencyMS() { return maxOutputLatencyMS; };
+
+    static uint64_t getMonotonicNanos();
+
+    protected :
+
+    void addShapesForBuffer(const ofxlaser_shm_buffer& buffer, ShapeTarget& target);
+
+    ofxlaser_shm_header* header = nullptr;
+    int fileDescriptor = -1;
+
+    // the frames taken in the last update that haven't been sent yet
+    vector<uint64_t> pendingWriteTimes;
+    vector<int> pendingSlots;
+    uint64_t lastUpdateTime = 0;
+    int numActiveSlots = 0;
+
+    // stats for the current second
+    uint64_t statsStartTime = 0;
+    int statsFrames = 0;
+    double statsIngestNanos = 0;
+    double statsSendNanos = 0;
+    double statsOutputNanos = 0;
+    double statsMaxOutputNanos = 0;
+
+    float framesPerSecond = 0;
+    float ingestLatencyMS = 0;
+    float sendLatencyMS = 0;
+    float outputLatencyMS = 0;
+    float maxOutputLatencyMS = 0;
+
+    // to avoid allocating for polylines
+    vector<glm::vec3> polylinePoints;
+    vector<ofColor> polylineColours;
+
+};
+}
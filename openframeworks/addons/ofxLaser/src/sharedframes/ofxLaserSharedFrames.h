@@ -0,0 +1,178 @@
+/*
+ *  ofxLaserSharedFrames.h
+ *  ofxLaser
+ *
+ *  The layout of the shared memory segment that other processes use to
+ *  send frames to ofxLaser. This is plain C (C99 with the GCC / Clang
+ *  atomic builtins) so it can be included in a writer in any language
+ *  that can call C, or copied into one that can't (the structs have no
+ *  padding and their sizes are noted). It's POSIX only (macOS and
+ *  Linux).
+ *
+ *  ofxLaser creates the segment (shm_open with OFXLASER_SHM_NAME) when
+ *  "Shared memory input" is switched on. Writers open it read/write and
+ *  map the whole thing. Only the user that ofxLaser runs as can open
+ *  it, so writers have to run as the same user.
+ *
+ *  ofxLaser doesn't trust anything the writer puts in the segment, buffer
+ *  indexes and counts are range checked and a slot that breaks the
+ *  protocol is ignored.
+ *
+ *  The segment is a header followed by OFXLASER_SHM_NUM_SLOTS slots.
+ *  Each slot sends frames to the canvas (where they go to whichever
+ *  canvas zones they overlap) or to a beam zone. A slot is a lock free
+ *  triple buffer. The writer owns one buffer, ofxLaser owns another and
+ *  the third is passed between them with an atomic exchange of
+ *  slot->middle. Neither side ever waits for the other and ofxLaser
+ *  renders straight out of its buffer with no copy.
+ *
+ *  To write a frame :
+ *    1. set slot->target, slot->targetIndex and slot->active = 1
+ *    2. fill in buffers[slot->writerBuffer] (points, path ends, header)
+ *    3. call ofxlaser_shm_publish(slot)
+ *
+ *  All positions are in canvas pixels for canvas zones, or 0-800 for
+ *  beam zones. Colours are 0-255. Times are CLOCK_MONOTONIC nanoseconds.
+ *  Everything is little endian (native) with the sizes below.
+ */
+
+#ifndef OFXLASER_SHARED_FRAMES_H
+#define OFXLASER_SHARED_FRAMES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OFXLASER_SHM_NAME "/ofxlaser_frames"
+#define OFXLASER_SHM_MAGIC 0x464C584Fu /* "OXLF" */
+#define OFXLASER_SHM_VERSION 1
+
+#define OFXLASER_SHM_NUM_SLOTS 16
+#define OFXLASER_SHM_MAX_POINTS 8192
+#define OFXLASER_SHM_MAX_PATHS 512
+
+/* slot->target */
+#define OFXLASER_SHM_TARGET_CANVAS 0
+#define OFXLASER_SHM_TARGET_BEAM_ZONE 1
+
+/* buffer->frameType */
+/* the points are sent to the laser exactly as they are, the writer
+ * is responsible for the blanking and the scanner speed */
+#define OFXLASER_SHM_FRAME_POINTS 0
+/* each path is a polyline that ofxLaser renders with the render
+ * profile, like ofxLaser::Manager::drawPoly */
+#define OFXLASER_SHM_FRAME_POLYLINES 1
+
+/* buffer->renderProfile */
+#define OFXLASER_SHM_PROFILE_DEFAULT 0
+#define OFXLASER_SHM_PROFILE_DETAIL 1
+#define OFXLASER_SHM_PROFILE_FAST 2
+
+/* the high bit of slot->middle is set when it holds a frame that
+ * ofxLaser hasn't taken yet */
+#define OFXLASER_SHM_NEW_FRAME 0x80000000u
+/* each slot's triple buffer */
+#define OFXLASER_SHM_NUM_BUFFERS 3
+
+/* 12 bytes */
+typedef struct {
+    float x;
+    float y;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t flags;      /* unused, set to 0 */
+} ofxlaser_shm_point;
+
+/* 2080 + 12 * OFXLASER_SHM_MAX_POINTS bytes */
+typedef struct {
+    uint64_t frameNumber;       /* the writer's frame counter */
+    uint64_t writeTimeNanos;    /* when the frame was finished */
+    uint32_t frameType;         /* OFXLASER_SHM_FRAME_... */
+    uint32_t renderProfile;     /* OFXLASER_SHM_PROFILE_..., polylines only */
+    uint32_t numPoints;
+    uint32_t numPaths;          /* polylines only */
+    /* the index after the last point of each path, so path i is
+     * points[i==0 ? 0 : pathEnds[i-1]] up to points[pathEnds[i]-1] */
+    uint32_t pathEnds[OFXLASER_SHM_MAX_PATHS];
+    ofxlaser_shm_point points[OFXLASER_SHM_MAX_POINTS];
+} ofxlaser_shm_buffer;
+
+/* 64 + 3 * sizeof(ofxlaser_shm_buffer) bytes */
+typedef struct {
+    /* set by the writer */
+    uint32_t active;            /* 0 to stop using the slot */
+    uint32_t target;            /* OFXLASER_SHM_TARGET_... */
+    uint32_t targetIndex;       /* beam zone index (0 for the canvas) */
+    uint32_t timeoutMillis;     /* frames older than this aren't shown, 0 for 1000 */
+
+    /* the triple buffer */
+    uint32_t middle;            /* atomic, buffer index | OFXLASER_SHM_NEW_FRAME */
+    uint32_t writerBuffer;      /* only touched by the writer */
+    uint32_t readerBuffer;      /* only touched by ofxLaser */
+    uint32_t reserved0;
+
+    /* set by ofxLaser, for the writer's information */
+    uint64_t framesRead;
+    uint64_t lastFrameNumberRead;
+    /* CLOCK_MONOTONIC nanoseconds from the writeTimeNanos of the last
+     * frame until it was sent to the DACs */
+    uint64_t lastLatencyNanos;
+    uint64_t reserved1;
+
+    ofxlaser_shm_buffer buffers[OFXLASER_SHM_NUM_BUFFERS];
+} ofxlaser_shm_slot;
+
+/* 48 bytes */
+typedef struct {
+    uint32_t magic;             /* OFXLASER_SHM_MAGIC once it's set up */
+    uint32_t version;
+    uint32_t headerSize;        /* sizeof(ofxlaser_shm_header) */
+    uint32_t slotSize;          /* sizeof(ofxlaser_shm_slot) */
+    uint32_t numSlots;
+    uint32_t maxPoints;
+    uint32_t maxPaths;
+    uint32_t reserved0;
+    /* updated by ofxLaser every frame, CLOCK_MONOTONIC nanoseconds */
+    uint64_t readerHeartbeatNanos;
+    uint64_t reserved1;
+} ofxlaser_shm_header;
+
+/* the total size of the segment */
+#define OFXLASER_SHM_SIZE (sizeof(ofxlaser_shm_header) + OFXLASER_SHM_NUM_SLOTS * sizeof(ofxlaser_shm_slot))
+
+#if defined(__GNUC__) || defined(__clang__)
+
+static inline ofxlaser_shm_slot* ofxlaser_shm_get_slot(ofxlaser_shm_header* header, int index) {
+    return (ofxlaser_shm_slot*)((uint8_t*)header + sizeof(ofxlaser_shm_header)) + index;
+}
+
+/* Hands the writer's buffer to ofxLaser and gives the writer a new
+ * one to fill. Returns the new writer buffer. */
+static inline uint32_t ofxlaser_shm_publish(ofxlaser_shm_slot* slot) {
+    uint32_t previous = __atomic_exchange_n(&slot->middle, slot->writerBuffer | OFXLASER_SHM_NEW_FRAME, __ATOMIC_ACQ_REL);
+    slot->writerBuffer = previous & ~OFXLASER_SHM_NEW_FRAME;
+    return slot->writerBuffer;
+}
+
+/* Used by ofxLaser. If there's a new frame, swaps it for the reader's
+ * buffer and returns 1. The reader's buffer is then
+ * slot->buffers[slot->readerBuffer]. Returns -1 if the writer passed
+ * back a buffer index that doesn't exist. */
+static inline int ofxlaser_shm_take(ofxlaser_shm_slot* slot) {
+    if((__atomic_load_n(&slot->middle, __ATOMIC_ACQUIRE) & OFXLASER_SHM_NEW_FRAME) == 0) return 0;
+    uint32_t previous = __atomic_exchange_n(&slot->middle, slot->readerBuffer, __ATOMIC_ACQ_REL) & ~OFXLASER_SHM_NEW_FRAME;
+    if(previous >= OFXLASER_SHM_NUM_BUFFERS) return -1;
+    slot->readerBuffer = previous;
+    return 1;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,185 @@
+//
+//  ofxLaserAsyncLog.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserAsyncLog.h"
+#include "ofxLaserThreadPolicy.h"
+
+using namespace ofxLaser;
+
+AsyncLog * AsyncLog :: instance() {
+    // a function static rather than the usual pointer check because the
+    // first call could come from any of the DAC or MIDI threads
+    static AsyncLog* asyncLog = new AsyncLog();
+    return asyncLog;
+}
+
+AsyncLog :: AsyncLog() {
+    minLevel = OF_LOG_NOTICE;
+    enabledCategories = 0xffffffff;
+    maxMessagesPerSecond = 200;
+    startThread();
+}
+
+AsyncLog :: ~AsyncLog() {
+    if(isThreadRunning()) {
+        stopThread();
+        waitForThread(false);
+    }
+    flush();
+}
+
+AsyncLog::ThreadBufferHolder :: ~ThreadBufferHolder() {
+    if(buffer) buffer->threadEnded = true;
+}
+
+bool AsyncLog :: isEnabled(ofLogLevel level, LogCategory category) {
+    AsyncLog* asyncLog = instance();
+    if((int)level < asyncLog->minLevel.load(std::memory_order_relaxed)) return false;
+    return (asyncLog->enabledCategories.load(std::memory_order_relaxed) & (1u << category)) != 0;
+}
+
+void AsyncLog :: log(ofLogLevel level, LogCategory category, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    logv(level, category, format, args);
+    va_end(args);
+}
+
+void AsyncLog :: logv(ofLogLevel level, LogCategory category, const char* format, va_list args) {
+    if(!isEnabled(level, category)) return;
+
+    ThreadBuffer* buffer = getThreadBuffer();
+    AsyncLogRecord* record = startRecord(buffer);
+    if(record==nullptr) return;
+
+    record->level = level;
+    record->category = category;
+    vsnprintf(record->text, sizeof(record->text), format, args);
+
+    buffer->writeCount.store(buffer->writeCount.load(std::memory_order_relaxed)+1, std::memory_order_release);
+}
+
+void AsyncLog :: log(ofLogLevel level, LogCategory category, const string& message) {
+    log(level, category, "%s", message.c_str());
+}
+
+AsyncLog::ThreadBuffer* AsyncLog :: getThreadBuffer() {
+    static thread_local ThreadBufferHolder holder;
+    if(!holder.buffer) {
+        holder.buffer = std::make_shared<ThreadBuffer>();
+        AsyncLog* asyncLog = instance();
+        std::lock_guard<std::mutex> lock(asyncLog->buffersMutex);
+        asyncLog->buffers.push_back(holder.buffer);
+    }
+    return holder.buffer.get();
+}
+
+AsyncLogRecord* AsyncLog :: startRecord(ThreadBuffer* buffer) {
+
+    uint64_t now = ofGetElapsedTimeMicros();
+
+    int maxMessages = instance()->maxMessagesPerSecond.load(std::memory_order_relaxed);
+    if(maxMessages>0) {
+        if(now - buffer->limitStartMicros >= 1000000) {
+            buffer->limitStartMicros = now;
+            buffer->numInLimitPeriod = 0;
+        }
+        if(++buffer->numInLimitPeriod > maxMessages) {
+            buffer->numDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+
+    uint64_t writeCount = buffer->writeCount.load(std::memory_order_relaxed);
+    if(writeCount - buffer->readCount.load(std::memory_order_acquire) >= ThreadBuffer::size) {
+        buffer->numDropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    AsyncLogRecord* record = &buffer->records[writeCount & (ThreadBuffer::size-1)];
+    record->timeMicros = now;
+    return record;
+}
+
+void AsyncLog :: setLevel(ofLogLevel level) {
+    minLevel = level;
+}
+
+void AsyncLog :: setCategoryEnabled(LogCategory category, bool enabled) {
+    if(enabled) {
+        enabledCategories.fetch_or(1u << category);
+    } else {
+        enabledCategories.fetch_and(~(1u << category));
+    }
+}
+
+void AsyncLog :: setMaxMessagesPerSecond(int maxMessages) {
+    maxMessagesPerSecond = maxMessages;
+}
+
+void AsyncLog :: threadedFunction() {
+
+    // not time critical, so it gets the same background priority as
+    // the DAC discovery threads
+    ThreadPolicy::apply(THREAD_ROLE_DISCOVERY, "Async log");
+
+    while(isThreadRunning()) {
+        flush();
+        sleep(20);
+    }
+}
+
+void AsyncLog :: flush() {
+
+    std::lock_guard<std::mutex> flushLock(flushMutex);
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffersToFlush = buffers;
+    }
+
+    for(std::shared_ptr<ThreadBuffer>& buffer : buffersToFlush) {
+        uint64_t writeCount = buffer->writeCount.load(std::memory_order_acquire);
+        uint64_t readCount = buffer->readCount.load(std::memory_order_relaxed);
+        for(; readCount<writeCount; readCount++) {
+            recordsToFlush.push_back(buffer->records[readCount & (ThreadBuffer::size-1)]);
+        }
+        buffer->readCount.store(readCount, std::memory_order_release);
+
+        int numDropped = buffer->numDropped.exchange(0);
+        if(numDropped>0) {
+            ofLogWarning("AsyncLog - dropped "+ofToString(numDropped)+" messages from a busy thread");
+        }
+    }
+
+    // each thread's records are in order but the threads need merging
+    std::stable_sort(recordsToFlush.begin(), recordsToFlush.end(), [](const AsyncLogRecord& a, const AsyncLogRecord& b) {
+        return a.timeMicros < b.timeMicros;
+    });
+    for(AsyncLogRecord& record : recordsToFlush) {
+        ofLog(record.level) << "[" << getCategoryName(record.category) << "] " << record.text;
+    }
+    recordsToFlush.clear();
+
+    {
+        // forget the buffers of threads that have finished
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            return buffer->threadEnded && (buffer->readCount==buffer->writeCount);
+        }), buffers.end());
+    }
+    buffersToFlush.clear();
+}
+
+string AsyncLog :: getCategoryName(LogCategory category) {
+    switch(category) {
+        case LOG_CATEGORY_DAC :
+            return "DAC";
+        case LOG_CATEGORY_MIDI :
+            return "MIDI";
+        case LOG_CATEGORY_OSC :
+            return "OSC";
+        default :
+            return "ofxLaser";
+    }
+}
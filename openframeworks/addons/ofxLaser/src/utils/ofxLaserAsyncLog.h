@@ -0,0 +1,118 @@
+//
+//  ofxLaserAsyncLog.h
+//  ofxLaser
+//
+// Logging for threads that can't wait for the console, like the DAC
+// threads and the MIDI callbacks.
+//
+// ofLog formats through a stringstream and writes to the console before
+// it returns, which can stall a DAC thread long enough to underrun. Here
+// the message is formatted (printf style) straight into a fixed size
+// record in a buffer that belongs to the calling thread, so logging
+// doesn't allocate, lock or wait. A background thread collects the
+// records from all the buffers every few milliseconds and passes them
+// on to ofLog in time order.
+//
+// Messages can be filtered by level and category at runtime and each
+// thread is limited to a number of messages per second (so a fader sweep
+// can't flood the console). Messages that are filtered out are never
+// formatted. Messages over the limit, or when a thread's buffer is full,
+// are dropped and the number dropped is logged.
+
+#pragma once
+#include "ofMain.h"
+#include <cstdarg>
+
+namespace ofxLaser {
+
+enum LogCategory {
+    LOG_CATEGORY_GENERAL,
+    LOG_CATEGORY_DAC,
+    LOG_CATEGORY_MIDI,
+    LOG_CATEGORY_OSC,
+    LOG_CATEGORY_COUNT
+};
+
+struct AsyncLogRecord {
+    uint64_t timeMicros;
+    ofLogLevel level;
+    LogCategory category;
+    char text[232];
+};
+
+class AsyncLog : public ofThread {
+
+    public :
+
+    // it's a Singleton so shouldn't ever have more than one. Made the
+    // first time anything is logged, from whichever thread that is
+    static AsyncLog * instance();
+
+    ~AsyncLog();
+
+    // whether a message at this level and category would be logged,
+    // check this first if working out the message is expensive
+    static bool isEnabled(ofLogLevel level, LogCategory category);
+
+    // printf style, eg log(OF_LOG_NOTICE, LOG_CATEGORY_DAC, "%d points", n)
+    static void log(ofLogLevel level, LogCategory category, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+    static void log(ofLogLevel level, LogCategory category, const string& message);
+    // for wrapping in other printf style functions
+    static void logv(ofLogLevel level, LogCategory category, const char* format, va_list args);
+
+    // messages below this level are ignored (default OF_LOG_NOTICE)
+    void setLevel(ofLogLevel level);
+    void setCategoryEnabled(LogCategory category, bool enabled);
+    // per thread, 0 for no limit (default 200)
+    void setMaxMessagesPerSecond(int maxMessages);
+
+    // passes on everything that's been logged so far, from any thread
+    void flush();
+
+    static string getCategoryName(LogCategory category);
+
+    protected :
+
+    // one per thread that logs. Only that thread writes to it and only
+    // the flush reads from it
+    struct ThreadBuffer {
+        static const size_t size = 256;
+        AsyncLogRecord records[size];
+        std::atomic<uint64_t> writeCount{0};
+        std::atomic<uint64_t> readCount{0};
+        std::atomic<int> numDropped{0};
+        // set when the thread ends so the buffer can be removed once it's flushed
+        std::atomic<bool> threadEnded{false};
+        // for the rate limit, only used by the logging thread
+        uint64_t limitStartMicros = 0;
+        int numInLimitPeriod = 0;
+    };
+    // marks the thread's buffer as ended when the thread exits
+    struct ThreadBufferHolder {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~ThreadBufferHolder();
+    };
+
+    AsyncLog();
+    void threadedFunction() override;
+
+    static ThreadBuffer* getThreadBuffer();
+    static AsyncLogRecord* startRecord(ThreadBuffer* buffer);
+
+    std::atomic<int> minLevel;
+    std::atomic<uint32_t> enabledCategories;
+    std::atomic<int> maxMessagesPerSecond;
+
+    std::mutex buffersMutex;
+    vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    std::mutex flushMutex;
+    vector<AsyncLogRecord> recordsToFlush;
+    vector<std::shared_ptr<ThreadBuffer>> buffersToFlush;
+
+};
+}
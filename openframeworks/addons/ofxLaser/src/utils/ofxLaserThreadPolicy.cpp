@@ -0,0 +1,196 @@
+//
+//  ofxLaserThreadPolicy.cpp
+//  ofxLaser
+//
+
+#include "ofxLaserThreadPolicy.h"
+
+#ifdef _MSC_VER
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace ofxLaser;
+
+ThreadPolicy * ThreadPolicy :: instance() {
+    // a function static rather than the usual pointer check because every
+    // DAC thread asks for it at the same time when they start
+    static ThreadPolicy* threadPolicy = new ThreadPolicy();
+    return threadPolicy;
+}
+
+ThreadPolicy :: ThreadPolicy() {
+    
+    // defaults are the same as the threads used to set themselves
+    settings[THREAD_ROLE_DAC].scheduler = "fifo";
+    settings[THREAD_ROLE_DAC].priority = 90;
+    settings[THREAD_ROLE_DISCOVERY].scheduler = "rr";
+    settings[THREAD_ROLE_DISCOVERY].priority = 1;
+    settings[THREAD_ROLE_RENDER].scheduler = "normal";
+    settings[THREAD_ROLE_RENDER].priority = 0;
+    
+    // the DAC managers start their threads before the laser manager
+    // loads its settings, so get ours now
+    load();
+    
+}
+
+bool ThreadPolicy :: apply(ThreadRole role, const string& threadName) {
+    return instance()->applyToCurrentThread(role, threadName);
+}
+
+ThreadRoleSettings& ThreadPolicy :: getSettings(ThreadRole role) {
+    return settings[role];
+}
+
+bool ThreadPolicy :: applyToCurrentThread(ThreadRole role, const string& threadName) {
+    
+    ThreadRoleSettings roleSettings;
+    {
+        std::lock_guard<std::mutex> guard(policyMutex);
+        roleSettings = settings[role];
+    }
+    bool success = true;
+    
+#ifndef _MSC_VER
+    // only linux and osx
+    //http://www.yonch.com/tech/82-linux-thread-priority
+    pthread_t thread = pthread_self();
+    
+    int policy = SCHED_OTHER;
+    if(roleSettings.scheduler == "fifo") policy = SCHED_FIFO;
+    else if(roleSettings.scheduler == "rr") policy = SCHED_RR;
+    
+    struct sched_param param;
+    param.sched_priority = 0;
+    if(policy!=SCHED_OTHER) {
+        param.sched_priority = ofClamp(roleSettings.priority, sched_get_priority_min(policy), sched_get_priority_max(policy));
+    }
+    
+    int result = pthread_setschedparam(thread, policy, &param);
+    if((result!=0) && (policy!=SCHED_OTHER)) {
+        // probably not allowed to use real time scheduling,
+        // so fall back to the normal scheduler
+        std::lock_guard<std::mutex> guard(policyMutex);
+        if(!realtimeWarningShown) {
+            ofLogWarning("ofxLaser::ThreadPolicy") << "couldn't set " << roleSettings.scheduler << " scheduling for " << getRoleName(role) << " threads (" << strerror(result) << "), using normal scheduling. On Linux you need CAP_SYS_NICE or an rtprio limit.";
+            realtimeWarningShown = true;
+        }
+        param.sched_priority = 0;
+        pthread_setschedparam(thread, SCHED_OTHER, &param);
+        success = false;
+    }
+    
+#ifdef TARGET_LINUX
+    if(!roleSettings.cpus.empty()) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for(int cpu : roleSettings.cpus) {
+            if((cpu>=0) && (cpu<CPU_SETSIZE)) CPU_SET(cpu, &cpuset);
+        }
+        result = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+        if(result!=0) {
+            ofLogWarning("ofxLaser::ThreadPolicy") << "couldn't set CPU affinity for " << getRoleName(role) << " thread " << threadName << " (" << strerror(result) << ")";
+            success = false;
+        }
+    }
+    if(!threadName.empty()) {
+        // linux thread names are limited to 15 characters
+        pthread_setname_np(thread, threadName.substr(0, 15).c_str());
+    }
+#endif
+    
+#else
+    // windows implementation
+    HANDLE thread = GetCurrentThread();
+    int priority = THREAD_PRIORITY_NORMAL;
+    if(roleSettings.scheduler != "normal") {
+        priority = (roleSettings.priority > 1) ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_LOWEST;
+    } else if(roleSettings.priority > 0) {
+        priority = THREAD_PRIORITY_ABOVE_NORMAL;
+    } else if(roleSettings.priority < 0) {
+        priority = THREAD_PRIORITY_BELOW_NORMAL;
+    }
+    success = SetThreadPriority(thread, priority);
+    
+    if(!roleSettings.cpus.empty()) {
+        DWORD_PTR mask = 0;
+        for(int cpu : roleSettings.cpus) {
+            if((cpu>=0) && (cpu<(int)sizeof(DWORD_PTR)*8)) mask |= ((DWORD_PTR)1 << cpu);
+        }
+        if(SetThreadAffinityMask(thread, mask) == 0) {
+            ofLogWarning("ofxLaser::ThreadPolicy") << "couldn't set CPU affinity for " << getRoleName(role) << " thread " << threadName;
+            success = false;
+        }
+    }
+#endif
+    
+    return success;
+    
+}
+
+string ThreadPolicy :: getRoleName(ThreadRole role) {
+    switch(role) {
+        case THREAD_ROLE_DAC : return "dac";
+        case THREAD_ROLE_DISCOVERY : return "discovery";
+        case THREAD_ROLE_RENDER : return "render";
+        default : return "";
+    }
+}
+
+bool ThreadPolicy :: load() {
+    
+    string filename ="ofxLaser/laserSettings.json";
+    if(!ofFile(filename).exists()) return false;
+    
+    ofJson json = ofLoadJson(filename);
+    if(!json.contains("threadPolicy")) return false;
+    
+    return deserialize(json["threadPolicy"]);
+}
+
+void ThreadPolicy :: serialize(ofJson& json) {
+    std::lock_guard<std::mutex> guard(policyMutex);
+    for(int i = 0; i<THREAD_ROLE_COUNT; i++) {
+        settings[i].serialize(json[getRoleName((ThreadRole)i)]);
+    }
+}
+
+bool ThreadPolicy :: deserialize(ofJson& json) {
+    std::lock_guard<std::mutex> guard(policyMutex);
+    bool success = true;
+    for(int i = 0; i<THREAD_ROLE_COUNT; i++) {
+        string name = getRoleName((ThreadRole)i);
+        if(json.contains(name)) {
+            success &= settings[i].deserialize(json[name]);
+        }
+    }
+    return success;
+}
+
+void ThreadRoleSettings :: serialize(ofJson& json) const {
+    json["scheduler"] = scheduler;
+    json["priority"] = priority;
+    json["cpus"] = cpus;
+}
+
+bool ThreadRoleSettings :: deserialize(ofJson& json) {
+    try {
+        if(json.contains("scheduler")) {
+            string value = json["scheduler"];
+            if((value == "fifo") || (value == "rr") || (value == "normal")) {
+                scheduler = value;
+            } else {
+                ofLogError("ofxLaser::ThreadPolicy") << "unknown scheduler " << value << ", should be fifo, rr or normal";
+            }
+        }
+        if(json.contains("priority")) priority = json["priority"].get<int>();
+        if(json.contains("cpus")) cpus = json["cpus"].get<vector<int>>();
+    } catch (std::exception& e) {
+        ofLogError("ofxLaser::ThreadPolicy") << "couldn't read thread settings : " << e.what();
+        return false;
+    }
+    return true;
+}
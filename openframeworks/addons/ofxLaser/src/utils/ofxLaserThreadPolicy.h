@@ -0,0 +1,82 @@
+//
+//  ofxLaserThreadPolicy.h
+//  ofxLaser
+//
+// One place to set the scheduling for all the ofxLaser threads.
+//
+// Each thread type (DAC output, DAC discovery and render workers) has
+// a scheduler (fifo, rr or normal), a priority and an optional set of
+// CPUs to run on. Threads call apply() at the start of their
+// threadedFunction.
+//
+// If the OS won't let us use a real time scheduler (on Linux you need
+// CAP_SYS_NICE or an rtprio limit) we fall back to the normal scheduler
+// and log it once.
+//
+// The settings are stored in laserSettings.json in "threadPolicy" :
+//
+//  "threadPolicy": {
+//      "dac": { "scheduler": "fifo", "priority": 90, "cpus": [2, 3] },
+//      "discovery": { "scheduler": "rr", "priority": 1, "cpus": [] },
+//      "render": { "scheduler": "normal", "priority": 0, "cpus": [] }
+//  }
+//
+// CPU affinity is only supported on Linux and Windows.
+
+#pragma once
+#include "ofMain.h"
+
+namespace ofxLaser {
+
+enum ThreadRole {
+    THREAD_ROLE_DAC,
+    THREAD_ROLE_DISCOVERY,
+    THREAD_ROLE_RENDER,
+    THREAD_ROLE_COUNT
+};
+
+struct ThreadRoleSettings {
+    // "fifo", "rr" or "normal"
+    string scheduler = "normal";
+    // 1-99 for fifo and rr. For normal, above 0 is high priority on
+    // Windows and below 0 is low priority
+    int priority = 0;
+    // empty means any CPU
+    vector<int> cpus;
+    
+    void serialize(ofJson& json) const;
+    bool deserialize(ofJson& json);
+};
+
+class ThreadPolicy {
+    
+    public :
+    
+    // it's a Singleton so shouldn't ever have more than one.
+    static ThreadPolicy * instance();
+    
+    // applies the policy to the thread that calls it
+    static bool apply(ThreadRole role, const string& threadName = "");
+    
+    ThreadRoleSettings& getSettings(ThreadRole role);
+    
+    // loads from the threadPolicy object in laserSettings.json
+    bool load();
+    void serialize(ofJson& json);
+    bool deserialize(ofJson& json);
+    
+    protected :
+    
+    // use instance()
+    ThreadPolicy();
+    
+    bool applyToCurrentThread(ThreadRole role, const string& threadName);
+    static string getRoleName(ThreadRole role);
+    
+    ThreadRoleSettings settings[THREAD_ROLE_COUNT];
+    
+    std::mutex policyMutex;
+    bool realtimeWarningShown = false;
+    
+};
+}
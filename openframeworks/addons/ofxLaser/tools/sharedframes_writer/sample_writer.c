@@ -0,0 +1,176 @@
+/*
+ *  sample_writer.c
+ *  ofxLaser
+ *
+ *  Sends frames to ofxLaser through shared memory. Draws a spinning
+ *  square and a circle at 60fps and prints the latency that ofxLaser
+ *  reports back once a second.
+ *
+ *  cc -O2 -o sample_writer sample_writer.c -I../../src/sharedframes -lm -lrt
+ *  (leave off -lrt on macOS)
+ *
+ *  ./sample_writer [slot] [-p] [-b beamzone]
+ *    slot         which slot to write to (default 0)
+ *    -p           send raw points instead of polylines
+ *    -b beamzone  send to a beam zone instead of the canvas
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "ofxLaserSharedFrames.h"
+
+static uint64_t monotonic_nanos(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+static void add_point(ofxlaser_shm_buffer* buffer, float x, float y, uint8_t r, uint8_t g, uint8_t b) {
+    if(buffer->numPoints >= OFXLASER_SHM_MAX_POINTS) return;
+    ofxlaser_shm_point* p = &buffer->points[buffer->numPoints++];
+    p->x = x;
+    p->y = y;
+    p->r = r;
+    p->g = g;
+    p->b = b;
+    p->flags = 0;
+}
+
+static void end_path(ofxlaser_shm_buffer* buffer) {
+    if(buffer->numPaths >= OFXLASER_SHM_MAX_PATHS) return;
+    buffer->pathEnds[buffer->numPaths++] = buffer->numPoints;
+}
+
+/* polylines, ofxLaser works out the laser path */
+static void draw_polylines(ofxlaser_shm_buffer* buffer, float t) {
+    int i;
+    for(i = 0; i <= 4; i++) {
+        float angle = t + i * (float)M_PI / 2;
+        add_point(buffer, 400 + cosf(angle) * 200, 400 + sinf(angle) * 200, 0, 255, 0);
+    }
+    end_path(buffer);
+    for(i = 0; i <= 64; i++) {
+        float angle = i * 2 * (float)M_PI / 64;
+        add_point(buffer, 400 + cosf(angle) * 100, 400 + sinf(angle) * 100, 255, 0, i * 4);
+    }
+    end_path(buffer);
+}
+
+/* raw points, we're responsible for the blanking and the speed */
+static void draw_points(ofxlaser_shm_buffer* buffer, float t) {
+    int i, j;
+    for(i = 0; i < 4; i++) {
+        float a1 = t + i * (float)M_PI / 2;
+        float a2 = a1 + (float)M_PI / 2;
+        float x1 = 400 + cosf(a1) * 200, y1 = 400 + sinf(a1) * 200;
+        float x2 = 400 + cosf(a2) * 200, y2 = 400 + sinf(a2) * 200;
+        /* dwell on the corner then move along the edge */
+        for(j = 0; j < 4; j++) add_point(buffer, x1, y1, 0, 255, 0);
+        for(j = 1; j <= 40; j++) {
+            float u = j / 40.0f;
+            add_point(buffer, x1 + (x2 - x1) * u, y1 + (y2 - y1) * u, 0, 255, 0);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+
+    int slotIndex = 0;
+    int usePoints = 0;
+    int beamZone = -1;
+    int i;
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-p") == 0) usePoints = 1;
+        else if((strcmp(argv[i], "-b") == 0) && (i + 1 < argc)) beamZone = atoi(argv[++i]);
+        else slotIndex = atoi(argv[i]);
+    }
+    if(slotIndex < 0 || slotIndex >= OFXLASER_SHM_NUM_SLOTS) {
+        fprintf(stderr, "slot should be 0 to %d\n", OFXLASER_SHM_NUM_SLOTS - 1);
+        return 1;
+    }
+
+    /* ofxLaser creates the segment when "Shared memory input" is on */
+    int fd;
+    printf("waiting for ofxLaser...\n");
+    while((fd = shm_open(OFXLASER_SHM_NAME, O_RDWR, 0)) < 0) sleep(1);
+
+    ofxlaser_shm_header* header = NULL;
+    while(header == NULL) {
+        /* wait for it to be the right size */
+        if(lseek(fd, 0, SEEK_END) >= (off_t)OFXLASER_SHM_SIZE) {
+            void* memory = mmap(NULL, OFXLASER_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if(memory == MAP_FAILED) {
+                perror("mmap");
+                return 1;
+            }
+            header = (ofxlaser_shm_header*)memory;
+        } else {
+            sleep(1);
+        }
+    }
+    while(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != OFXLASER_SHM_MAGIC) usleep(10000);
+    if(header->version != OFXLASER_SHM_VERSION || header->slotSize != sizeof(ofxlaser_shm_slot)) {
+        fprintf(stderr, "ofxLaser is using a different version of the shared memory layout\n");
+        return 1;
+    }
+
+    ofxlaser_shm_slot* slot = ofxlaser_shm_get_slot(header, slotIndex);
+    slot->target = (beamZone >= 0) ? OFXLASER_SHM_TARGET_BEAM_ZONE : OFXLASER_SHM_TARGET_CANVAS;
+    slot->targetIndex = (beamZone >= 0) ? beamZone : 0;
+    slot->timeoutMillis = 500;
+    slot->active = 1;
+    printf("writing %s to slot %d\n", usePoints ? "points" : "polylines", slotIndex);
+
+    const uint64_t frameNanos = 1000000000ull / 60;
+    uint64_t nextFrameTime = monotonic_nanos();
+    uint64_t nextPrintTime = nextFrameTime + 1000000000ull;
+    uint64_t frameNumber = 0;
+    uint64_t lastFramesRead = slot->framesRead;
+
+    while(1) {
+        ofxlaser_shm_buffer* buffer = &slot->buffers[slot->writerBuffer];
+        buffer->numPoints = 0;
+        buffer->numPaths = 0;
+        buffer->frameType = usePoints ? OFXLASER_SHM_FRAME_POINTS : OFXLASER_SHM_FRAME_POLYLINES;
+        buffer->renderProfile = OFXLASER_SHM_PROFILE_DEFAULT;
+        buffer->frameNumber = ++frameNumber;
+
+        float t = frameNumber / 60.0f;
+        if(usePoints) draw_points(buffer, t);
+        else draw_polylines(buffer, t);
+
+        buffer->writeTimeNanos = monotonic_nanos();
+        ofxlaser_shm_publish(slot);
+
+        uint64_t now = monotonic_nanos();
+        if(now >= nextPrintTime) {
+            int heartbeatAge = (int)((now - header->readerHeartbeatNanos) / 1000000);
+            printf("frame %llu  ofxLaser read %llu/s  write to DAC %.2f ms%s\n",
+                   (unsigned long long)frameNumber,
+                   (unsigned long long)(slot->framesRead - lastFramesRead),
+                   slot->lastLatencyNanos / 1e6,
+                   heartbeatAge > 1000 ? "  (ofxLaser isn't running)" : "");
+            lastFramesRead = slot->framesRead;
+            nextPrintTime += 1000000000ull;
+        }
+
+        nextFrameTime += frameNanos;
+        struct timespec sleepUntil;
+        sleepUntil.tv_sec = nextFrameTime / 1000000000ull;
+        sleepUntil.tv_nsec = nextFrameTime % 1000000000ull;
+#ifdef __APPLE__
+        now = monotonic_nanos();
+        if(nextFrameTime > now) usleep((nextFrameTime - now) / 1000);
+#else
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sleepUntil, NULL);
+#endif
+    }
+    return 0;
+}
@@ -1,4 +1,85 @@
 #pragma once
 #include "ofMain.h"
-#include <atomic>
-struct AppState { enum class Shape { Circle, Line, Triangle, Square, StaticWave }; enum class ColorSel { Blue, Red, Green }; enum class Movement { None, Circle, Pan, Tilt, Eight, Random }; enum class BeamFx { None, Prisma }; std::atomic<Shape> currentShape{Shape::Circle}; std::atomic<ColorSel> currentColor{ColorSel::Blue}; std::atomic<Movement> movement{Movement::None}; std::atomic<bool> useCustomColor{false}; std::atomic<float> customR{0.0f}, customG{0.20f}, customB{1.0f}; std::atomic<float> waveFrequency{1.0f}, waveAmplitude{0.45f}, waveSpeed{0.0f}; std::atomic<float> rainbowSpeed{0.0f}, rainbowAmount{0.0f}, rainbowBlend{1.0f}; std::atomic<float> moveSpeed{0.30f}, moveSize{0.50f}; std::atomic<float> rotationSpeed{0.0f}, rotationSpeedTarget{0.0f}; std::atomic<bool> motionHold{false}; std::atomic<float> heldRotationSpeed{0.0f}, heldMoveSpeed{0.0f}, heldWaveSpeed{0.0f}; std::atomic<float> shapeScale{0.0f}, shapeScaleTarget{0.0f}; std::atomic<float> posNormX{0.0f}, posNormY{0.0f}, posTargetX{0.0f}, posTargetY{0.0f}; std::atomic<bool> invertX{false}, holdInvertX{false}, holdWhiteFlash{false}, blackout{false}; std::atomic<BeamFx> beamFx{BeamFx::None}; std::atomic<float> masterBrightness{1.0f}; std::atomic<float> dotAmount{1.0f}, dotAmountTarget{1.0f}; std::atomic<float> scanRateHz{0.0f}; ofColor toOfColor(float rainbowHue01 = -1.0f) const { if (useCustomColor.load()) { float r = ofClamp(customR.load(),0,1), g = ofClamp(customG.load(),0,1), b = ofClamp(customB.load(),0,1); ofColor base((unsigned char)(r*255),(unsigned char)(g*255),(unsigned char)(b*255)); if(rainbowHue01>=0){ float amt = ofClamp(rainbowAmount.load(),0,1); if(amt>0){ ofColor rb; rb.setHsb((unsigned char)ofClamp(rainbowHue01*255,0,255),255,255); base = base.lerp(rb, amt);} } return base; } else { ofColor base; switch(currentColor.load()){ case ColorSel::Red: base = ofColor(255,0,20); break; case ColorSel::Green: base = ofColor(0,220,80); break; default: base = ofColor(0,50,255); break; } if(rainbowHue01>=0){ float amt = ofClamp(rainbowAmount.load(),0,1); if(amt>0){ ofColor rb; rb.setHsb((unsigned char)ofClamp(rainbowHue01*255,0,255),255,255); base = base.lerp(rb, amt);} } return base; } } };
+
+// All the show parameters in one flat struct, so a frame can take a single
+// consistent copy (see ParameterStore). The fields are listed once in
+// APP_STATE_PARAMS as (type, name, default, cue JSON key); fields with a key
+// are part of a cue, and the cue copy and JSON code are generated from it.
+#define APP_STATE_PARAMS(X) \
+	X(Shape, currentShape, Shape::Circle, "shape") \
+	X(ColorSel, currentColor, ColorSel::Blue, "colorSel") \
+	X(Movement, movement, Movement::None, "movement") \
+	X(BeamFx, beamFx, BeamFx::None, "beamFx") \
+	X(bool, useCustomColor, false, "useCustom") \
+	X(float, customR, 0.0f, "r") \
+	X(float, customG, 0.20f, "g") \
+	X(float, customB, 1.0f, "b") \
+	X(float, waveFrequency, 1.0f, "waveFrequency") \
+	X(float, waveAmplitude, 0.45f, "waveAmplitude") \
+	X(float, waveSpeed, 0.0f, "waveSpeed") \
+	X(float, rainbowSpeed, 0.0f, "rainbowSpeed") \
+	X(float, rainbowAmount, 0.0f, "rainbowAmount") \
+	X(float, rainbowBlend, 1.0f, "rainbowBlend") \
+	X(float, moveSpeed, 0.30f, "moveSpeed") \
+	X(float, moveSize, 0.50f, "moveSize") \
+	X(float, rotationSpeed, 0.0f, "rotationSpeed") \
+	X(float, rotationSpeedTarget, 0.0f, "") \
+	X(bool, motionHold, false, "") \
+	X(float, heldRotationSpeed, 0.0f, "") \
+	X(float, heldMoveSpeed, 0.0f, "") \
+	X(float, heldWaveSpeed, 0.0f, "") \
+	X(float, shapeScale, 0.0f, "shapeScale") \
+	X(float, shapeScaleTarget, 0.0f, "") \
+	X(float, posNormX, 0.0f, "posX") \
+	X(float, posNormY, 0.0f, "posY") \
+	X(float, posTargetX, 0.0f, "") \
+	X(float, posTargetY, 0.0f, "") \
+	X(bool, invertX, false, "") \
+	X(bool, holdInvertX, false, "") \
+	X(bool, holdWhiteFlash, false, "") \
+	X(bool, blackout, false, "") \
+	X(float, masterBrightness, 1.0f, "") \
+	X(float, dotAmount, 1.0f, "dotAmount") \
+	X(float, dotAmountTarget, 1.0f, "") \
+	X(float, scanRateHz, 0.0f, "scanRateHz")
+
+struct alignas(64) AppState {
+	enum class Shape { Circle, Line, Triangle, Square, StaticWave }; enum class ColorSel { Blue, Red, Green }; enum class Movement { None, Circle, Pan, Tilt, Eight, Random }; enum class BeamFx { None, Prisma };
+
+#define APP_STATE_FIELD(type, name, value, cueKey) type name = value;
+	APP_STATE_PARAMS(APP_STATE_FIELD)
+#undef APP_STATE_FIELD
+
+	// copies just the fields that are part of a cue
+	void copyCueFields(const AppState& other){
+#define APP_STATE_COPY(type, name, value, cueKey) if(cueKey[0] != 0) name = other.name;
+		APP_STATE_PARAMS(APP_STATE_COPY)
+#undef APP_STATE_COPY
+	}
+	void cueToJson(ofJson& j) const {
+#define APP_STATE_TO_JSON(type, name, value, cueKey) if(cueKey[0] != 0) j[cueKey] = toJson(name);
+		APP_STATE_PARAMS(APP_STATE_TO_JSON)
+#undef APP_STATE_TO_JSON
+	}
+	// missing keys get the default value
+	void cueFromJson(const ofJson& j){
+#define APP_STATE_FROM_JSON(type, name, value, cueKey) if(cueKey[0] != 0) { name = value; if(j.contains(cueKey)) fromJson(j[cueKey], name); }
+		APP_STATE_PARAMS(APP_STATE_FROM_JSON)
+#undef APP_STATE_FROM_JSON
+	}
+
+	static ofJson toJson(float v){ return v; } static ofJson toJson(bool v){ return v; }
+	static void fromJson(const ofJson& j, float& v){ if(j.is_number()) v = j.get<float>(); }
+	static void fromJson(const ofJson& j, bool& v){ if(j.is_boolean()) v = j.get<bool>(); }
+	// enums are stored by name
+	static ofJson toJson(Shape s){ switch(s){ case Shape::Line: return "line"; case Shape::Triangle: return "triangle"; case Shape::Square: return "square"; case Shape::StaticWave: return "staticwave"; default: return "circle"; } }
+	static void fromJson(const ofJson& j, Shape& s){ std::string t = ofToLower(j.is_string() ? j.get<std::string>() : ""); if(t=="line") s = Shape::Line; else if(t=="triangle") s = Shape::Triangle; else if(t=="square") s = Shape::Square; else if(t=="staticwave" || t=="wave") s = Shape::StaticWave; else s = Shape::Circle; }
+	static ofJson toJson(ColorSel c){ switch(c){ case ColorSel::Red: return "red"; case ColorSel::Green: return "green"; default: return "blue"; } }
+	static void fromJson(const ofJson& j, ColorSel& c){ std::string t = ofToLower(j.is_string() ? j.get<std::string>() : ""); if(t=="red") c = ColorSel::Red; else if(t=="green") c = ColorSel::Green; else c = ColorSel::Blue; }
+	static ofJson toJson(Movement m){ switch(m){ case Movement::Circle: return "circle"; case Movement::Pan: return "pan"; case Movement::Tilt: return "tilt"; case Movement::Eight: return "eight"; case Movement::Random: return "random"; default: return "none"; } }
+	static void fromJson(const ofJson& j, Movement& m){ std::string t = ofToLower(j.is_string() ? j.get<std::string>() : ""); if(t=="circle") m = Movement::Circle; else if(t=="pan") m = Movement::Pan; else if(t=="tilt") m = Movement::Tilt; else if(t=="eight" || t=="figure8" || t=="8") m = Movement::Eight; else if(t=="random") m = Movement::Random; else m = Movement::None; }
+	static ofJson toJson(BeamFx b){ return (b == BeamFx::Prisma) ? "prisma" : "none"; }
+	static void fromJson(const ofJson& j, BeamFx& b){ std::string t = ofToLower(j.is_string() ? j.get<std::string>() : ""); b = (t=="prisma") ? BeamFx::Prisma : BeamFx::None; }
+
+	ofColor toOfColor(float rainbowHue01 = -1.0f) const { ofColor base; if (useCustomColor) { float r = ofClamp(customR,0,1), g = ofClamp(customG,0,1), b = ofClamp(customB,0,1); base = ofColor((unsigned char)(r*255),(unsigned char)(g*255),(unsigned char)(b*255)); } else { switch(currentColor){ case ColorSel::Red: base = ofColor(255,0,20); break; case ColorSel::Green: base = ofColor(0,220,80); break; default: base = ofColor(0,50,255); break; } } if(rainbowHue01>=0){ float amt = ofClamp(rainbowAmount,0,1); if(amt>0){ ofColor rb; rb.setHsb((unsigned char)ofClamp(rainbowHue01*255,0,255),255,255); base = base.lerp(rb, amt);} } return base; }
+};
@@ -0,0 +1,78 @@
+// Lock-free queue of control changes from the MIDI threads to the app.
+// Each opened MIDI port calls back on its own thread so any number of threads
+// can push, but only one thread should pop (the one running the show, once
+// per frame, which is the render thread if it's on). Events are fixed size
+// so pushing never allocates; when the queue is full the event is dropped
+// and counted.
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <cstring>
+
+struct ControlEvent {
+	char address[96];       // OSC address the value is for, eg /laser/brightness
+	float value = 0.0f;
+	uint64_t timeMicros = 0; // ofGetElapsedTimeMicros() when it was pushed
+};
+
+class ControlBus {
+public:
+	static const size_t capacity = 1024; // must be a power of 2
+
+	ControlBus(){
+		for(size_t i = 0; i < capacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// returns false if the queue is full or the address is too long
+	bool push(const std::string& address, float value){
+		if(address.size() >= sizeof(ControlEvent::address)) {
+			numDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		// bounded MPMC queue (Dmitry Vyukov's), each slot's sequence number
+		// says whether it's free for the producer at this position
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		Slot* slot;
+		while(true){
+			slot = &slots[pos & (capacity - 1)];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+			if(diff == 0){
+				if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if(diff < 0){
+				numDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			} else {
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		memcpy(slot->event.address, address.c_str(), address.size() + 1);
+		slot->event.value = value;
+		slot->event.timeMicros = ofGetElapsedTimeMicros();
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer thread only, returns false when there's nothing left
+	bool pop(ControlEvent& event){
+		Slot& slot = slots[dequeuePos & (capacity - 1)];
+		if(slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) return false;
+		event = slot.event;
+		slot.sequence.store(dequeuePos + capacity, std::memory_order_release);
+		dequeuePos++;
+		return true;
+	}
+
+	int getNumDropped() const { return numDropped.load(std::memory_order_relaxed); }
+
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		ControlEvent event;
+	};
+	Slot slots[capacity];
+	alignas(64) std::atomic<size_t> enqueuePos{0};
+	alignas(64) size_t dequeuePos = 0;
+	std::atomic<int> numDropped{0};
+};
@@ -0,0 +1,547 @@
+// Effect graph for the show output.
+//
+// The graph is a list of layers. Each layer is a chain of nodes that starts
+// with a generator and ends with an output:
+//   generators  shape (whichever shape the show has selected), circle, line, triangle, square, wave
+//   geometry    transform (show scale, rotation and position), movement (the movement LFO), mirror
+//   colour      color (the show colour), rainbow (spatial rainbow, resamples the path first)
+//   instancers  prism (copies around a circle, when the prism beam fx is on)
+//   output      output (solid, multicoloured or dots depending on the colour and dot amount)
+// and is described in JSON, eg
+//   {"layers":[{"nodes":[{"type":"shape"},{"type":"transform"},{"type":"color"},{"type":"output"}]}]}
+//
+// Every frame compile() looks at the frame's parameters and turns the graph
+// into a flat list of kernel steps. Choices like which shape or which output
+// are made once there, nodes that do nothing this frame are left out and
+// transforms next to each other are folded into one matrix. When the output
+// is a single colour, prism copies are drawn as instances of one shape
+// (ManagerBase::drawPolyInstances) and later transforms change the instance
+// matrices rather than the points. run() then executes the steps over point
+// buffers that belong to each layer and are reused from frame to frame.
+//
+// A transform with "subframe" set (it's off by default) also turns each point
+// on by how far the rotation goes while the frame is being drawn, taking the
+// path to be drawn over the whole frame. Fast rotations then move smoothly
+// from the end of one frame to the start of the next instead of jumping once
+// per frame. The path is resampled every "spacing" pixels first so straight
+// edges curve, and swept paths can't be drawn backwards. It's left out when
+// the layer has prism copies, as they share the frame.
+#pragma once
+
+#include "ofMain.h"
+#include "ofxLaserManagerBase.h"
+#include "AppState.h"
+
+// what the graph needs from the app for one frame
+struct EffectFrame {
+	const AppState* state = nullptr;
+	float width = 800, height = 800;
+	float scale = 1.0f;          // shape scale factor
+	glm::vec2 position{0, 0};    // manual position offset in pixels
+	float rotationRad = 0, wavePhaseRad = 0, movePhaseRad = 0, rainbowPhaseRad = 0;
+	float rotationSweepRad = 0;  // how far the rotation goes while the frame is drawn
+	double moveTimeCycles = 0; float randomSeedX = 0, randomSeedY = 0;
+	bool mirror = false, whiteFlash = false;
+	ofColor color;               // show colour with the master brightness applied
+	float brightness = 1.0f;     // master brightness, for the rainbow colours
+};
+
+class EffectGraph {
+public:
+	EffectGraph(){ setup(getDefaultDescription()); }
+
+	// the same output as the app had before the graph
+	static ofJson getDefaultDescription(){
+		return ofJson::parse(R"({"layers":[{"nodes":[
+			{"type":"shape"}, {"type":"transform"}, {"type":"movement"}, {"type":"prism", "copies":5, "spread":1.73},
+			{"type":"mirror"}, {"type":"color"}, {"type":"rainbow", "spacing":6}, {"type":"output", "minSize":12, "profile":"FAST"}
+		]}]})");
+	}
+
+	// replaces the graph, if the description is no good it logs why and keeps the old one
+	bool setup(const ofJson& description){
+		std::vector<Layer> newLayers;
+		try{
+			if(!description.contains("layers") || !description["layers"].is_array()) return setupError("no 'layers' array");
+			for(const auto& l : description["layers"]){
+				Layer layer;
+				if(!l.contains("nodes") || !l["nodes"].is_array()) return setupError("layer without a 'nodes' array");
+				for(const auto& n : l["nodes"]){
+					Node node;
+					if(!parseNode(n, node)) return setupError("unknown node type " + n.value("type", std::string("")));
+					layer.nodes.push_back(node);
+				}
+				if(layer.nodes.empty() || !isGenerator(layer.nodes.front().type)) return setupError("a layer has to start with a generator");
+				if(layer.nodes.back().type != NodeType::Output) return setupError("a layer has to end with an output");
+				for(size_t i = 1; i + 1 < layer.nodes.size(); i++){
+					if(isGenerator(layer.nodes[i].type) || layer.nodes[i].type == NodeType::Output) return setupError("generators and outputs can only be at the ends of a layer");
+				}
+				newLayers.push_back(std::move(layer));
+			}
+		}catch(const std::exception& e){
+			return setupError(e.what());
+		}
+		layers = std::move(newLayers);
+		steps.clear();
+		return true;
+	}
+	// missing file keeps the current graph
+	bool load(const std::string& fileName){
+		const std::string path = ofToDataPath(fileName, true);
+		if(!ofFile::doesFileExist(path)){
+			ofLogNotice() << "No effect graph file found (" << path << "), using the default graph";
+			return false;
+		}
+		ofJson description;
+		try{ description = ofLoadJson(path); }catch(...){ return setupError("can't parse " + path); }
+		if(!setup(description)) return false;
+		ofLogNotice() << "Effect graph with " << layers.size() << " layers loaded from " << path;
+		return true;
+	}
+
+	// turns the graph into this frame's steps, app thread only
+	void compile(const EffectFrame& f){
+		frame = f;
+		steps.clear();
+		const AppState& s = *frame.state;
+		const float W = frame.width, H = frame.height, minDim = std::min(W, H);
+		for(Layer& layer : layers){
+			const size_t first = steps.size();
+			float size = 0, extent = 0, scale = 1; // nominal size and radius of the shape, and the scale applied to it so far
+			bool varyingColor = false;
+			// copies can only share their points if they all end up one colour
+			bool solidOutput = !isDotted(s);
+			// the sub-frame sweep takes one path drawn over the whole frame
+			bool copied = false;
+			for(const Node& node : layer.nodes){
+				if(node.type == NodeType::Color) solidOutput = !isDotted(s);
+				else if(node.type == NodeType::Rainbow && isRainbowOn(s)) solidOutput = false;
+				else if(node.type == NodeType::Prism && s.beamFx == AppState::BeamFx::Prisma) copied = true;
+			}
+			bool instanced = false;
+			for(Node& node : layer.nodes){
+				Step step; step.layer = &layer; step.node = &node;
+				NodeType type = node.type;
+				if(type == NodeType::Shape){
+					switch(s.currentShape){
+						case AppState::Shape::Line: type = NodeType::Line; break;
+						case AppState::Shape::Triangle: type = NodeType::Triangle; break;
+						case AppState::Shape::Square: type = NodeType::Square; break;
+						case AppState::Shape::StaticWave: type = NodeType::Wave; break;
+						default: type = NodeType::Circle; break;
+					}
+				}
+				switch(type){
+					case NodeType::Circle: {
+						const float r = minDim * 0.5f - 10.0f;
+						step.kernel = Kernel::Circle; step.a = W * 0.5f; step.b = H * 0.5f; step.c = r;
+						// enough points for the size it will be drawn at
+						step.n = std::max(64, (int)roundf(TWO_PI * r * fabsf(frame.scale) / 4.0f));
+						size = r * 2.0f; extent = r;
+						break;
+					}
+					case NodeType::Line: case NodeType::Triangle: case NodeType::Square:
+						step.kernel = Kernel::Polygon; step.n = (int)type;
+						size = W - 20.0f; extent = minDim * (type == NodeType::Line ? 0.08f : 0.25f);
+						break;
+					case NodeType::Wave:
+						step.kernel = Kernel::Wave; step.a = (H - 20.0f) * 0.5f * s.waveAmplitude; step.b = s.waveFrequency; step.c = frame.wavePhaseRad; step.n = 300;
+						size = W - 20.0f; extent = minDim * 0.2f;
+						break;
+					case NodeType::Transform: {
+						// scale and rotate about the centre, then move
+						const glm::vec2 c(W * 0.5f, H * 0.5f);
+						// turning a circle doesn't change it
+						if(node.subframe && frame.rotationSweepRad != 0.0f && !instanced && !copied && steps.size() > first && steps[first].kernel != Kernel::Circle){
+							Step sweep = step; sweep.kernel = Kernel::Sweep; sweep.a = frame.rotationSweepRad; sweep.b = c.x; sweep.c = c.y;
+							steps.push_back(sweep);
+						}
+						const float cs = cosf(frame.rotationRad) * frame.scale, sn = sinf(frame.rotationRad) * frame.scale;
+						glm::mat3 m(cs, sn, 0, -sn, cs, 0, 0, 0, 1);
+						glm::vec2 t = c + frame.position - glm::vec2(m * glm::vec3(c, 0));
+						m[2] = glm::vec3(t, 1);
+						addAffine(step, first, m, instanced);
+						scale *= fabsf(frame.scale);
+						break;
+					}
+					case NodeType::Movement: {
+						// when the movement stops the shape stays where it got to
+						const float mvSize = ofClamp(s.moveSize, 0.0f, 1.0f);
+						if(s.movement != AppState::Movement::None && mvSize > 0.0001f && s.moveSpeed != 0.0f){
+							const float ax = W * 0.5f * mvSize, ay = H * 0.5f * mvSize, phase = frame.movePhaseRad;
+							glm::vec2 offset(0, 0);
+							switch(s.movement){
+								case AppState::Movement::Circle: offset = {ax * cosf(phase), ay * sinf(phase)}; break;
+								case AppState::Movement::Pan: offset = {ax * sinf(phase), 0.0f}; break;
+								case AppState::Movement::Tilt: offset = {0.0f, ay * sinf(phase)}; break;
+								case AppState::Movement::Eight: offset = {ax * sinf(phase), ay * sinf(2.0f * phase)}; break;
+								case AppState::Movement::Random: {
+									const double t = frame.moveTimeCycles;
+									offset = {ax * (ofNoise((float)(t * 0.60), frame.randomSeedX) * 2.0f - 1.0f), ay * (ofNoise((float)(t * 0.70), frame.randomSeedY) * 2.0f - 1.0f)};
+									break;
+								}
+								default: break;
+							}
+							node.lastMoveOffset = offset;
+						}
+						if(node.lastMoveOffset != glm::vec2(0, 0)) addAffine(step, first, glm::mat3(1, 0, 0, 0, 1, 0, node.lastMoveOffset.x, node.lastMoveOffset.y, 1), instanced);
+						break;
+					}
+					case NodeType::Mirror:
+						if(frame.mirror) addAffine(step, first, glm::mat3(-1, 0, 0, 0, 1, 0, W, 0, 1), instanced);
+						break;
+					case NodeType::Color:
+						step.kernel = Kernel::Fill;
+						varyingColor = false;
+						break;
+					case NodeType::Rainbow: {
+						if(!isRainbowOn(s)) break;
+						const float amount = ofClamp(s.rainbowAmount, 0.0f, 1.0f);
+						step.kernel = Kernel::Rainbow; step.a = node.spacing;
+						// more amount -> fewer cycles across the canvas, at 1 it's all one colour
+						step.b = ofLerp(24.0f, 0.0f, amount);
+						// blend quantises the hue, 0 is a few hard bands and 1 is smooth
+						const float blend = ofClamp(s.rainbowBlend, 0.0f, 1.0f);
+						step.n = (blend < 0.999f) ? std::max(2, (int)roundf(ofLerp(6.0f, 256.0f, blend * blend))) : 0;
+						varyingColor = true;
+						break;
+					}
+					case NodeType::Prism: {
+						if(s.beamFx != AppState::BeamFx::Prisma) break;
+						// copies around a circle starting at the top, far enough apart to not overlap
+						const float sep = node.spread * extent * scale;
+						node.offsets.clear();
+						for(int i = 0; i < node.copies; i++){
+							const float angle = -HALF_PI + i * TWO_PI / node.copies;
+							node.offsets.emplace_back(cosf(angle) * sep, sinf(angle) * sep);
+						}
+						step.kernel = solidOutput ? Kernel::Instances : Kernel::Instance;
+						instanced = instanced || solidOutput;
+						break;
+					}
+					case NodeType::Output: {
+						// scan safety, don't draw shapes that are small enough to burn
+						if(size * scale < node.minSize){
+							steps.resize(first);
+							break;
+						}
+						// dot amount 0 and 1 are both solid
+						if(isDotted(s)){
+							step.kernel = Kernel::Dots; step.a = ofMap(ofClamp(s.dotAmount, 0.0f, 1.0f), 0.0f, 1.0f, 120.0f, 2.0f, true);
+						} else {
+							step.kernel = varyingColor ? Kernel::Multicoloured : Kernel::Solid;
+						}
+						break;
+					}
+					default: break;
+				}
+				if(step.kernel != Kernel::None) steps.push_back(step);
+			}
+		}
+	}
+
+	// draws the compiled steps
+	void run(ofxLaser::ManagerBase& laser){
+		for(const Step& step : steps) runStep(step, laser);
+	}
+
+	size_t getNumLayers() const { return layers.size(); }
+	size_t getNumSteps() const { return steps.size(); }
+
+private:
+	enum class NodeType { Shape, Circle, Line, Triangle, Square, Wave, Transform, Movement, Mirror, Color, Rainbow, Prism, Output };
+	struct Node {
+		NodeType type = NodeType::Shape;
+		int copies = 5; float spread = 1.73f;        // prism
+		float spacing = 6.0f;                        // rainbow and sub-frame sweep resample spacing
+		bool subframe = false;                       // transform
+		float minSize = 12.0f; std::string profile = OFXLASER_PROFILE_FAST; // output
+		glm::vec2 lastMoveOffset{0, 0};              // movement
+		std::vector<glm::vec2> offsets;              // prism, worked out by compile()
+	};
+
+	// the paths a layer is working on, colors is one per point once a colour node has run
+	struct Path { size_t start = 0, count = 0; bool closed = false; glm::vec2 centre{0, 0}; float radius = 0; bool swept = false; }; // radius > 0 for a circle, swept can't be drawn backwards
+	struct PathBuffer {
+		std::vector<glm::vec3> points; std::vector<ofColor> colors; std::vector<Path> paths;
+		std::vector<glm::mat3> instances; // when there are copies that share the points
+		void clear(){ points.clear(); colors.clear(); paths.clear(); instances.clear(); }
+		Path& beginPath(const Path& from){ Path p = from; p.start = points.size(); p.count = 0; paths.push_back(p); return paths.back(); }
+		void add(const glm::vec3& p){ points.push_back(p); paths.back().count++; }
+	};
+	struct Layer { std::vector<Node> nodes; PathBuffer buffer, scratch; };
+
+	enum class Kernel { None, Circle, Polygon, Wave, Sweep, Affine, Instance, Instances, InstanceAffine, Fill, Rainbow, Solid, Multicoloured, Dots };
+	struct Step {
+		Kernel kernel = Kernel::None; Layer* layer = nullptr; Node* node = nullptr;
+		glm::mat3 matrix{1.0f}; float a = 0, b = 0, c = 0; int n = 0;
+	};
+
+	static bool isGenerator(NodeType t){ return t <= NodeType::Wave; }
+	static bool setupError(const std::string& why){ ofLogError() << "EffectGraph: " << why; return false; }
+	static bool parseNode(const ofJson& j, Node& node){
+		static const std::vector<std::pair<std::string, NodeType>> types = {
+			{"shape", NodeType::Shape}, {"circle", NodeType::Circle}, {"line", NodeType::Line}, {"triangle", NodeType::Triangle}, {"square", NodeType::Square}, {"wave", NodeType::Wave},
+			{"transform", NodeType::Transform}, {"movement", NodeType::Movement}, {"mirror", NodeType::Mirror},
+			{"color", NodeType::Color}, {"rainbow", NodeType::Rainbow}, {"prism", NodeType::Prism}, {"output", NodeType::Output} };
+		if(!j.is_object()) return false;
+		const std::string type = ofToLower(j.value("type", std::string("")));
+		auto it = std::find_if(types.begin(), types.end(), [&](const std::pair<std::string, NodeType>& t){ return t.first == type; });
+		if(it == types.end()) return false;
+		node.type = it->second;
+		node.copies = std::max(1, j.value("copies", node.copies));
+		node.spread = j.value("spread", node.spread);
+		node.spacing = std::max(1.0f, j.value("spacing", node.spacing));
+		node.subframe = j.value("subframe", node.subframe);
+		node.minSize = j.value("minSize", node.minSize);
+		node.profile = j.value("profile", node.profile);
+		return true;
+	}
+
+	// dot amount 0 and 1 are both solid
+	static bool isDotted(const AppState& s){ const float dots = ofClamp(s.dotAmount, 0.0f, 1.0f); return dots > 0.001f && dots < 0.999f; }
+	bool isRainbowOn(const AppState& s) const { return !frame.whiteFlash && ofClamp(s.rainbowAmount, 0.0f, 1.0f) > 0.0f; }
+
+	// merges with the step before if that was a transform too
+	void addAffine(Step& step, size_t first, const glm::mat3& m, bool instanced){
+		const Kernel kernel = instanced ? Kernel::InstanceAffine : Kernel::Affine;
+		if(steps.size() > first && steps.back().kernel == kernel){
+			steps.back().matrix = m * steps.back().matrix;
+			return;
+		}
+		step.kernel = kernel; step.matrix = m;
+	}
+
+	// colours the points by their x position, the hues are worked out for the
+	// whole buffer in one go before they're turned into colours
+	void rainbowColors(PathBuffer& buffer, const Step& step){
+		const size_t n = buffer.points.size();
+		const float phase = frame.rainbowPhaseRad / TWO_PI, cycles = step.b, invWidth = 1.0f / frame.width;
+		const float numSteps = (float)step.n, invSteps = step.n > 0 ? 1.0f / step.n : 0.0f;
+		hues.resize(n);
+		for(size_t i = 0; i < n; i++){
+			float hue01 = phase + ofClamp(buffer.points[i].x * invWidth, 0.0f, 1.0f) * cycles;
+			hue01 -= floorf(hue01);
+			if(step.n > 0) hue01 = floorf(hue01 * numSteps) * invSteps;
+			hues[i] = hue01;
+		}
+		const float mb = frame.brightness;
+		buffer.colors.resize(n);
+		for(size_t i = 0; i < n; i++){
+			ofColor c; c.setHsb((unsigned char)ofClamp(hues[i] * 255.0f, 0.0f, 255.0f), 255, 255);
+			c.r = (unsigned char)(c.r * mb); c.g = (unsigned char)(c.g * mb); c.b = (unsigned char)(c.b * mb);
+			buffer.colors[i] = c;
+		}
+	}
+
+	// arc length walk along a path, calls fn(point) every spacing from the start
+	template<typename F> static void walkPath(const PathBuffer& buffer, const Path& path, float spacing, F fn){
+		if(path.count < 2) return;
+		const size_t numSegments = path.closed ? path.count : path.count - 1;
+		float walked = spacing; // so there's one at the start
+		for(size_t i = 0; i < numSegments; i++){
+			const glm::vec3& a = buffer.points[path.start + i];
+			const glm::vec3& b = buffer.points[path.start + (i + 1) % path.count];
+			const float len = glm::distance(a, b);
+			float t = spacing - walked;
+			for(; t < len; t += spacing) fn(len > 0 ? glm::mix(a, b, t / len) : a);
+			walked = len - (t - spacing);
+		}
+	}
+
+	void runStep(const Step& step, ofxLaser::ManagerBase& laser){
+		PathBuffer& buffer = step.layer->buffer;
+		PathBuffer& scratch = step.layer->scratch;
+		const float W = frame.width, H = frame.height;
+		switch(step.kernel){
+			case Kernel::Circle: {
+				buffer.clear();
+				Path circle; circle.closed = true; circle.centre = {step.a, step.b}; circle.radius = step.c;
+				buffer.beginPath(circle);
+				for(int i = 0; i < step.n; i++){
+					const float angle = TWO_PI * i / step.n;
+					buffer.add({step.a + step.c * cosf(angle), step.b + step.c * sinf(angle), 0});
+				}
+				break;
+			}
+			case Kernel::Polygon: {
+				buffer.clear();
+				const float p = 10.0f;
+				Path poly; poly.closed = (NodeType)step.n != NodeType::Line;
+				buffer.beginPath(poly);
+				if((NodeType)step.n == NodeType::Line){
+					buffer.add({p, H * 0.5f, 0}); buffer.add({W - p, H * 0.5f, 0});
+				} else if((NodeType)step.n == NodeType::Triangle){
+					buffer.add({W * 0.5f, p, 0}); buffer.add({W - p, H - p, 0}); buffer.add({p, H - p, 0});
+				} else {
+					buffer.add({p, p, 0}); buffer.add({W - p, p, 0}); buffer.add({W - p, H - p, 0}); buffer.add({p, H - p, 0});
+				}
+				break;
+			}
+			case Kernel::Wave: {
+				buffer.clear();
+				buffer.beginPath(Path());
+				const float p = 10.0f;
+				for(int i = 0; i <= step.n; i++){
+					const float t = (float)i / step.n;
+					buffer.add({p + t * (W - p * 2.0f), H * 0.5f + step.a * sinf(t * TWO_PI * step.b + step.c), 0});
+				}
+				break;
+			}
+			case Kernel::Sweep: {
+				// resampled like the rainbow so the edges between the corners
+				// turn too, otherwise they'd just be chords
+				scratch.clear();
+				for(const Path& path : buffer.paths){
+					Path& copy = scratch.beginPath(path);
+					copy.radius = 0; copy.swept = true;
+					walkPath(buffer, path, step.node->spacing, [&](const glm::vec3& p){ scratch.add(p); });
+					if(path.count > 0) scratch.add(buffer.points[path.start + (path.closed ? 0 : path.count - 1)]);
+					if(!buffer.colors.empty() && path.count > 0) scratch.colors.resize(scratch.points.size(), buffer.colors[path.start]);
+				}
+				for(Path& path : scratch.paths){
+					if(path.count < 2) continue;
+					// a closed path now ends back at its start
+					path.closed = false;
+					glm::vec3* points = &scratch.points[path.start];
+					float length = 0.0f;
+					for(size_t i = 1; i < path.count; i++) length += glm::distance(points[i - 1], points[i]);
+					if(length <= 0.0f) continue;
+					// turned about (b, c) by how far along the path the point is
+					float along = 0.0f; glm::vec3 previous = points[0];
+					for(size_t i = 0; i < path.count; i++){
+						const glm::vec3 p = points[i];
+						along += glm::distance(previous, p); previous = p;
+						const float angle = step.a * along / length, cs = cosf(angle), sn = sinf(angle);
+						const float x = p.x - step.b, y = p.y - step.c;
+						points[i].x = step.b + x * cs - y * sn; points[i].y = step.c + x * sn + y * cs;
+					}
+				}
+				std::swap(buffer, scratch);
+				break;
+			}
+			case Kernel::Affine: {
+				const glm::mat3& m = step.matrix;
+				for(glm::vec3& p : buffer.points){
+					const glm::vec3 q = m * glm::vec3(p.x, p.y, 1.0f);
+					p.x = q.x; p.y = q.y;
+				}
+				const float radiusScale = sqrtf(fabsf(glm::determinant(glm::mat2(m))));
+				for(Path& path : buffer.paths){
+					path.centre = glm::vec2(m * glm::vec3(path.centre, 1.0f));
+					path.radius *= radiusScale;
+				}
+				break;
+			}
+			case Kernel::Instance: {
+				scratch.clear();
+				for(const glm::vec2& offset : step.node->offsets){
+					for(const Path& path : buffer.paths){
+						Path& copy = scratch.beginPath(path);
+						copy.centre += offset;
+						for(size_t i = 0; i < path.count; i++) scratch.add(buffer.points[path.start + i] + glm::vec3(offset, 0));
+						if(!buffer.colors.empty()) scratch.colors.insert(scratch.colors.end(), buffer.colors.begin() + path.start, buffer.colors.begin() + path.start + path.count);
+					}
+				}
+				std::swap(buffer, scratch);
+				break;
+			}
+			case Kernel::Instances: {
+				if(buffer.instances.empty()) buffer.instances.emplace_back(1.0f);
+				scratch.instances.clear();
+				for(const glm::vec2& offset : step.node->offsets){
+					const glm::mat3 translation(1, 0, 0, 0, 1, 0, offset.x, offset.y, 1);
+					for(const glm::mat3& instance : buffer.instances) scratch.instances.push_back(translation * instance);
+				}
+				std::swap(buffer.instances, scratch.instances);
+				break;
+			}
+			case Kernel::InstanceAffine:
+				for(glm::mat3& instance : buffer.instances) instance = step.matrix * instance;
+				break;
+			case Kernel::Fill:
+				buffer.colors.assign(buffer.points.size(), frame.color);
+				break;
+			case Kernel::Rainbow: {
+				// resampled so the colour can change along straight edges
+				scratch.clear();
+				for(const Path& path : buffer.paths){
+					scratch.beginPath(path);
+					walkPath(buffer, path, step.a, [&](const glm::vec3& p){ scratch.add(p); });
+					if(!path.closed && path.count > 0) scratch.add(buffer.points[path.start + path.count - 1]);
+				}
+				rainbowColors(scratch, step);
+				std::swap(buffer, scratch);
+				break;
+			}
+			case Kernel::Solid:
+				shapeInstances.clear();
+				for(const glm::mat3& m : buffer.instances){
+					glm::mat4 transform(1.0f);
+					transform[0][0] = m[0][0]; transform[0][1] = m[0][1]; transform[1][0] = m[1][0]; transform[1][1] = m[1][1];
+					transform[3][0] = m[2][0]; transform[3][1] = m[2][1];
+					shapeInstances.emplace_back(transform);
+				}
+				for(const Path& path : buffer.paths){
+					if(path.count == 0) continue;
+					const ofColor& col = buffer.colors.empty() ? frame.color : buffer.colors[path.start];
+					const std::string& profile = step.node->profile;
+					if(!shapeInstances.empty()){
+						if(path.radius > 0){
+							laser.drawCircleInstances(glm::vec3(path.centre, 0), path.radius, col, shapeInstances, profile);
+						} else {
+							poly.clear();
+							poly.addVertices(&buffer.points[path.start], (int)path.count);
+							poly.setClosed(path.closed);
+							laser.drawPolyInstances(poly, col, shapeInstances, profile);
+						}
+					} else if(path.radius > 0){
+						laser.drawCircle(path.centre, path.radius, col, profile);
+					} else if(path.swept){
+						pathPoints.assign(buffer.points.begin() + path.start, buffer.points.begin() + path.start + path.count);
+						pathColors.assign(path.count, col);
+						laser.drawPolyFromPoints(pathPoints, pathColors, profile, 1, false);
+					} else if(path.count == 2 && !path.closed){
+						laser.drawLine(buffer.points[path.start], buffer.points[path.start + 1], col, profile);
+					} else {
+						poly.clear();
+						poly.addVertices(&buffer.points[path.start], (int)path.count);
+						poly.setClosed(path.closed);
+						laser.drawPoly(poly, col, profile);
+					}
+				}
+				break;
+			case Kernel::Multicoloured:
+				// each path goes out as one polyline with a colour per point
+				for(const Path& path : buffer.paths){
+					if(path.count < 2) continue;
+					pathPoints.assign(buffer.points.begin() + path.start, buffer.points.begin() + path.start + path.count);
+					if(buffer.colors.empty()) pathColors.assign(path.count, frame.color);
+					else pathColors.assign(buffer.colors.begin() + path.start, buffer.colors.begin() + path.start + path.count);
+					if(path.closed){
+						pathPoints.push_back(pathPoints.front());
+						pathColors.push_back(pathColors.front());
+					}
+					laser.drawPolyFromPoints(pathPoints, pathColors, step.node->profile, 1, !path.swept);
+				}
+				break;
+			case Kernel::Dots:
+				// each path goes out as one dotted shape
+				for(const Path& path : buffer.paths){
+					if(path.count < 2) continue;
+					pathPoints.assign(buffer.points.begin() + path.start, buffer.points.begin() + path.start + path.count);
+					laser.drawDottedPoly(pathPoints, path.closed, step.a, [&](const glm::vec3&, int vertexIndex){
+						return buffer.colors.empty() ? frame.color : buffer.colors[path.start + vertexIndex];
+					}, 0.0f, 1.0f, step.node->profile, !path.swept);
+				}
+				break;
+			default: break;
+		}
+	}
+
+	std::vector<Layer> layers;
+	std::vector<Step> steps;
+	EffectFrame frame;
+	ofPolyline poly; std::vector<ofxLaser::ShapeInstance> shapeInstances; // reused for solid output
+	std::vector<glm::vec3> pathPoints; std::vector<ofColor> pathColors; std::vector<float> hues; // reused for multicoloured and dotted output
+};
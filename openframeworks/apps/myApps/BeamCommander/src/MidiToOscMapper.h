@@ -4,6 +4,8 @@
 #include "ofMain.h"
 #include "ofxMidi.h"
 #include "ofxOsc.h"
+#include "ControlBus.h"
+#include "ofxLaserAsyncLog.h"
 #include <unordered_map>
 #include <functional>
 
@@ -141,11 +143,37 @@ public:
 			}
 		}
 
-		// OSC
-		sender.setup("127.0.0.1", oscPort);
+		// OSC: without a control bus the app gets the values over OSC as before,
+		// otherwise OSC is only sent if there's a mirror set in the config
+		if(controlBus == nullptr){
+			sender.setup("127.0.0.1", oscPort);
+			sendOsc = true;
+		} else if(!oscMirrorHost.empty() && oscMirrorPort > 0){
+			sender.setup(oscMirrorHost, oscMirrorPort);
+			sendOsc = true;
+			ofLogNotice() << "MidiToOscMapper: mirroring OSC to " << oscMirrorHost << ":" << oscMirrorPort;
+		}
 		return true;
 	}
 
+	// Values go straight to the app through the bus instead of over UDP.
+	// Call before setup.
+	void setControlBus(ControlBus* bus){
+		controlBus = bus;
+	}
+
+	// Sends a value to the app, and to the OSC mirror if there is one
+	void send(const std::string& address, float value){
+		if(controlBus != nullptr && !controlBus->push(address, value)){
+			ofxLaser::AsyncLog::log(OF_LOG_WARNING, ofxLaser::LOG_CATEGORY_MIDI, "MidiToOscMapper: control bus full, dropped %s", address.c_str());
+		}
+		if(sendOsc){
+			ofxOscMessage om; om.setAddress(address);
+			om.addFloatArg(value);
+			sender.sendMessage(om, false);
+		}
+	}
+
 	void exit(){
 	midi.removeListener(this);
 	midi.closePort();
@@ -164,9 +192,8 @@ public:
 			const int cc = (int)msg.control;
 			const int val = (int)msg.value; // 0..127
 			float v = ofClamp(val / 127.0f, 0.0f, 1.0f);
-			// Unconditional log for learn/mapping
-			ofLogNotice() << "MIDI CC [" << (msg.portName.empty()?midiPortName:msg.portName) << "] ch "
-						  << ch << " cc " << cc << " val " << val;
+			// Unconditional log for learn/mapping (async so a fader sweep doesn't stall the MIDI thread)
+			logMidi("MIDI CC [%s] ch %d cc %d val %d", (msg.portName.empty()?midiPortName:msg.portName).c_str(), ch, cc, val);
 			// Check explicit CC maps first
 			for(const auto& m : ccMaps){
 				if((m.channel == 0 || m.channel == ch) && m.cc == cc){
@@ -202,11 +229,8 @@ public:
 							}
 							// Map from [-1,1] to [outMin,outMax]
 							float out = ofMap(c, -1.0f, 1.0f, m.outMin, m.outMax, true);
-							ofxOscMessage om; om.setAddress(m.osc);
-							om.addFloatArg(out);
-							ofLogNotice() << "MIDI CC ch " << ch << " cc " << cc << " val " << val
-										  << " -> OSC " << m.osc << " " << out;
-							sender.sendMessage(om, false);
+							logMidi("MIDI CC ch %d cc %d val %d -> OSC %s %g", ch, cc, val, m.osc.c_str(), out);
+							send(m.osc, out);
 							continue; // done for centered branch
 						} else {
 							norm = v;
@@ -219,11 +243,8 @@ public:
 						norm = powf(ofClamp(norm, 0.0f, 1.0f), m.gamma);
 					}
 					float out = ofMap(norm, 0.0f, 1.0f, m.outMin, m.outMax, true);
-					ofxOscMessage om; om.setAddress(m.osc);
-					om.addFloatArg(out);
-					ofLogNotice() << "MIDI CC ch " << ch << " cc " << cc << " val " << val
-								  << " -> OSC " << m.osc << " " << out;
-					sender.sendMessage(om, false);
+					logMidi("MIDI CC ch %d cc %d val %d -> OSC %s %g", ch, cc, val, m.osc.c_str(), out);
+					send(m.osc, out);
 				}
 			}
 		}
@@ -234,8 +255,7 @@ public:
 			const bool isOn = (msg.status == MIDI_NOTE_ON) && (vel > 0);
 			const bool isOff = (msg.status == MIDI_NOTE_OFF) || ((msg.status == MIDI_NOTE_ON) && vel == 0);
 			// Unconditional log for learn/mapping
-			ofLogNotice() << "MIDI NOTE [" << (msg.portName.empty()?midiPortName:msg.portName) << "] ch "
-						  << ch << " note " << n << (isOn?" ON":" OFF") << " vel " << vel;
+			logMidi("MIDI NOTE [%s] ch %d note %d%s vel %d", (msg.portName.empty()?midiPortName:msg.portName).c_str(), ch, n, (isOn?" ON":" OFF"), vel);
 			// Notify raw note callback early (only on NOTE_ON w/vel>0) for learn feature
 			if(isOn && onRawNote){
 				onRawNote(ch, n);
@@ -251,10 +271,8 @@ public:
 					bool next = !cur;
 					toggleStates[key] = next;
 					float out = next ? m.onValue : m.offValue;
-					ofxOscMessage om; om.setAddress(m.osc);
-					om.addFloatArg(out);
-					ofLogNotice() << "MIDI Note TOGGLE ch " << ch << " note " << n << " -> OSC " << m.osc << " " << out;
-					sender.sendMessage(om, false);
+					logMidi("MIDI Note TOGGLE ch %d note %d -> OSC %s %g", ch, n, m.osc.c_str(), out);
+					send(m.osc, out);
 					if(m.ledFeedback){
 						midiOut.sendNoteOn(m.channel, m.note, next ? m.ledOn : m.ledOff);
 					}
@@ -270,10 +288,8 @@ public:
 					if(isOn){
 						// Send ON for this one first (prevents perceived flicker where LED momentarily goes dim)
 						float out = m.velocityAsValue ? ofClamp(vel / 127.0f, 0.0f, 1.0f) : m.onValue;
-						ofxOscMessage omOn; omOn.setAddress(m.osc);
-						omOn.addFloatArg(out);
-						ofLogNotice() << "MIDI Note ch " << ch << " note " << n << " ON -> OSC " << m.osc << " " << out;
-						sender.sendMessage(omOn, false);
+						logMidi("MIDI Note ch %d note %d ON -> OSC %s %g", ch, n, m.osc.c_str(), out);
+						send(m.osc, out);
 						if(m.ledFeedback){
 							// Update active mapping and light LED
 							activeExclusive[m.exclusiveGroup] = std::make_pair(m.channel, m.note);
@@ -287,12 +303,10 @@ public:
 							if(other.channel == m.channel && other.exclusiveGroup == m.exclusiveGroup){
 								bool suppressOscOff = (m.exclusiveGroup == "shapes" || m.exclusiveGroup == "colors" || m.exclusiveGroup == "movement"); // suppress OFF messages for radio groups
 								if(!suppressOscOff){
-									ofxOscMessage omOff; omOff.setAddress(other.osc);
-									omOff.addFloatArg(other.offValue);
-									ofLogNotice() << "MIDI Note ch " << ch << " note " << other.note << " FORCED OFF -> OSC " << other.osc << " " << other.offValue;
-									sender.sendMessage(omOff, false);
+									logMidi("MIDI Note ch %d note %d FORCED OFF -> OSC %s %g", ch, other.note, other.osc.c_str(), other.offValue);
+									send(other.osc, other.offValue);
 								} else {
-									ofLogNotice() << "MIDI Note ch " << ch << " note " << other.note << " FORCED OFF (LED only, shapes group suppresses OSC OFF)";
+									logMidi("MIDI Note ch %d note %d FORCED OFF (LED only, shapes group suppresses OSC OFF)", ch, other.note);
 								}
 								if(other.ledFeedback){
 									midiOut.sendNoteOn(other.channel, other.note, other.ledOff); // dim background
@@ -310,7 +324,7 @@ public:
 							}
 							refreshExclusiveGroupLEDs(m.exclusiveGroup);
 						}
-						ofLogNotice() << "MIDI Note ch " << ch << " note " << n << " OFF ignored (exclusive latch, LED reasserted)";
+						logMidi("MIDI Note ch %d note %d OFF ignored (exclusive latch, LED reasserted)", ch, n);
 					}
 				} else {
 					// Non-exclusive: normal momentary behavior
@@ -325,10 +339,8 @@ public:
 						continue;
 					}
 					float out = isOn ? (m.velocityAsValue ? ofClamp(vel / 127.0f, 0.0f, 1.0f) : m.onValue) : m.offValue;
-					ofxOscMessage om; om.setAddress(m.osc);
-					om.addFloatArg(out);
-					ofLogNotice() << "MIDI Note ch " << ch << " note " << n << (isOn?" ON":" OFF") << " -> OSC " << m.osc << " " << out;
-					sender.sendMessage(om, false);
+					logMidi("MIDI Note ch %d note %d%s -> OSC %s %g", ch, n, (isOn?" ON":" OFF"), m.osc.c_str(), out);
+					send(m.osc, out);
 					if(m.ledFeedback){
 						if(isOn){
 							midiOut.sendNoteOn(m.channel, m.note, m.ledOn);
@@ -341,6 +353,14 @@ public:
 		}
 	}
 
+	// Logging from the MIDI callback goes through the async log so it never waits for the console
+	static void logMidi(const char* format, ...){
+		va_list args;
+		va_start(args, format);
+		ofxLaser::AsyncLog::logv(OF_LOG_NOTICE, ofxLaser::LOG_CATEGORY_MIDI, format, args);
+		va_end(args);
+	}
+
 	// Ensure all notes in an exclusive group have correct LED states (selected bright, others dim)
 	void refreshExclusiveGroupLEDs(const std::string &group){
 		auto itSel = activeExclusive.find(group);
@@ -348,7 +368,7 @@ public:
 			if(nm.exclusiveGroup != group || !nm.ledFeedback) continue;
 			int vel = (itSel != activeExclusive.end() && itSel->second.first == nm.channel && itSel->second.second == nm.note) ? nm.ledOn : nm.ledOff;
 			midiOut.sendNoteOn(nm.channel, nm.note, vel);
-			ofLogNotice() << "LED refresh group='" << group << "' note=" << nm.note << " velocity=" << vel;
+			logMidi("LED refresh group='%s' note=%d velocity=%d", group.c_str(), nm.note, vel);
 		}
 	}
 
@@ -385,6 +405,10 @@ public:
 			ofJson j = ofLoadJson(path);
 			ccMaps.clear();
 			noteMaps.clear();
+			if(j.contains("oscMirror") && j["oscMirror"].is_object()){
+				oscMirrorHost = j["oscMirror"].value("host", std::string(""));
+				oscMirrorPort = j["oscMirror"].value("port", 0);
+			}
 		if(j.contains("cc") && j["cc"].is_array()){
 				for(const auto& e : j["cc"]) {
 					CCMap m;
@@ -463,6 +487,10 @@ public:
 			e["velocityAsValue"] = m.velocityAsValue; e["exclusiveGroup"] = m.exclusiveGroup; e["ledOn"] = m.ledOn; e["ledOff"] = m.ledOff;
 			e["ledFeedback"] = m.ledFeedback; e["toggle"] = m.toggle; noteArr.push_back(e);
 		}
+		if(!oscMirrorHost.empty()){
+			root["oscMirror"]["host"] = oscMirrorHost;
+			root["oscMirror"]["port"] = oscMirrorPort;
+		}
 		ofSavePrettyJson(configPath, root);
 		ofLogNotice() << "MidiToOscMapper: saved mappings to " << configPath;
 	}
@@ -507,6 +535,10 @@ private:
 	ofxMidiIn midi;
 	ofxMidiOut midiOut; // MIDI OUT for LED feedback (APC40 pads)
 	ofxOscSender sender;
+	bool sendOsc = false;
+	ControlBus* controlBus = nullptr;
+	std::string oscMirrorHost; // optional "oscMirror": {"host", "port"} in the config
+	int oscMirrorPort = 0;
 	std::vector<CCMap> ccMaps;
 	std::vector<NoteMap> noteMaps;
 	std::string midiPortName;
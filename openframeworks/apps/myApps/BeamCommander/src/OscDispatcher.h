@@ -0,0 +1,211 @@
+// Routes incoming OSC messages to handlers registered by address.
+//
+// Addresses are registered once at setup and stored in a trie, one node per
+// path segment, so a message only compares each of its segments against the
+// children of one node. Dispatching doesn't allocate anything.
+//
+// - A segment registered as {n} matches a segment made of digits and passes
+//   the number to the handler, eg "/cue/{n}" handles "/cue/12" with 12.
+//   Literal segments win, so "/cue/save" isn't treated as a cue number.
+// - Incoming addresses can use OSC pattern matching (* ? [a-z] [!a-z] {a,b})
+//   within a segment and every matching handler is called. Patterns don't
+//   match {n} segments as there's no list of numbers to match against.
+#pragma once
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+#include <functional>
+#include <cstring>
+
+class OscDispatcher {
+public:
+	// index is the number from the {n} segment, or -1 if there isn't one
+	typedef std::function<void(const ofxOscMessage& m, int index)> Handler;
+
+	// messages with fewer than minArgs arguments are ignored
+	void on(const std::string& address, int minArgs, Handler handler){
+		if(address.empty() || address[0] != '/'){
+			ofLogError("OscDispatcher") << "addresses should start with / : " << address;
+			return;
+		}
+		if(nodes.empty()) nodes.emplace_back();
+		int nodeIndex = 0;
+		size_t start = 1;
+		while(start <= address.size()){
+			size_t end = address.find('/', start);
+			if(end == std::string::npos) end = address.size();
+			std::string segment = address.substr(start, end - start);
+			nodeIndex = getOrAddChild(nodeIndex, segment);
+			start = end + 1;
+		}
+		Node& node = nodes[nodeIndex];
+		if(node.routeIndex >= 0){
+			ofLogWarning("OscDispatcher") << address << " registered twice, replacing the first handler";
+			routes[node.routeIndex] = Route{address, minArgs, handler};
+		} else {
+			node.routeIndex = (int)routes.size();
+			routes.push_back(Route{address, minArgs, handler});
+		}
+	}
+	// ignores the arguments, for buttons and MIDI notes
+	void onTrigger(const std::string& address, std::function<void()> handler){
+		on(address, 0, [handler](const ofxOscMessage&, int){ handler(); });
+	}
+	// the first argument as a float (ints are converted)
+	void onFloat(const std::string& address, std::function<void(float)> handler){
+		on(address, 1, [handler](const ofxOscMessage& m, int){ handler(m.getArgAsFloat(0)); });
+	}
+
+	// returns the number of handlers that were called
+	int dispatch(const ofxOscMessage& m){
+		const std::string& address = m.getAddress();
+		if(nodes.empty() || address.size() < 2 || address[0] != '/') return 0;
+		const char* start = address.c_str() + 1;
+		return dispatchFromNode(0, start, address.c_str() + address.size(), m, -1);
+	}
+
+	int getNumRoutes() const { return (int)routes.size(); }
+
+	// whether an OSC pattern matches a single segment (no slashes)
+	static bool matchSegment(const char* p, const char* pEnd, const char* s, const char* sEnd){
+		while(p < pEnd){
+			char c = *p;
+			if(c == '*'){
+				while(p < pEnd && *p == '*') p++;
+				if(p == pEnd) return true;
+				for(const char* t = s; t <= sEnd; t++){
+					if(matchSegment(p, pEnd, t, sEnd)) return true;
+				}
+				return false;
+			}
+			if(s == sEnd) return false;
+			if(c == '?'){
+				p++; s++;
+			} else if(c == '['){
+				const char* close = (const char*)memchr(p, ']', pEnd - p);
+				if(close == nullptr) return false;
+				const char* q = p + 1;
+				bool negate = (q < close && *q == '!');
+				if(negate) q++;
+				bool found = false;
+				while(q < close){
+					if(q + 2 < close && q[1] == '-'){
+						if(*s >= q[0] && *s <= q[2]) found = true;
+						q += 3;
+					} else {
+						if(*s == *q) found = true;
+						q++;
+					}
+				}
+				if(found == negate) return false;
+				p = close + 1; s++;
+			} else if(c == '{'){
+				const char* close = (const char*)memchr(p, '}', pEnd - p);
+				if(close == nullptr) return false;
+				const char* option = p + 1;
+				while(option <= close){
+					const char* optionEnd = option;
+					while(optionEnd < close && *optionEnd != ',') optionEnd++;
+					size_t length = optionEnd - option;
+					if(((size_t)(sEnd - s) >= length) && (memcmp(option, s, length) == 0) && matchSegment(close + 1, pEnd, s + length, sEnd)) return true;
+					option = optionEnd + 1;
+				}
+				return false;
+			} else {
+				if(c != *s) return false;
+				p++; s++;
+			}
+		}
+		return s == sEnd;
+	}
+
+protected:
+	struct Node {
+		std::vector<std::pair<std::string, int>> children;
+		int numberChild = -1;
+		int routeIndex = -1;
+	};
+	struct Route {
+		std::string address;
+		int minArgs;
+		Handler handler;
+	};
+
+	int getOrAddChild(int nodeIndex, const std::string& segment){
+		if(segment == "{n}"){
+			if(nodes[nodeIndex].numberChild < 0){
+				int child = (int)nodes.size();
+				nodes.emplace_back();
+				nodes[nodeIndex].numberChild = child;
+			}
+			return nodes[nodeIndex].numberChild;
+		}
+		for(auto& child : nodes[nodeIndex].children){
+			if(child.first == segment) return child.second;
+		}
+		int child = (int)nodes.size();
+		nodes.emplace_back();
+		nodes[nodeIndex].children.emplace_back(segment, child);
+		return child;
+	}
+
+	static bool hasWildcards(const char* s, const char* end){
+		for(; s < end; s++){
+			if(*s == '*' || *s == '?' || *s == '[' || *s == '{') return true;
+		}
+		return false;
+	}
+
+	// parses a segment made only of digits, or returns -1
+	static int parseNumber(const char* s, const char* end){
+		if(s == end || end - s > 9) return -1;
+		int number = 0;
+		for(; s < end; s++){
+			if(*s < '0' || *s > '9') return -1;
+			number = number * 10 + (*s - '0');
+		}
+		return number;
+	}
+
+	// segment is the start of the rest of the address
+	int dispatchFromNode(int nodeIndex, const char* segment, const char* addressEnd, const ofxOscMessage& m, int number){
+		const char* segmentEnd = (const char*)memchr(segment, '/', addressEnd - segment);
+		bool lastSegment = (segmentEnd == nullptr);
+		if(lastSegment) segmentEnd = addressEnd;
+		size_t length = segmentEnd - segment;
+
+		int handled = 0;
+		const Node& node = nodes[nodeIndex];
+		if(hasWildcards(segment, segmentEnd)){
+			for(const auto& child : node.children){
+				if(matchSegment(segment, segmentEnd, child.first.data(), child.first.data() + child.first.size())){
+					handled += arrive(child.second, lastSegment, segmentEnd, addressEnd, m, number);
+				}
+			}
+			return handled;
+		}
+		for(const auto& child : node.children){
+			if(child.first.size() == length && memcmp(child.first.data(), segment, length) == 0){
+				return arrive(child.second, lastSegment, segmentEnd, addressEnd, m, number);
+			}
+		}
+		if(node.numberChild >= 0){
+			int parsed = parseNumber(segment, segmentEnd);
+			if(parsed >= 0) return arrive(node.numberChild, lastSegment, segmentEnd, addressEnd, m, parsed);
+		}
+		return 0;
+	}
+
+	int arrive(int nodeIndex, bool lastSegment, const char* segmentEnd, const char* addressEnd, const ofxOscMessage& m, int number){
+		if(!lastSegment) return dispatchFromNode(nodeIndex, segmentEnd + 1, addressEnd, m, number);
+		int routeIndex = nodes[nodeIndex].routeIndex;
+		if(routeIndex < 0) return 0;
+		const Route& route = routes[routeIndex];
+		if((int)m.getNumArgs() < route.minArgs) return 0;
+		route.handler(m, number);
+		return 1;
+	}
+
+	std::vector<Node> nodes;
+	std::vector<Route> routes;
+};
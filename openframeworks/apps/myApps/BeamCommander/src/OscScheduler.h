@@ -0,0 +1,126 @@
+// Timed OSC bundles, so cue changes land on the frame they're meant for.
+//
+// ofxOscReceiver throws away bundle timetags. TimetaggedOscReceiver keeps the
+// tag of the bundle each message came in (nested bundles use their own tag)
+// and OscScheduler holds the timed messages until the frame whose
+// presentation time (see ShowClock.h) reaches the tag, minus a lookahead.
+// Messages that aren't in a bundle, or whose tag is "immediately", are
+// handled straight away as before.
+//
+// Timetags are NTP times from the sender's clock, so the sender and this
+// machine need their clocks synced (eg both on NTP or PTP) for sample
+// accurate changes. They're converted to steady_clock time when they arrive.
+#pragma once
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+#include "ShowClock.h"
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+class TimetaggedOscReceiver : public ofxOscReceiver {
+public:
+	// the OSC timetag that means "now"
+	static const uint64_t TIMETAG_IMMEDIATE = 1;
+
+	// use this rather than getNextMessage(), which would leave the tags behind
+	bool getNextTimedMessage(ofxOscMessage& m, uint64_t& timeTag){
+		if(!getNextMessage(m)) return false;
+		if(!timeTags.tryReceive(timeTag)) timeTag = TIMETAG_IMMEDIATE;
+		return true;
+	}
+
+	// converts an NTP timetag to ShowClock::nowNanos() time
+	static uint64_t timeTagToNanos(uint64_t timeTag){
+		const uint64_t ntpToUnixSeconds = 2208988800ull;
+		const int64_t tagNanos = (int64_t)((timeTag >> 32) - ntpToUnixSeconds) * 1000000000ll + (int64_t)(((timeTag & 0xffffffffull) * 1000000000ull) >> 32);
+		const int64_t systemNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		const int64_t nanos = (int64_t)ShowClock::nowNanos() + (tagNanos - systemNanos);
+		return (nanos > 0) ? (uint64_t)nanos : 0;
+	}
+
+protected:
+	// called on the receiver's thread
+	void ProcessBundle(const osc::ReceivedBundle& b, const osc::IpEndpointName& remoteEndpoint) override {
+		const uint64_t outerTimeTag = currentTimeTag;
+		currentTimeTag = b.TimeTag();
+		for(osc::ReceivedBundle::const_iterator i = b.ElementsBegin(); i != b.ElementsEnd(); ++i){
+			if(i->IsBundle()) ProcessBundle(osc::ReceivedBundle(*i), remoteEndpoint);
+			else ProcessMessage(osc::ReceivedMessage(*i), remoteEndpoint);
+		}
+		currentTimeTag = outerTimeTag;
+	}
+	void ProcessMessage(const osc::ReceivedMessage& m, const osc::IpEndpointName& remoteEndpoint) override {
+		// the tag goes first so it's always there when the message is
+		timeTags.send(currentTimeTag);
+		ofxOscReceiver::ProcessMessage(m, remoteEndpoint);
+	}
+
+	ofThreadChannel<uint64_t> timeTags;
+	uint64_t currentTimeTag = TIMETAG_IMMEDIATE;
+};
+
+class OscScheduler {
+public:
+	// messages are handled this long before their time, so a message is
+	// never more than this early
+	double lookaheadSeconds = 0.0;
+	// tags further ahead than this are taken to be a clock mismatch and
+	// handled straight away
+	double maxAheadSeconds = 10.0;
+
+	// returns false if the message should be handled now instead
+	bool add(const ofxOscMessage& m, uint64_t timeNanos){
+		const uint64_t now = ShowClock::nowNanos();
+		if(timeNanos > now + (uint64_t)(maxAheadSeconds * 1e9)){
+			numTooFar++;
+			return false;
+		}
+		queue.push(Entry{timeNanos, nextSequence++, m});
+		numScheduled++;
+		return true;
+	}
+
+	// pops the next message that's due for a frame presented at
+	// presentationNanos, in time order (and arrival order for equal times)
+	bool popDue(uint64_t presentationNanos, ofxOscMessage& m){
+		if(queue.empty()) return false;
+		const uint64_t due = presentationNanos + (uint64_t)(lookaheadSeconds * 1e9);
+		const Entry& next = queue.top();
+		if(next.timeNanos > due) return false;
+		// late if it should have been on an earlier frame
+		if(next.timeNanos + lateToleranceNanos < presentationNanos) numLate++;
+		m = next.message;
+		queue.pop();
+		return true;
+	}
+
+	size_t size() const { return queue.size(); }
+	void clear(){ queue = std::priority_queue<Entry, std::vector<Entry>, Later>(); }
+
+	// since the last resetStats()
+	int getNumScheduled() const { return numScheduled; }
+	int getNumLate() const { return numLate; }
+	int getNumTooFar() const { return numTooFar; }
+	void resetStats(){ numScheduled = numLate = numTooFar = 0; }
+
+	// how far behind a frame's presentation a message can be without counting as late
+	uint64_t lateToleranceNanos = 20000000;
+
+private:
+	struct Entry {
+		uint64_t timeNanos;
+		uint64_t sequence;
+		ofxOscMessage message;
+	};
+	struct Later {
+		bool operator()(const Entry& a, const Entry& b) const {
+			return (a.timeNanos != b.timeNanos) ? a.timeNanos > b.timeNanos : a.sequence > b.sequence;
+		}
+	};
+	std::priority_queue<Entry, std::vector<Entry>, Later> queue;
+	uint64_t nextSequence = 0;
+	int numScheduled = 0, numLate = 0, numTooFar = 0;
+};
@@ -0,0 +1,52 @@
+// Double buffered store for the show parameters.
+//
+// The show thread (the app thread, or the render thread if it's on) changes
+// the working copy through edit() (OSC and MIDI handlers, cues, smoothing)
+// and calls publish() once per frame. Readers
+// call read() to get one consistent copy of everything that was published,
+// so a frame never sees half of a cue. Publishing is a seqlock: readers
+// never block the writer, they just copy again if a publish happened while
+// they were copying.
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+template<typename T>
+class ParameterStore {
+	static_assert(std::is_trivially_copyable<T>::value, "ParameterStore values must be trivially copyable");
+public:
+	// show thread only
+	T& edit(){ return working; }
+	const T& getWorking() const { return working; }
+
+	// makes the working copy visible to read(), show thread only
+	void publish(){
+		uint64_t s = sequence.load(std::memory_order_relaxed);
+		sequence.store(s + 1, std::memory_order_relaxed); // odd while writing
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy((void*)&published, (const void*)&working, sizeof(T));
+		sequence.store(s + 2, std::memory_order_release);
+	}
+
+	// a consistent copy of the last published values, from any thread
+	T read() const {
+		T copy;
+		while(true){
+			uint64_t before = sequence.load(std::memory_order_acquire);
+			if(before & 1) continue;
+			memcpy((void*)&copy, (const void*)&published, sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(sequence.load(std::memory_order_relaxed) == before) return copy;
+		}
+	}
+
+	// goes up by one with each publish
+	uint64_t getVersion() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+	T working;
+	alignas(64) T published;
+	alignas(64) std::atomic<uint64_t> sequence{0};
+};
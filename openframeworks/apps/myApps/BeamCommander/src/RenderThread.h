@@ -0,0 +1,54 @@
+// Runs the show at a fixed frame rate on its own thread, so the laser frames
+// don't depend on the window's frame loop (the UI, vsync, joystick polling
+// and GL driver stalls). onFrame is called once per frame with the seconds
+// since the last one. If a frame takes too long the next one starts straight
+// away and the schedule starts again from there, frames are never bunched up
+// to catch up.
+//
+// The thread's scheduling comes from the "render" role in the ofxLaser
+// thread policy (see ofxLaserThreadPolicy.h).
+#pragma once
+
+#include "ofMain.h"
+#include "ofxLaserThreadPolicy.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+class RenderThread : public ofThread {
+public:
+	std::function<void(float)> onFrame;
+
+	void start(){ numLateFrames.store(0); startThread(); }
+	void stop(){ waitForThread(true); }
+
+	// can be changed while it's running, from any thread
+	void setFrameRate(float fps){ frameRate.store(ofClamp(fps, 1.0f, 1000.0f)); }
+	float getFrameRate() const { return frameRate.load(); }
+	// frames that started late since start()
+	int getNumLateFrames() const { return numLateFrames.load(); }
+
+protected:
+	void threadedFunction() override {
+		ofxLaser::ThreadPolicy::apply(ofxLaser::THREAD_ROLE_RENDER, "BeamCommander render");
+		using Clock = std::chrono::steady_clock;
+		Clock::time_point last = Clock::now(), next = last;
+		while(isThreadRunning()){
+			Clock::time_point now = Clock::now();
+			float dt = std::chrono::duration<float>(now - last).count();
+			last = now;
+			if(onFrame) onFrame(dt);
+
+			next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRate.load()));
+			now = Clock::now();
+			if(next < now){
+				numLateFrames++;
+				next = now;
+			}
+			std::this_thread::sleep_until(next);
+		}
+	}
+
+	std::atomic<float> frameRate{60.0f};
+	std::atomic<int> numLateFrames{0};
+};
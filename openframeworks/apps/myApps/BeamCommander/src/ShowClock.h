@@ -0,0 +1,55 @@
+// Monotonic clock for the show's animation.
+//
+// Each frame is timed by when it will start to be drawn by the lasers (its
+// presentation time) rather than when it's calculated, so uneven frame
+// times in the app don't turn into uneven motion. The presentation time is
+// now plus how much the DACs have queued (ManagerBase::
+// getPresentationDelayMicros). That estimate wobbles from frame to frame so
+// it's smoothed, and presentation times never go backwards.
+//
+// Times are nanoseconds from std::chrono::steady_clock. Only the thread
+// that runs the show should use it.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+class ShowClock {
+public:
+	static uint64_t nowNanos(){
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// starts the next frame, returns the seconds since the last frame's presentation time
+	double beginFrame(int64_t presentationDelayMicros){
+		const uint64_t now = nowNanos();
+		const double delayNanos = (presentationDelayMicros > 0) ? presentationDelayMicros * 1000.0 : 0.0;
+		if(numFrames == 0) smoothedDelayNanos = delayNanos;
+		else smoothedDelayNanos += (delayNanos - smoothedDelayNanos) * delaySmoothing;
+
+		uint64_t presentation = now + (uint64_t)smoothedDelayNanos;
+		if(numFrames > 0 && presentation < presentationNanos) presentation = presentationNanos;
+		frameSeconds = (numFrames > 0) ? (presentation - presentationNanos) * 1e-9 : 0.0;
+		presentationNanos = presentation;
+		numFrames++;
+		return frameSeconds;
+	}
+
+	// when the current frame starts being drawn
+	uint64_t getPresentationNanos() const { return presentationNanos; }
+	// the time between this frame's presentation and the last one's
+	double getFrameSeconds() const { return frameSeconds; }
+	// seconds from a time to this frame's presentation
+	double getSecondsSince(uint64_t nanos) const { return ((int64_t)presentationNanos - (int64_t)nanos) * 1e-9; }
+	uint64_t getNumFrames() const { return numFrames; }
+	double getPresentationDelaySeconds() const { return smoothedDelayNanos * 1e-9; }
+
+	// how much of each new delay estimate to take, per frame
+	double delaySmoothing = 0.05;
+
+private:
+	uint64_t presentationNanos = 0;
+	double frameSeconds = 0.0;
+	double smoothedDelayNanos = 0.0;
+	uint64_t numFrames = 0;
+};
@@ -1,7 +1,18 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "ofAppNoWindow.h"
 
-int main(){
+// --headless runs the show without a window or the laser UI, for machines
+// without a display. The laser settings come from bin/data/ofxLaser as usual.
+int main(int argc, char* argv[]){
+    bool headless = false;
+    for(int i = 1; i < argc; i++){
+        if(std::string(argv[i]) == "--headless") headless = true;
+    }
+    if(headless){
+        ofSetupOpenGL(std::make_shared<ofAppNoWindow>(), 1400, 980, OF_WINDOW);
+        return ofRunApp(new ofApp(true));
+    }
     ofSetupOpenGL(1400,980,OF_WINDOW);
     ofSetWindowTitle("BeamCommander");
     ofRunApp(new ofApp());
@@ -3,8 +3,15 @@
 #include "ofxLaserManager.h"
 #include "ofxOsc.h"
 #include "AppState.h"
+#include "ParameterStore.h"
 #include <array>
 #include "MidiToOscMapper.h"
+#include "OscDispatcher.h"
+#include "OscScheduler.h"
+#include "ControlBus.h"
+#include "EffectGraph.h"
+#include "RenderThread.h"
+#include "ShowClock.h"
 
 #ifdef __has_include
 #if __has_include("ofxJoystick.h")
@@ -19,18 +26,32 @@
 
 class ofApp : public ofBaseApp{
 public:
+    explicit ofApp(bool headless = false);
     void setup();
     void update();
     void draw();
     void exit();
     void keyPressed(ofKeyEventArgs& e);
     void updateOsc();
+    void updateShow(float dt); void drawShow(float dt); void setPpsOverride(int pps);
 
-    ofxLaser::Manager laser;
-    std::shared_ptr<AppState> state = std::make_shared<AppState>();
+    // headless runs without a window: only the laser pipeline is created (no UI, previews or
+    // visualiser), laserUI is null and the show always runs on the render thread
+    const bool headless;
+    std::unique_ptr<ofxLaser::ManagerBase> laserManager; ofxLaser::Manager* laserUI = nullptr; ofxLaser::ManagerBase& laser;
+    // handlers and updateShow() change the working copy through state, drawShow() uses frameState
+    ParameterStore<AppState> params; AppState* state = &params.edit(); AppState frameState;
 
     // OSC
-    ofxOscReceiver osc; int oscPort = 9000; void updateOscLegacy();
+    TimetaggedOscReceiver osc; int oscPort = 9000; void updateOscLegacy();
+    // timetagged bundles wait here for the frame presented at their time
+    OscScheduler oscScheduler; ofParameter<float> oscLookaheadMs; float oscScheduleLogTime = 0;
+    // replies to /status with a /status message, for monitoring headless machines.
+    // statusReplyPort 0 replies to the port the request came from.
+    ofxOscSender statusSender; std::string statusHost; int statusPort = 0; int statusReplyPort = 0; void sendStatus(const std::string& host, int port); float statusLogTime = 0;
+    OscDispatcher oscDispatcher; ofxOscMessage oscMessage; void setupOscHandlers();
+    ControlBus controlBus; ofxOscMessage controlMessage; void updateControlBus();
+    uint64_t controlLatencyTotal = 0, controlLatencyMax = 0; int controlLatencyCount = 0; float controlLatencyLogTime = 0;
 
     std::unique_ptr<MidiToOscMapper> midiMapper;
 
@@ -39,15 +60,22 @@ public:
     std::atomic<bool> learnMomentaryArmed{false};
     std::atomic<int> learnMomentaryCueIndex{0};
 
-    bool flashActive=false; float flashPrevBrightness=0.0f; std::atomic<int> flashReleaseMs{150}; bool flashDecaying=false; uint64_t flashDecayStartMs=0; float flashDecayFrom=1.0f;
+    bool flashActive=false; float flashPrevBrightness=0.0f; std::atomic<int> flashReleaseMs{150}; bool flashDecaying=false; uint64_t flashDecayStartNanos=0; float flashDecayFrom=1.0f;
 
-    struct CueState { AppState::Shape shape; AppState::ColorSel colorSel; AppState::Movement movement; AppState::BeamFx beamFx; bool useCustom; float r,g,b; float rainbowSpeed,rainbowAmount,rainbowBlend; float waveFrequency,waveAmplitude,waveSpeed; float moveSpeed,moveSize; float rotationSpeed; float shapeScale; float posX,posY; float dotAmount; float scanRateHz; bool populated=false; };
+    struct CueState { AppState state; bool populated=false; }; // only the cue fields of state are used
     std::array<CueState,30> cues; bool saveArmed=false; void snapshotToCue(int idx); bool applyCue(int idx);
 
     const std::string cuesFileName = "cues.json"; void saveCuesToDisk(); void loadCuesFromDisk();
-    static std::string shapeToString(AppState::Shape s); static AppState::Shape shapeFromString(const std::string&); static std::string colorToString(AppState::ColorSel c); static AppState::ColorSel colorFromString(const std::string&);
+    void applyCueState(const AppState& cue);
 
-    float rotationAngleRad=0.0f; float wavePhaseRad=0.0f; float movePhaseRad=0.0f; double moveTimeCycles=0.0; ofVec2f lastMoveOffset{0,0}; float randomSeedX=0.0f, randomSeedY=0.0f; float rainbowPhaseRad=0.0f; bool hasScaleInput=false;
+    // the phases are for each frame's presentation time on the show clock, rotationStepRad is how far the rotation moves in a frame
+    ShowClock showClock; float rotationStepRad=0.0f;
+    float rotationAngleRad=0.0f; float wavePhaseRad=0.0f; float movePhaseRad=0.0f; double moveTimeCycles=0.0; float randomSeedX=0.0f, randomSeedY=0.0f; float rainbowPhaseRad=0.0f; bool hasScaleInput=false;
+
+    EffectGraph effectGraph; const std::string effectGraphFileName = "effect_graph.json";
+
+    // updateShow() and drawShow() run here instead of in update() and draw() when renderOnThread is set
+    RenderThread renderThread; ofParameter<bool> renderOnThread; ofParameter<int> renderFrameRate;
 
     int ppsCurrent=0; int ppsTarget=0; int ppsSlewPerFrame=1200; int ppsSlewPerSecond=10000;
 